@@ -0,0 +1,47 @@
+#ifndef FCPUT_ALGODS_ALIGNED_ALLOCATOR
+#define FCPUT_ALGODS_ALIGNED_ALLOCATOR
+
+#include "algo_ds/common/common.hpp"
+
+#include <cstddef>
+#include <new>
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+
+/// @brief Allocator returning memory aligned to `Alignment` bytes (by default the width of the widest SIMD register)
+/// @details Meant for `std::vector` buffers that are read and written by the SIMD kernels with aligned loads/stores
+template <typename T, std::size_t Alignment = 64>
+struct aligned_allocator
+{
+	static_assert(Alignment >= alignof(T) and (Alignment & (Alignment - 1)) == 0, "class aligned_allocator: the alignment must be a power of two not smaller than the one of T.\n");
+
+	using value_type = T;
+
+	template <typename U>
+	struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+	aligned_allocator(void) noexcept = default;
+	template <typename U>
+	aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+	T* allocate(const std::size_t& n)
+	{
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ Alignment }));
+	}
+
+	void deallocate(T* p, const std::size_t&) noexcept
+	{
+		::operator delete(p, std::align_val_t{ Alignment });
+	}
+
+	template <typename U>
+	bool operator==(const aligned_allocator<U, Alignment>&) const noexcept { return true; }
+	template <typename U>
+	bool operator!=(const aligned_allocator<U, Alignment>&) const noexcept { return false; }
+};
+
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_ALIGNED_ALLOCATOR
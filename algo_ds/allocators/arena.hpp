@@ -0,0 +1,110 @@
+#ifndef FCPUT_ALGODS_ARENA
+#define FCPUT_ALGODS_ARENA
+
+#include "algo_ds/common/common.hpp"
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+
+/// @brief Bump-pointer allocator over a list of large blocks
+/// @details An allocation only advances an offset in the current block; nothing is freed individually. `mark()` and
+/// `rewind()` release at once everything allocated after a point, and `reset()` everything: the blocks are kept and
+/// reused by the following allocations, so a workload repeated after a rewind allocates no memory at all.
+/// Only trivially destructible objects may be placed in it, since no destructor is ever called
+class arena
+{
+	public:
+		/// @brief Position in the arena, to rewind to
+		struct marker
+		{
+			std::size_t block, offset;
+		};
+
+		/// @brief Generate an empty arena allocating blocks of `block_size` bytes (or larger, for larger requests)
+		explicit arena(const std::size_t& block_size = 1 << 16): m_block_size{block_size}, m_current{0}, m_offset{0} {}
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+		arena(arena&& other) noexcept: m_blocks{std::move(other.m_blocks)}, m_block_size{other.m_block_size}, m_current{other.m_current}, m_offset{other.m_offset}
+		{
+			other.m_blocks.clear();
+			other.reset();
+		}
+
+		~arena(void)
+		{
+			for (const auto& _b : m_blocks)
+				::operator delete(_b.data, std::align_val_t{ _alignment });
+		}
+
+		/// @brief Uninitialized memory of `bytes` bytes aligned to `alignment` (a power of two, at most 64)
+		/// @details Throws `std::invalid_argument` for any other alignment
+		void* allocate(const std::size_t& bytes, const std::size_t& alignment = alignof(std::max_align_t))
+		{
+			if (0 == alignment or (alignment & (alignment - 1)) or alignment > _alignment)
+				throw std::invalid_argument("method arena::allocate(): the alignment must be a power of two, at most 64.\n");
+			for (; m_current < m_blocks.size(); m_current++, m_offset = 0)
+			{
+				const std::size_t _start{ (m_offset + alignment - 1) & ~(alignment - 1) };
+				if (_start + bytes <= m_blocks[m_current].size)
+				{
+					m_offset = _start + bytes;
+					return m_blocks[m_current].data + _start;
+				}
+			}
+			const std::size_t _size{ bytes > m_block_size ? bytes : m_block_size };
+			m_blocks.push_back({ static_cast<std::byte*>(::operator new(_size, std::align_val_t{ _alignment })), _size });
+			m_current = m_blocks.size() - 1;
+			m_offset = bytes;
+			return m_blocks.back().data;
+		}
+
+		/// @brief Uninitialized storage for `n` objects of type `T`
+		template <typename T>
+		T* allocate(const std::size_t& n)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "method arena::allocate(): objects in an arena are never destroyed.\n");
+			static_assert(alignof(T) <= _alignment, "method arena::allocate(): over-aligned type.\n");
+			return static_cast<T*>(this->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		marker mark(void) const { return { m_current, m_offset }; }
+
+		/// @brief Release everything allocated since `m` was taken
+		void rewind(const marker& m) { m_current = m.block; m_offset = m.offset; }
+
+		/// @brief Release everything, keeping the blocks for the following allocations
+		void reset(void) { m_current = 0; m_offset = 0; }
+
+		/// @brief Total size of the blocks, in bytes
+		std::size_t capacity(void) const
+		{
+			std::size_t _res{0};
+			for (const auto& _b : m_blocks)
+				_res += _b.size;
+			return _res;
+		}
+
+	private:
+		constexpr static std::size_t _alignment{ 64 };
+
+		struct _block
+		{
+			std::byte* data;
+			std::size_t size;
+		};
+
+		std::vector<_block> m_blocks;
+		std::size_t m_block_size, m_current, m_offset;
+};
+
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_ARENA
@@ -1,29 +1,152 @@
 #ifndef FCPUT_ALGODS_SIMD_AVX
 #define FCPUT_ALGODS_SIMD_AVX
 
-#include <emmintrin.h>
-
 #include "algo_ds/common/common.hpp"
 #include "common_simd.hpp"
+#include "sse.hpp"
+
+#if FCPUT_SIMD_AVX
+
+#include <immintrin.h>
 
 FCP_NAMESPACE_BEGIN
 FCP_NAMESPACE_ALGODS_BEGIN
 FCP_NAMESPACE_SIMD_BEGIN
 
-// Zeroing operations
+/// @brief Compute dot product of eight vectors passed to the function via four vectors of the components along a single axis each
+inline __m256 dot(
+		const __m256& ax, const __m256& ay, const __m256& az, const __m256& aw,
+	 	const __m256& bx, const __m256& by, const __m256& bz, const __m256& bw
+		)
+{
+	__m256 _dx = _mm256_mul_ps(ax, bx);
+	__m256 _dy = _mm256_mul_ps(ay, by);
+	__m256 _dz = _mm256_mul_ps(az, bz);
+	__m256 _dw = _mm256_mul_ps(aw, bw);
+
+	__m256 _s1 = _mm256_add_ps(_dx, _dy);
+	__m256 _s2 = _mm256_add_ps(_dz, _dw);
+
+	return _mm256_add_ps(_s1, _s2);
+}
+
+/// @brief Compute dot product of eight three-dimensional vectors passed to the function via three vectors of the components along a single axis each
+inline __m256 dot(
+		const __m256& ax, const __m256& ay, const __m256& az,
+	 	const __m256& bx, const __m256& by, const __m256& bz
+		)
+{
+	__m256 _dx = _mm256_mul_ps(ax, bx);
+	__m256 _dy = _mm256_mul_ps(ay, by);
+	__m256 _dz = _mm256_mul_ps(az, bz);
+
+	return _mm256_add_ps(_mm256_add_ps(_dx, _dy), _dz);
+}
 
-// Loading operations
+template <>
+struct pack<float, avx>
+{
+	using type = __m256;
+	using scalar_type = float;
+	constexpr static std::size_t width = 8;
+	constexpr static std::size_t alignment = 32;
 
-// Arithmetic
+	// Initialization
+	static inline type zero(void) { return _mm256_setzero_ps(); }
+	static inline type set1(const float& s) { return _mm256_set1_ps(s); }
 
-// Bit operations
+	// Loading/storing operations
+	static inline type load(const float* p) { return _mm256_load_ps(p); }
+	static inline type loadu(const float* p) { return _mm256_loadu_ps(p); }
+	static inline void store(float* p, const type& v) { _mm256_store_ps(p, v); }
+	static inline void storeu(float* p, const type& v) { _mm256_storeu_ps(p, v); }
 
-// Shuffling
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return _mm256_add_ps(a, b); }
+	static inline type sub(const type& a, const type& b) { return _mm256_sub_ps(a, b); }
+	static inline type mul(const type& a, const type& b) { return _mm256_mul_ps(a, b); }
+	static inline type div(const type& a, const type& b) { return _mm256_div_ps(a, b); }
+	static inline type fmadd(const type& a, const type& b, const type& c)
+	{
+#if FCPUT_SIMD_FMA
+		return _mm256_fmadd_ps(a, b, c);
+#else
+		return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+	}
+	static inline type sqrt(const type& a) { return _mm256_sqrt_ps(a); }
+	static inline type min(const type& a, const type& b) { return _mm256_min_ps(a, b); }
+	static inline type max(const type& a, const type& b) { return _mm256_max_ps(a, b); }
 
-// Etc
+	// Horizontal operations (fold the upper lane onto the lower one, then finish in SSE)
+	static inline float reduce_add(const type& v)
+	{
+		return pack<float, sse>::reduce_add(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+	}
+	static inline float reduce_min(const type& v)
+	{
+		return pack<float, sse>::reduce_min(_mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+	}
+	static inline float reduce_max(const type& v)
+	{
+		return pack<float, sse>::reduce_max(_mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+	}
+};
+
+template <>
+struct pack<double, avx>
+{
+	using type = __m256d;
+	using scalar_type = double;
+	constexpr static std::size_t width = 4;
+	constexpr static std::size_t alignment = 32;
+
+	// Initialization
+	static inline type zero(void) { return _mm256_setzero_pd(); }
+	static inline type set1(const double& s) { return _mm256_set1_pd(s); }
+
+	// Loading/storing operations
+	static inline type load(const double* p) { return _mm256_load_pd(p); }
+	static inline type loadu(const double* p) { return _mm256_loadu_pd(p); }
+	static inline void store(double* p, const type& v) { _mm256_store_pd(p, v); }
+	static inline void storeu(double* p, const type& v) { _mm256_storeu_pd(p, v); }
+
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return _mm256_add_pd(a, b); }
+	static inline type sub(const type& a, const type& b) { return _mm256_sub_pd(a, b); }
+	static inline type mul(const type& a, const type& b) { return _mm256_mul_pd(a, b); }
+	static inline type div(const type& a, const type& b) { return _mm256_div_pd(a, b); }
+	static inline type fmadd(const type& a, const type& b, const type& c)
+	{
+#if FCPUT_SIMD_FMA
+		return _mm256_fmadd_pd(a, b, c);
+#else
+		return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+	}
+	static inline type sqrt(const type& a) { return _mm256_sqrt_pd(a); }
+	static inline type min(const type& a, const type& b) { return _mm256_min_pd(a, b); }
+	static inline type max(const type& a, const type& b) { return _mm256_max_pd(a, b); }
+
+	// Horizontal operations (fold the upper lane onto the lower one, then finish in SSE)
+	static inline double reduce_add(const type& v)
+	{
+		return pack<double, sse>::reduce_add(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+	}
+	static inline double reduce_min(const type& v)
+	{
+		return pack<double, sse>::reduce_min(_mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+	}
+	static inline double reduce_max(const type& v)
+	{
+		return pack<double, sse>::reduce_max(_mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+	}
+};
 
 FCP_NAMESPACE_SIMD_END
 FCP_NAMESPACE_ALGODS_END
 FCP_NAMESPACE_END
 
+#endif	// FCPUT_SIMD_AVX
+
 #endif	// FCPUT_ALGODS_SIMD_AVX
@@ -0,0 +1,130 @@
+#ifndef FCPUT_ALGODS_SIMD_AVX512
+#define FCPUT_ALGODS_SIMD_AVX512
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "avx.hpp"
+
+#if FCPUT_SIMD_AVX512F
+
+#include <immintrin.h>
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+/// @brief Compute dot product of sixteen vectors passed to the function via four vectors of the components along a single axis each
+inline __m512 dot(
+		const __m512& ax, const __m512& ay, const __m512& az, const __m512& aw,
+	 	const __m512& bx, const __m512& by, const __m512& bz, const __m512& bw
+		)
+{
+	__m512 _s1 = _mm512_fmadd_ps(ay, by, _mm512_mul_ps(ax, bx));
+	__m512 _s2 = _mm512_fmadd_ps(aw, bw, _mm512_mul_ps(az, bz));
+
+	return _mm512_add_ps(_s1, _s2);
+}
+
+/// @brief Compute dot product of sixteen three-dimensional vectors passed to the function via three vectors of the components along a single axis each
+inline __m512 dot(
+		const __m512& ax, const __m512& ay, const __m512& az,
+	 	const __m512& bx, const __m512& by, const __m512& bz
+		)
+{
+	return _mm512_fmadd_ps(az, bz, _mm512_fmadd_ps(ay, by, _mm512_mul_ps(ax, bx)));
+}
+
+// AVX-512F always comes with FMA
+template <>
+struct pack<float, avx512>
+{
+	using type = __m512;
+	using scalar_type = float;
+	constexpr static std::size_t width = 16;
+	constexpr static std::size_t alignment = 64;
+
+	// Initialization
+	static inline type zero(void) { return _mm512_setzero_ps(); }
+	static inline type set1(const float& s) { return _mm512_set1_ps(s); }
+
+	// Loading/storing operations
+	static inline type load(const float* p) { return _mm512_load_ps(p); }
+	static inline type loadu(const float* p) { return _mm512_loadu_ps(p); }
+	static inline void store(float* p, const type& v) { _mm512_store_ps(p, v); }
+	static inline void storeu(float* p, const type& v) { _mm512_storeu_ps(p, v); }
+
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return _mm512_add_ps(a, b); }
+	static inline type sub(const type& a, const type& b) { return _mm512_sub_ps(a, b); }
+	static inline type mul(const type& a, const type& b) { return _mm512_mul_ps(a, b); }
+	static inline type div(const type& a, const type& b) { return _mm512_div_ps(a, b); }
+	static inline type fmadd(const type& a, const type& b, const type& c) { return _mm512_fmadd_ps(a, b, c); }
+	static inline type sqrt(const type& a) { return _mm512_sqrt_ps(a); }
+	static inline type min(const type& a, const type& b) { return _mm512_min_ps(a, b); }
+	static inline type max(const type& a, const type& b) { return _mm512_max_ps(a, b); }
+
+	// Horizontal operations (fold the upper half onto the lower one, then finish in AVX)
+	static inline float reduce_add(const type& v)
+	{
+		return pack<float, avx>::reduce_add(_mm256_add_ps(_mm512_castps512_ps256(v), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1))));
+	}
+	static inline float reduce_min(const type& v)
+	{
+		return pack<float, avx>::reduce_min(_mm256_min_ps(_mm512_castps512_ps256(v), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1))));
+	}
+	static inline float reduce_max(const type& v)
+	{
+		return pack<float, avx>::reduce_max(_mm256_max_ps(_mm512_castps512_ps256(v), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1))));
+	}
+};
+
+template <>
+struct pack<double, avx512>
+{
+	using type = __m512d;
+	using scalar_type = double;
+	constexpr static std::size_t width = 8;
+	constexpr static std::size_t alignment = 64;
+
+	// Initialization
+	static inline type zero(void) { return _mm512_setzero_pd(); }
+	static inline type set1(const double& s) { return _mm512_set1_pd(s); }
+
+	// Loading/storing operations
+	static inline type load(const double* p) { return _mm512_load_pd(p); }
+	static inline type loadu(const double* p) { return _mm512_loadu_pd(p); }
+	static inline void store(double* p, const type& v) { _mm512_store_pd(p, v); }
+	static inline void storeu(double* p, const type& v) { _mm512_storeu_pd(p, v); }
+
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return _mm512_add_pd(a, b); }
+	static inline type sub(const type& a, const type& b) { return _mm512_sub_pd(a, b); }
+	static inline type mul(const type& a, const type& b) { return _mm512_mul_pd(a, b); }
+	static inline type div(const type& a, const type& b) { return _mm512_div_pd(a, b); }
+	static inline type fmadd(const type& a, const type& b, const type& c) { return _mm512_fmadd_pd(a, b, c); }
+	static inline type sqrt(const type& a) { return _mm512_sqrt_pd(a); }
+	static inline type min(const type& a, const type& b) { return _mm512_min_pd(a, b); }
+	static inline type max(const type& a, const type& b) { return _mm512_max_pd(a, b); }
+
+	// Horizontal operations (fold the upper half onto the lower one, then finish in AVX)
+	static inline double reduce_add(const type& v)
+	{
+		return pack<double, avx>::reduce_add(_mm256_add_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+	}
+	static inline double reduce_min(const type& v)
+	{
+		return pack<double, avx>::reduce_min(_mm256_min_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+	}
+	static inline double reduce_max(const type& v)
+	{
+		return pack<double, avx>::reduce_max(_mm256_max_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+	}
+};
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_SIMD_AVX512F
+
+#endif	// FCPUT_ALGODS_SIMD_AVX512
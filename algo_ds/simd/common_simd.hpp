@@ -4,9 +4,166 @@
 #include "algo_ds/common/common.hpp"
 #include "architecture/arch.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include <thread>
+
 #define FCP_NAMESPACE_SIMD_BEGIN namespace simd {
 #define FCP_NAMESPACE_SIMD_END }
 
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+// ISA tags
+struct scalar{};
+struct sse{};
+struct avx{};
+struct avx512{};
+
+/// @brief Widest instruction set enabled by the compiler flags
+#if FCPUT_SIMD_AVX512F
+using native = avx512;
+#elif FCPUT_SIMD_AVX
+using native = avx;
+#elif FCPUT_SIMD_SSE2
+using native = sse;
+#else
+using native = scalar;
+#endif
+
+/// @brief Common templated interface over the registers of an ISA extension
+/// @details Every ISA header specializes `pack` for the scalar types it supports (see COMMON_INTERFACE).
+/// Kernels are written once against this interface and instantiated for each tag, the `scalar` one
+/// being both the reference implementation and the remainder loop of the vectorized ones
+template <typename T, typename ISA>
+struct pack;
+
+template <typename T>
+struct pack<T, scalar>
+{
+	using type = T;
+	using scalar_type = T;
+	constexpr static std::size_t width = 1;
+	constexpr static std::size_t alignment = alignof(T);
+
+	// Initialization
+	static inline type zero(void) { return T{0}; }
+	static inline type set1(const T& s) { return s; }
+
+	// Loading/storing operations
+	static inline type load(const T* p) { return *p; }
+	static inline type loadu(const T* p) { return *p; }
+	static inline void store(T* p, const type& v) { *p = v; }
+	static inline void storeu(T* p, const type& v) { *p = v; }
+
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return a + b; }
+	static inline type sub(const type& a, const type& b) { return a - b; }
+	static inline type mul(const type& a, const type& b) { return a * b; }
+	static inline type div(const type& a, const type& b) { return a / b; }
+	static inline type fmadd(const type& a, const type& b, const type& c) { return a * b + c; }
+	static inline type sqrt(const type& a) { return std::sqrt(a); }
+	// Same semantics as the SSE/AVX instructions: the second operand is returned when either one is NaN
+	static inline type min(const type& a, const type& b) { return a < b ? a : b; }
+	static inline type max(const type& a, const type& b) { return a > b ? a : b; }
+
+	// Horizontal operations
+	static inline T reduce_add(const type& v) { return v; }
+	static inline T reduce_min(const type& v) { return v; }
+	static inline T reduce_max(const type& v) { return v; }
+};
+
+/// @brief Compile-time check for the availability of an ISA extension
+template <typename ISA> constexpr bool is_supported_v = false;
+template <> constexpr bool is_supported_v<scalar> = true;
+template <> constexpr bool is_supported_v<sse> = FCPUT_SIMD_SSE2;
+template <> constexpr bool is_supported_v<avx> = FCPUT_SIMD_AVX;
+template <> constexpr bool is_supported_v<avx512> = FCPUT_SIMD_AVX512F;
+
+/// @brief Runtime check that the host CPU can execute the code compiled for an ISA tag
+/// @details The check covers every extension the tag was compiled with (eg. AVX2 and FMA for the `avx` tag when they
+/// are enabled), so that a binary built with `-march=<something>` can skip the paths its host doesn't support.
+/// Without GCC-compatible builtins the compile-time availability is returned
+template <typename ISA>
+inline bool is_host_supported(void)
+{
+	if constexpr (not is_supported_v<ISA>)
+		return false;
+#if FCPUT_ARCH_GCC
+	else if constexpr (std::is_same<ISA, sse>::value)
+		return __builtin_cpu_supports("sse2") and (not FCPUT_SIMD_SSE41 or __builtin_cpu_supports("sse4.1"));
+	else if constexpr (std::is_same<ISA, avx>::value)
+		return __builtin_cpu_supports("avx")
+			and (not FCPUT_SIMD_AVX2 or __builtin_cpu_supports("avx2"))
+			and (not FCPUT_SIMD_FMA or __builtin_cpu_supports("fma"));
+	else if constexpr (std::is_same<ISA, avx512>::value)
+		return __builtin_cpu_supports("avx512f")
+			and (not FCPUT_SIMD_AVX512BW or __builtin_cpu_supports("avx512bw"))
+			and (not FCPUT_SIMD_AVX512VL or __builtin_cpu_supports("avx512vl"))
+			and (not FCPUT_SIMD_AVX512DQ or __builtin_cpu_supports("avx512dq"));
+#endif
+	else
+		return true;
+}
+
+namespace internal
+{
+	// Check that a pointer satisfies the alignment required by the aligned loads of a pack
+	template <typename P, typename T>
+	inline bool _is_aligned(const T* p) noexcept
+	{
+		return reinterpret_cast<std::uintptr_t>(p) % P::alignment == 0;
+	}
+
+	template <typename P, typename T, typename... Ts>
+	inline bool _is_aligned(const T* p, const Ts*... ps) noexcept
+	{
+		return _is_aligned<P>(p) and _is_aligned<P>(ps...);
+	}
+
+	// Select aligned or unaligned memory operations at compile time
+	template <typename P, bool Aligned>
+	inline typename P::type _load(const typename P::scalar_type* p)
+	{
+		if constexpr (Aligned) return P::load(p); else return P::loadu(p);
+	}
+
+	template <typename P, bool Aligned>
+	inline void _store(typename P::scalar_type* p, const typename P::type& v)
+	{
+		if constexpr (Aligned) P::store(p, v); else P::storeu(p, v);
+	}
+
+	// Run `work(t)` for every `t` in [0, threads), `t == 0` on the calling thread. If a thread can't be started, or the
+	// share of the calling thread throws, the threads already started are joined before the exception propagates
+	template <typename Work>
+	inline void _run_threads(const std::size_t& threads, const Work& work)
+	{
+		std::vector<std::thread> _pool;
+		try
+		{
+			_pool.reserve(threads > 0 ? threads - 1 : 0);
+			for (std::size_t t{1}; t < threads; t++)
+				_pool.emplace_back(work, t);
+			if (threads > 0) work(0);
+		}
+		catch (...)
+		{
+			for (auto& _t : _pool)
+				_t.join();
+			throw;
+		}
+		for (auto& _t : _pool)
+			_t.join();
+	}
+}	// namespace internal
 
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
 
 #endif	// FCPUT_ALGODS_SIMD_COMMON
@@ -0,0 +1,261 @@
+#ifndef FCPUT_ALGODS_SIMD_GATHER
+#define FCPUT_ALGODS_SIMD_GATHER
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Indexed loads (gather) and stores (scatter) of `float`/`double` through `std::int32_t` indices.
+ *
+ * AVX2 provides hardware gathers (`vgatherdps`/`vgatherdpd`) but no scatters, AVX-512F provides both;
+ * the SSE and plain AVX tags, and the AVX2 scatters, are emulated lane by lane. Masks are arrays of
+ * `bool`: inactive lanes of a gather leave the output untouched, inactive lanes of a scatter don't
+ * write. When a scatter writes more than once to the same location the highest lane wins, as with
+ * the hardware instruction.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+namespace internal
+{
+	// Register-level gather/scatter of `width` consecutive indices (and mask flags)
+	template <typename T, typename ISA>
+	struct _gather_ops
+	{
+		// Emulated version, used for the scalar and SSE tags
+		using P = pack<T, ISA>;
+		using type = typename P::type;
+		constexpr static std::size_t width = P::width;
+
+		static inline type gather(const T* base, const std::int32_t* idx)
+		{
+			alignas(64) T _v[width];
+			for (std::size_t k{0}; k < width; k++)
+				_v[k] = base[idx[k]];
+			return P::loadu(_v);
+		}
+		static inline type mask_gather(const type& src, const T* base, const std::int32_t* idx, const bool* mask)
+		{
+			alignas(64) T _v[width];
+			P::storeu(_v, src);
+			for (std::size_t k{0}; k < width; k++)
+				if (mask[k]) _v[k] = base[idx[k]];
+			return P::loadu(_v);
+		}
+		static inline void scatter(T* base, const std::int32_t* idx, const type& v)
+		{
+			alignas(64) T _v[width];
+			P::storeu(_v, v);
+			for (std::size_t k{0}; k < width; k++)
+				base[idx[k]] = _v[k];
+		}
+		static inline void mask_scatter(T* base, const std::int32_t* idx, const type& v, const bool* mask)
+		{
+			alignas(64) T _v[width];
+			P::storeu(_v, v);
+			for (std::size_t k{0}; k < width; k++)
+				if (mask[k]) base[idx[k]] = _v[k];
+		}
+	};
+
+#if FCPUT_SIMD_AVX2
+	// Hardware gathers, emulated scatters
+	template <>
+	struct _gather_ops<float, avx>
+	{
+		using type = __m256;
+		constexpr static std::size_t width = 8;
+
+		static inline __m256i _index(const std::int32_t* idx) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)); }
+		static inline __m256 _mask(const bool* mask)
+		{
+			const __m256i _m = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask)));
+			return _mm256_castsi256_ps(_mm256_cmpgt_epi32(_m, _mm256_setzero_si256()));
+		}
+
+		static inline type gather(const float* base, const std::int32_t* idx) { return _mm256_i32gather_ps(base, _index(idx), 4); }
+		static inline type mask_gather(const type& src, const float* base, const std::int32_t* idx, const bool* mask)
+		{
+			return _mm256_mask_i32gather_ps(src, base, _index(idx), _mask(mask), 4);
+		}
+		static inline void scatter(float* base, const std::int32_t* idx, const type& v)
+		{
+			_gather_ops<float, sse>::scatter(base, idx, _mm256_castps256_ps128(v));
+			_gather_ops<float, sse>::scatter(base, idx + 4, _mm256_extractf128_ps(v, 1));
+		}
+		static inline void mask_scatter(float* base, const std::int32_t* idx, const type& v, const bool* mask)
+		{
+			_gather_ops<float, sse>::mask_scatter(base, idx, _mm256_castps256_ps128(v), mask);
+			_gather_ops<float, sse>::mask_scatter(base, idx + 4, _mm256_extractf128_ps(v, 1), mask + 4);
+		}
+	};
+
+	template <>
+	struct _gather_ops<double, avx>
+	{
+		using type = __m256d;
+		constexpr static std::size_t width = 4;
+
+		static inline __m128i _index(const std::int32_t* idx) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx)); }
+		static inline __m256d _mask(const bool* mask)
+		{
+			std::int32_t _bytes;
+			std::memcpy(&_bytes, mask, sizeof(_bytes));
+			const __m256i _m = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(_bytes));
+			return _mm256_castsi256_pd(_mm256_cmpgt_epi64(_m, _mm256_setzero_si256()));
+		}
+
+		static inline type gather(const double* base, const std::int32_t* idx) { return _mm256_i32gather_pd(base, _index(idx), 8); }
+		static inline type mask_gather(const type& src, const double* base, const std::int32_t* idx, const bool* mask)
+		{
+			return _mm256_mask_i32gather_pd(src, base, _index(idx), _mask(mask), 8);
+		}
+		static inline void scatter(double* base, const std::int32_t* idx, const type& v)
+		{
+			_gather_ops<double, sse>::scatter(base, idx, _mm256_castpd256_pd128(v));
+			_gather_ops<double, sse>::scatter(base, idx + 2, _mm256_extractf128_pd(v, 1));
+		}
+		static inline void mask_scatter(double* base, const std::int32_t* idx, const type& v, const bool* mask)
+		{
+			_gather_ops<double, sse>::mask_scatter(base, idx, _mm256_castpd256_pd128(v), mask);
+			_gather_ops<double, sse>::mask_scatter(base, idx + 2, _mm256_extractf128_pd(v, 1), mask + 2);
+		}
+	};
+#endif	// FCPUT_SIMD_AVX2
+
+#if FCPUT_SIMD_AVX512F
+	template <>
+	struct _gather_ops<float, avx512>
+	{
+		using type = __m512;
+		constexpr static std::size_t width = 16;
+
+		static inline __m512i _index(const std::int32_t* idx) { return _mm512_loadu_si512(idx); }
+		static inline __mmask16 _mask(const bool* mask)
+		{
+			const __m512i _m = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+			return _mm512_test_epi32_mask(_m, _m);
+		}
+
+		static inline type gather(const float* base, const std::int32_t* idx) { return _mm512_i32gather_ps(_index(idx), base, 4); }
+		static inline type mask_gather(const type& src, const float* base, const std::int32_t* idx, const bool* mask)
+		{
+			return _mm512_mask_i32gather_ps(src, _mask(mask), _index(idx), base, 4);
+		}
+		static inline void scatter(float* base, const std::int32_t* idx, const type& v) { _mm512_i32scatter_ps(base, _index(idx), v, 4); }
+		static inline void mask_scatter(float* base, const std::int32_t* idx, const type& v, const bool* mask)
+		{
+			_mm512_mask_i32scatter_ps(base, _mask(mask), _index(idx), v, 4);
+		}
+	};
+
+	template <>
+	struct _gather_ops<double, avx512>
+	{
+		using type = __m512d;
+		constexpr static std::size_t width = 8;
+
+		static inline __m256i _index(const std::int32_t* idx) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)); }
+		static inline __mmask8 _mask(const bool* mask)
+		{
+			const __m512i _m = _mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask)));
+			return _mm512_test_epi64_mask(_m, _m);
+		}
+
+		static inline type gather(const double* base, const std::int32_t* idx) { return _mm512_i32gather_pd(_index(idx), base, 8); }
+		static inline type mask_gather(const type& src, const double* base, const std::int32_t* idx, const bool* mask)
+		{
+			return _mm512_mask_i32gather_pd(src, _mask(mask), _index(idx), base, 8);
+		}
+		static inline void scatter(double* base, const std::int32_t* idx, const type& v) { _mm512_i32scatter_pd(base, _index(idx), v, 8); }
+		static inline void mask_scatter(double* base, const std::int32_t* idx, const type& v, const bool* mask)
+		{
+			_mm512_mask_i32scatter_pd(base, _mask(mask), _index(idx), v, 8);
+		}
+	};
+#endif	// FCPUT_SIMD_AVX512F
+}	// namespace internal
+
+/// @brief Register-level gather/scatter for the ISA tag `ISA`
+/// @details Each function reads `gather_ops<T, ISA>::width` consecutive indices (and mask flags) starting from the pointers passed
+template <typename T, typename ISA>
+using gather_ops = internal::_gather_ops<T, ISA>;
+
+/// @brief Indexed load: `out[i] = base[indices[i]]` for i in [0, n)
+template <typename ISA, typename T>
+inline void gather(ISA, const T* base, const std::int32_t* indices, T* out, const std::size_t& n)
+{
+	using _G = gather_ops<T, ISA>;
+	using _P = pack<T, ISA>;
+	std::size_t i{0};
+	for (; i + _G::width <= n; i += _G::width)
+		_P::storeu(out + i, _G::gather(base, indices + i));
+	for (; i < n; i++)
+		out[i] = base[indices[i]];
+}
+
+/// @brief Masked indexed load: `out[i] = base[indices[i]]` for the i in [0, n) such that `mask[i]` is true
+/// @details The indices of the inactive lanes are never dereferenced, so they can point out of bounds
+template <typename ISA, typename T>
+inline void gather(ISA, const T* base, const std::int32_t* indices, const bool* mask, T* out, const std::size_t& n)
+{
+	using _G = gather_ops<T, ISA>;
+	using _P = pack<T, ISA>;
+	std::size_t i{0};
+	for (; i + _G::width <= n; i += _G::width)
+		_P::storeu(out + i, _G::mask_gather(_P::loadu(out + i), base, indices + i, mask + i));
+	for (; i < n; i++)
+		if (mask[i]) out[i] = base[indices[i]];
+}
+
+/// @brief Indexed store: `base[indices[i]] = in[i]` for i in [0, n)
+template <typename ISA, typename T>
+inline void scatter(ISA, const T* in, const std::int32_t* indices, T* base, const std::size_t& n)
+{
+	using _G = gather_ops<T, ISA>;
+	using _P = pack<T, ISA>;
+	std::size_t i{0};
+	for (; i + _G::width <= n; i += _G::width)
+		_G::scatter(base, indices + i, _P::loadu(in + i));
+	for (; i < n; i++)
+		base[indices[i]] = in[i];
+}
+
+/// @brief Masked indexed store: `base[indices[i]] = in[i]` for the i in [0, n) such that `mask[i]` is true
+/// @details The indices of the inactive lanes are never dereferenced, so they can point out of bounds
+template <typename ISA, typename T>
+inline void scatter(ISA, const T* in, const std::int32_t* indices, const bool* mask, T* base, const std::size_t& n)
+{
+	using _G = gather_ops<T, ISA>;
+	using _P = pack<T, ISA>;
+	std::size_t i{0};
+	for (; i + _G::width <= n; i += _G::width)
+		_G::mask_scatter(base, indices + i, _P::loadu(in + i), mask + i);
+	for (; i < n; i++)
+		if (mask[i]) base[indices[i]] = in[i];
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename T>
+inline void gather(const T* base, const std::int32_t* indices, T* out, const std::size_t& n) { gather(native{}, base, indices, out, n); }
+template <typename T>
+inline void gather(const T* base, const std::int32_t* indices, const bool* mask, T* out, const std::size_t& n) { gather(native{}, base, indices, mask, out, n); }
+template <typename T>
+inline void scatter(const T* in, const std::int32_t* indices, T* base, const std::size_t& n) { scatter(native{}, in, indices, base, n); }
+template <typename T>
+inline void scatter(const T* in, const std::int32_t* indices, const bool* mask, T* base, const std::size_t& n) { scatter(native{}, in, indices, mask, base, n); }
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_GATHER
@@ -0,0 +1,316 @@
+#ifndef FCPUT_ALGODS_SIMD_GEOMETRY
+#define FCPUT_ALGODS_SIMD_GEOMETRY
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+/* Array-level geometry kernels over Struct of Arrays data.
+ *
+ * Every kernel takes an ISA tag as first argument (see common_simd.hpp); the overloads without
+ * it use `simd::native`. The vectorized loop uses aligned loads/stores when all the arrays are
+ * aligned to the register width, unaligned ones otherwise, and the remaining elements are
+ * processed by the scalar instantiation of the same kernel. Output arrays may alias input ones.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+/// @brief View over three-dimensional vectors stored as one array per component
+/// @details A view of mutable components converts to the read-only view taken by the kernel inputs
+template <typename T>
+struct soa_vec3
+{
+	T* x;
+	T* y;
+	T* z;
+
+	template <typename U = T, typename = std::enable_if_t<not std::is_const_v<U>>>
+	operator soa_vec3<const U>(void) const { return { x, y, z }; }
+};
+
+/// @brief View over four-dimensional vectors stored as one array per component
+/// @details A view of mutable components converts to the read-only view taken by the kernel inputs
+template <typename T>
+struct soa_vec4
+{
+	T* x;
+	T* y;
+	T* z;
+	T* w;
+
+	template <typename U = T, typename = std::enable_if_t<not std::is_const_v<U>>>
+	operator soa_vec4<const U>(void) const { return { x, y, z, w }; }
+};
+
+namespace internal
+{
+	// Read-only views of inputs: the element type is deduced from the outputs only, so that views of mutable
+	// components are accepted through their conversion
+	template <typename T>
+	struct _non_deduced { using type = T; };
+
+	template <typename T>
+	using _in_vec3 = soa_vec3<const typename _non_deduced<T>::type>;
+
+	template <typename T>
+	using _in_vec4 = soa_vec4<const typename _non_deduced<T>::type>;
+
+	// Aligned fast path selection, vectorized loop and scalar remainder, the same for every kernel: `block(P{}, aligned, i)`
+	// processes the elements from `i` with the pack `P` and returns the first unprocessed index
+	template <typename T, typename ISA, typename Block, typename... Arrays>
+	inline void _soa_dispatch(const Block& block, const Arrays*... arrays)
+	{
+		using P = pack<T, ISA>;
+		const std::size_t _i{ _is_aligned<P>(arrays...) ? block(P{}, std::true_type{}, 0) : block(P{}, std::false_type{}, 0) };
+		block(pack<T, scalar>{}, std::false_type{}, _i);
+	}
+
+	// Each block function processes elements [i, n) `P::width` at a time and returns the first unprocessed index
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _dot_block(const soa_vec3<const T>& a, const soa_vec3<const T>& b, T* out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			auto _r = P::mul(_load<P, Aligned>(a.x + i), _load<P, Aligned>(b.x + i));
+			_r = P::fmadd(_load<P, Aligned>(a.y + i), _load<P, Aligned>(b.y + i), _r);
+			_r = P::fmadd(_load<P, Aligned>(a.z + i), _load<P, Aligned>(b.z + i), _r);
+			_store<P, Aligned>(out + i, _r);
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _dot_block(const soa_vec4<const T>& a, const soa_vec4<const T>& b, T* out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			auto _r = P::mul(_load<P, Aligned>(a.x + i), _load<P, Aligned>(b.x + i));
+			_r = P::fmadd(_load<P, Aligned>(a.y + i), _load<P, Aligned>(b.y + i), _r);
+			_r = P::fmadd(_load<P, Aligned>(a.z + i), _load<P, Aligned>(b.z + i), _r);
+			_r = P::fmadd(_load<P, Aligned>(a.w + i), _load<P, Aligned>(b.w + i), _r);
+			_store<P, Aligned>(out + i, _r);
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _cross_block(const soa_vec3<const T>& a, const soa_vec3<const T>& b, const soa_vec3<T>& out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _ax = _load<P, Aligned>(a.x + i), _ay = _load<P, Aligned>(a.y + i), _az = _load<P, Aligned>(a.z + i);
+			const auto _bx = _load<P, Aligned>(b.x + i), _by = _load<P, Aligned>(b.y + i), _bz = _load<P, Aligned>(b.z + i);
+			_store<P, Aligned>(out.x + i, P::sub(P::mul(_ay, _bz), P::mul(_az, _by)));
+			_store<P, Aligned>(out.y + i, P::sub(P::mul(_az, _bx), P::mul(_ax, _bz)));
+			_store<P, Aligned>(out.z + i, P::sub(P::mul(_ax, _by), P::mul(_ay, _bx)));
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _length_block(const soa_vec3<const T>& a, T* out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _x = _load<P, Aligned>(a.x + i), _y = _load<P, Aligned>(a.y + i), _z = _load<P, Aligned>(a.z + i);
+			_store<P, Aligned>(out + i, P::sqrt(P::fmadd(_z, _z, P::fmadd(_y, _y, P::mul(_x, _x)))));
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _length_block(const soa_vec4<const T>& a, T* out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _x = _load<P, Aligned>(a.x + i), _y = _load<P, Aligned>(a.y + i);
+			const auto _z = _load<P, Aligned>(a.z + i), _w = _load<P, Aligned>(a.w + i);
+			_store<P, Aligned>(out + i, P::sqrt(P::fmadd(_w, _w, P::fmadd(_z, _z, P::fmadd(_y, _y, P::mul(_x, _x))))));
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _normalize_block(const soa_vec3<const T>& a, const soa_vec3<T>& out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _x = _load<P, Aligned>(a.x + i), _y = _load<P, Aligned>(a.y + i), _z = _load<P, Aligned>(a.z + i);
+			const auto _l = P::sqrt(P::fmadd(_z, _z, P::fmadd(_y, _y, P::mul(_x, _x))));
+			_store<P, Aligned>(out.x + i, P::div(_x, _l));
+			_store<P, Aligned>(out.y + i, P::div(_y, _l));
+			_store<P, Aligned>(out.z + i, P::div(_z, _l));
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _normalize_block(const soa_vec4<const T>& a, const soa_vec4<T>& out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _x = _load<P, Aligned>(a.x + i), _y = _load<P, Aligned>(a.y + i);
+			const auto _z = _load<P, Aligned>(a.z + i), _w = _load<P, Aligned>(a.w + i);
+			const auto _l = P::sqrt(P::fmadd(_w, _w, P::fmadd(_z, _z, P::fmadd(_y, _y, P::mul(_x, _x)))));
+			_store<P, Aligned>(out.x + i, P::div(_x, _l));
+			_store<P, Aligned>(out.y + i, P::div(_y, _l));
+			_store<P, Aligned>(out.z + i, P::div(_z, _l));
+			_store<P, Aligned>(out.w + i, P::div(_w, _l));
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _distance_block(const soa_vec3<const T>& a, const soa_vec3<const T>& b, T* out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _dx = P::sub(_load<P, Aligned>(a.x + i), _load<P, Aligned>(b.x + i));
+			const auto _dy = P::sub(_load<P, Aligned>(a.y + i), _load<P, Aligned>(b.y + i));
+			const auto _dz = P::sub(_load<P, Aligned>(a.z + i), _load<P, Aligned>(b.z + i));
+			_store<P, Aligned>(out + i, P::sqrt(P::fmadd(_dz, _dz, P::fmadd(_dy, _dy, P::mul(_dx, _dx)))));
+		}
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _distance_block(const soa_vec4<const T>& a, const soa_vec4<const T>& b, T* out, std::size_t i, const std::size_t& n)
+	{
+		for (; i + P::width <= n; i += P::width)
+		{
+			const auto _dx = P::sub(_load<P, Aligned>(a.x + i), _load<P, Aligned>(b.x + i));
+			const auto _dy = P::sub(_load<P, Aligned>(a.y + i), _load<P, Aligned>(b.y + i));
+			const auto _dz = P::sub(_load<P, Aligned>(a.z + i), _load<P, Aligned>(b.z + i));
+			const auto _dw = P::sub(_load<P, Aligned>(a.w + i), _load<P, Aligned>(b.w + i));
+			_store<P, Aligned>(out + i, P::sqrt(P::fmadd(_dw, _dw, P::fmadd(_dz, _dz, P::fmadd(_dy, _dy, P::mul(_dx, _dx))))));
+		}
+		return i;
+	}
+}	// namespace internal
+
+/// @brief Compute the dot products `out[i] = a[i] . b[i]` of `n` three-dimensional vectors
+template <typename ISA, typename T>
+inline void dot(ISA, const internal::_in_vec3<T>& a, const internal::_in_vec3<T>& b, T* out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_dot_block<decltype(p), decltype(aligned)::value>(a, b, out, i, n);
+	}, a.x, a.y, a.z, b.x, b.y, b.z, out);
+}
+
+/// @brief Compute the dot products `out[i] = a[i] . b[i]` of `n` four-dimensional vectors
+template <typename ISA, typename T>
+inline void dot(ISA, const internal::_in_vec4<T>& a, const internal::_in_vec4<T>& b, T* out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_dot_block<decltype(p), decltype(aligned)::value>(a, b, out, i, n);
+	}, a.x, a.y, a.z, a.w, b.x, b.y, b.z, b.w, out);
+}
+
+/// @brief Compute the cross products `out[i] = a[i] x b[i]` of `n` three-dimensional vectors
+template <typename ISA, typename T>
+inline void cross(ISA, const internal::_in_vec3<T>& a, const internal::_in_vec3<T>& b, const soa_vec3<T>& out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_cross_block<decltype(p), decltype(aligned)::value>(a, b, out, i, n);
+	}, a.x, a.y, a.z, b.x, b.y, b.z, out.x, out.y, out.z);
+}
+
+/// @brief Compute the euclidean lengths of `n` three-dimensional vectors
+template <typename ISA, typename T>
+inline void length(ISA, const internal::_in_vec3<T>& a, T* out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_length_block<decltype(p), decltype(aligned)::value>(a, out, i, n);
+	}, a.x, a.y, a.z, out);
+}
+
+/// @brief Compute the euclidean lengths of `n` four-dimensional vectors
+template <typename ISA, typename T>
+inline void length(ISA, const internal::_in_vec4<T>& a, T* out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_length_block<decltype(p), decltype(aligned)::value>(a, out, i, n);
+	}, a.x, a.y, a.z, a.w, out);
+}
+
+/// @brief Normalize `n` three-dimensional vectors
+/// @details Zero-length vectors yield NaN components, exactly as the scalar formula would
+template <typename ISA, typename T>
+inline void normalize(ISA, const internal::_in_vec3<T>& a, const soa_vec3<T>& out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_normalize_block<decltype(p), decltype(aligned)::value>(a, out, i, n);
+	}, a.x, a.y, a.z, out.x, out.y, out.z);
+}
+
+/// @brief Normalize `n` four-dimensional vectors
+/// @details Zero-length vectors yield NaN components, exactly as the scalar formula would
+template <typename ISA, typename T>
+inline void normalize(ISA, const internal::_in_vec4<T>& a, const soa_vec4<T>& out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_normalize_block<decltype(p), decltype(aligned)::value>(a, out, i, n);
+	}, a.x, a.y, a.z, a.w, out.x, out.y, out.z, out.w);
+}
+
+/// @brief Compute the euclidean distances `out[i] = |a[i] - b[i]|` of `n` pairs of three-dimensional points
+template <typename ISA, typename T>
+inline void distance(ISA, const internal::_in_vec3<T>& a, const internal::_in_vec3<T>& b, T* out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_distance_block<decltype(p), decltype(aligned)::value>(a, b, out, i, n);
+	}, a.x, a.y, a.z, b.x, b.y, b.z, out);
+}
+
+/// @brief Compute the euclidean distances `out[i] = |a[i] - b[i]|` of `n` pairs of four-dimensional points
+template <typename ISA, typename T>
+inline void distance(ISA, const internal::_in_vec4<T>& a, const internal::_in_vec4<T>& b, T* out, const std::size_t& n)
+{
+	internal::_soa_dispatch<T, ISA>([&](auto p, auto aligned, const std::size_t& i)
+	{
+		return internal::_distance_block<decltype(p), decltype(aligned)::value>(a, b, out, i, n);
+	}, a.x, a.y, a.z, a.w, b.x, b.y, b.z, b.w, out);
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename T>
+inline void dot(const internal::_in_vec3<T>& a, const internal::_in_vec3<T>& b, T* out, const std::size_t& n) { dot(native{}, a, b, out, n); }
+template <typename T>
+inline void dot(const internal::_in_vec4<T>& a, const internal::_in_vec4<T>& b, T* out, const std::size_t& n) { dot(native{}, a, b, out, n); }
+template <typename T>
+inline void cross(const internal::_in_vec3<T>& a, const internal::_in_vec3<T>& b, const soa_vec3<T>& out, const std::size_t& n) { cross(native{}, a, b, out, n); }
+template <typename T>
+inline void length(const internal::_in_vec3<T>& a, T* out, const std::size_t& n) { length(native{}, a, out, n); }
+template <typename T>
+inline void length(const internal::_in_vec4<T>& a, T* out, const std::size_t& n) { length(native{}, a, out, n); }
+template <typename T>
+inline void normalize(const internal::_in_vec3<T>& a, const soa_vec3<T>& out, const std::size_t& n) { normalize(native{}, a, out, n); }
+template <typename T>
+inline void normalize(const internal::_in_vec4<T>& a, const soa_vec4<T>& out, const std::size_t& n) { normalize(native{}, a, out, n); }
+template <typename T>
+inline void distance(const internal::_in_vec3<T>& a, const internal::_in_vec3<T>& b, T* out, const std::size_t& n) { distance(native{}, a, b, out, n); }
+template <typename T>
+inline void distance(const internal::_in_vec4<T>& a, const internal::_in_vec4<T>& b, T* out, const std::size_t& n) { distance(native{}, a, b, out, n); }
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_GEOMETRY
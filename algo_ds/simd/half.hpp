@@ -0,0 +1,327 @@
+#ifndef FCPUT_ALGODS_SIMD_HALF
+#define FCPUT_ALGODS_SIMD_HALF
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/* 16-bit floating-point storage types and array conversions from/to `float`.
+ *
+ * `half` is IEEE 754 binary16 (5 exponent bits, 10 mantissa bits), `bfloat16` is the upper half of a
+ * binary32 (8 exponent bits, 7 mantissa bits). Both are meant for storage only: they convert
+ * implicitly to and from `float`, in which every computation is carried out. Narrowing rounds to
+ * nearest even, NaNs stay (quiet) NaNs and overflow gives infinity.
+ *
+ * The `half` conversions use F16C on the SSE and AVX tags when it is enabled, AVX-512F on the
+ * `avx512` tag; the `bfloat16` ones are integer operations (SSE2, AVX2, AVX-512F). The remaining
+ * elements, and the tags without the needed extensions, use the scalar code.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+namespace internal
+{
+	inline std::uint32_t _bits(const float& f) { std::uint32_t _u; std::memcpy(&_u, &f, sizeof(_u)); return _u; }
+	inline float _from_bits(const std::uint32_t& u) { float _f; std::memcpy(&_f, &u, sizeof(_f)); return _f; }
+
+	// binary32 -> binary16, round to nearest even (see F. Giesen, "float->half variants")
+	inline std::uint16_t _float_to_half(const float& f)
+	{
+		constexpr std::uint32_t _f32_inf{ 255u << 23 }, _f16_max{ (127u + 16) << 23 };
+		constexpr std::uint32_t _denorm_magic{ ((127u - 15) + (23 - 10) + 1) << 23 };
+
+		std::uint32_t _u{ _bits(f) };
+		const std::uint32_t _sign{ _u & 0x80000000u };
+		_u ^= _sign;
+
+		std::uint16_t _res;
+		if (_u >= _f16_max)	// Inf or NaN
+			_res = _u > _f32_inf ? 0x7e00 : 0x7c00;
+		else if (_u < (113u << 23))	// Subnormal or zero: the addition aligns (and rounds) the mantissa
+			_res = static_cast<std::uint16_t>(_bits(_from_bits(_u) + _from_bits(_denorm_magic)) - _denorm_magic);
+		else
+		{
+			const std::uint32_t _odd{ (_u >> 13) & 1 };
+			_u += ((15u - 127) << 23) + 0xfff + _odd;
+			_res = static_cast<std::uint16_t>(_u >> 13);
+		}
+		return static_cast<std::uint16_t>(_res | (_sign >> 16));
+	}
+
+	// binary16 -> binary32, exact
+	inline float _half_to_float(const std::uint16_t& h)
+	{
+		constexpr std::uint32_t _shifted_exp{ 0x7c00u << 13 };
+		std::uint32_t _u{ (h & 0x7fffu) << 13 };
+		const std::uint32_t _exp{ _u & _shifted_exp };
+		_u += (127u - 15) << 23;
+
+		if (_exp == _shifted_exp)	// Inf or NaN
+			_u += (128u - 16) << 23;
+		else if (0 == _exp)	// Subnormal or zero: renormalize
+			_u = _bits(_from_bits(_u + (1u << 23)) - _from_bits(113u << 23));
+		return _from_bits(_u | (static_cast<std::uint32_t>(h & 0x8000u) << 16));
+	}
+
+	// binary32 -> bfloat16, round to nearest even; NaNs are quieted
+	inline std::uint16_t _float_to_bfloat16(const float& f)
+	{
+		const std::uint32_t _u{ _bits(f) };
+		if ((_u & 0x7fffffffu) > 0x7f800000u)
+			return static_cast<std::uint16_t>((_u >> 16) | 0x0040u);
+		return static_cast<std::uint16_t>((_u + 0x7fffu + ((_u >> 16) & 1)) >> 16);
+	}
+
+	inline float _bfloat16_to_float(const std::uint16_t& b) { return _from_bits(static_cast<std::uint32_t>(b) << 16); }
+}	// namespace internal
+
+/// @brief IEEE 754 half-precision storage type
+struct half
+{
+	std::uint16_t bits;
+
+	half(void) = default;
+	half(const float& f): bits{ internal::_float_to_half(f) } {}
+	operator float(void) const { return internal::_half_to_float(bits); }
+
+	static half from_bits(const std::uint16_t& b) { half _h; _h.bits = b; return _h; }
+};
+
+/// @brief Brain floating-point storage type
+struct bfloat16
+{
+	std::uint16_t bits;
+
+	bfloat16(void) = default;
+	bfloat16(const float& f): bits{ internal::_float_to_bfloat16(f) } {}
+	operator float(void) const { return internal::_bfloat16_to_float(bits); }
+
+	static bfloat16 from_bits(const std::uint16_t& b) { bfloat16 _b; _b.bits = b; return _b; }
+};
+
+static_assert(sizeof(half) == 2 and std::is_trivially_copyable_v<half>, "struct half: must be a 2 bytes trivially copyable type.\n");
+static_assert(sizeof(bfloat16) == 2 and std::is_trivially_copyable_v<bfloat16>, "struct bfloat16: must be a 2 bytes trivially copyable type.\n");
+
+/// @brief Check if `T` is one of the 16-bit storage types
+template <typename T> constexpr bool is_float16_v = std::is_same_v<T, half> or std::is_same_v<T, bfloat16>;
+
+namespace internal
+{
+	// Vectorized part of the conversions: each function processes elements [i, n) and returns the first unprocessed index.
+	// The primary templates process nothing
+	template <typename S, typename ISA>
+	struct _float16_ops
+	{
+		static inline std::size_t narrow(const float*, S*, const std::size_t& i, const std::size_t&) { return i; }
+		static inline std::size_t widen(const S*, float*, const std::size_t& i, const std::size_t&) { return i; }
+	};
+
+#if FCPUT_SIMD_F16C
+	template <>
+	struct _float16_ops<half, sse>
+	{
+		static inline std::size_t narrow(const float* in, half* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 4 <= n; i += 4)
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_ph(_mm_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+			return i;
+		}
+		static inline std::size_t widen(const half* in, float* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(out + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i))));
+			return i;
+		}
+	};
+
+	template <>
+	struct _float16_ops<half, avx>
+	{
+		static inline std::size_t narrow(const float* in, half* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 8 <= n; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+			return i;
+		}
+		static inline std::size_t widen(const half* in, float* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 8 <= n; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+			return i;
+		}
+	};
+#endif	// FCPUT_SIMD_F16C
+
+#if FCPUT_SIMD_SSE2
+	template <>
+	struct _float16_ops<bfloat16, sse>
+	{
+		// Rounded bfloat16 in the upper 16 bits of each lane
+		static inline __m128i _round(const __m128i& u)
+		{
+			const __m128i _nan{ _mm_cmpgt_epi32(_mm_and_si128(u, _mm_set1_epi32(0x7fffffff)), _mm_set1_epi32(0x7f800000)) };
+			const __m128i _odd{ _mm_and_si128(_mm_srli_epi32(u, 16), _mm_set1_epi32(1)) };
+			const __m128i _rounded{ _mm_add_epi32(u, _mm_add_epi32(_mm_set1_epi32(0x7fff), _odd)) };
+			const __m128i _quiet{ _mm_or_si128(u, _mm_set1_epi32(0x00400000)) };
+			return _mm_or_si128(_mm_and_si128(_nan, _quiet), _mm_andnot_si128(_nan, _rounded));
+		}
+
+		static inline std::size_t narrow(const float* in, bfloat16* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 8 <= n; i += 8)
+			{
+				// The arithmetic shift keeps the values in the int16 range, so the saturating pack is exact
+				const __m128i _lo{ _mm_srai_epi32(_round(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))), 16) };
+				const __m128i _hi{ _mm_srai_epi32(_round(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4))), 16) };
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(_lo, _hi));
+			}
+			return i;
+		}
+		static inline std::size_t widen(const bfloat16* in, float* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 8 <= n; i += 8)
+			{
+				const __m128i _b{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)) };
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(_mm_setzero_si128(), _b));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_unpackhi_epi16(_mm_setzero_si128(), _b));
+			}
+			return i;
+		}
+	};
+#endif	// FCPUT_SIMD_SSE2
+
+#if FCPUT_SIMD_AVX2
+	template <>
+	struct _float16_ops<bfloat16, avx>
+	{
+		static inline __m256i _round(const __m256i& u)
+		{
+			const __m256i _nan{ _mm256_cmpgt_epi32(_mm256_and_si256(u, _mm256_set1_epi32(0x7fffffff)), _mm256_set1_epi32(0x7f800000)) };
+			const __m256i _odd{ _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1)) };
+			const __m256i _rounded{ _mm256_add_epi32(u, _mm256_add_epi32(_mm256_set1_epi32(0x7fff), _odd)) };
+			return _mm256_blendv_epi8(_rounded, _mm256_or_si256(u, _mm256_set1_epi32(0x00400000)), _nan);
+		}
+
+		static inline std::size_t narrow(const float* in, bfloat16* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 16 <= n; i += 16)
+			{
+				const __m256i _lo{ _mm256_srai_epi32(_round(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))), 16) };
+				const __m256i _hi{ _mm256_srai_epi32(_round(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8))), 16) };
+				// The pack works within 128-bit lanes: restore the element order
+				const __m256i _packed{ _mm256_permute4x64_epi64(_mm256_packs_epi32(_lo, _hi), _MM_SHUFFLE(3, 1, 2, 0)) };
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _packed);
+			}
+			return i;
+		}
+		static inline std::size_t widen(const bfloat16* in, float* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 8 <= n; i += 8)
+			{
+				const __m256i _b{ _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))) };
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_slli_epi32(_b, 16));
+			}
+			return i;
+		}
+	};
+#elif FCPUT_SIMD_AVX
+	template <>
+	struct _float16_ops<bfloat16, avx> : _float16_ops<bfloat16, sse> {};
+#endif	// FCPUT_SIMD_AVX2
+
+#if FCPUT_SIMD_AVX512F
+	template <>
+	struct _float16_ops<half, avx512>
+	{
+		static inline std::size_t narrow(const float* in, half* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 16 <= n; i += 16)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtps_ph(_mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+			return i;
+		}
+		static inline std::size_t widen(const half* in, float* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 16 <= n; i += 16)
+				_mm512_storeu_ps(out + i, _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))));
+			return i;
+		}
+	};
+
+	template <>
+	struct _float16_ops<bfloat16, avx512>
+	{
+		static inline std::size_t narrow(const float* in, bfloat16* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 16 <= n; i += 16)
+			{
+				const __m512i _u{ _mm512_loadu_si512(in + i) };
+				const __mmask16 _nan{ _mm512_cmpgt_epi32_mask(_mm512_and_si512(_u, _mm512_set1_epi32(0x7fffffff)), _mm512_set1_epi32(0x7f800000)) };
+				const __m512i _odd{ _mm512_and_si512(_mm512_srli_epi32(_u, 16), _mm512_set1_epi32(1)) };
+				__m512i _r{ _mm512_add_epi32(_u, _mm512_add_epi32(_mm512_set1_epi32(0x7fff), _odd)) };
+				_r = _mm512_mask_or_epi32(_r, _nan, _u, _mm512_set1_epi32(0x00400000));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(_mm512_srli_epi32(_r, 16)));
+			}
+			return i;
+		}
+		static inline std::size_t widen(const bfloat16* in, float* out, std::size_t i, const std::size_t& n)
+		{
+			for (; i + 16 <= n; i += 16)
+			{
+				const __m512i _b{ _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))) };
+				_mm512_storeu_si512(out + i, _mm512_slli_epi32(_b, 16));
+			}
+			return i;
+		}
+	};
+#endif	// FCPUT_SIMD_AVX512F
+}	// namespace internal
+
+/// @brief Narrowing conversion of `n` floats to a 16-bit storage type
+template <typename ISA, typename S>
+inline std::enable_if_t<is_float16_v<S>> convert(ISA, const float* in, S* out, const std::size_t& n)
+{
+	std::size_t i{ internal::_float16_ops<S, ISA>::narrow(in, out, 0, n) };
+	for (; i < n; i++)
+		out[i] = S(in[i]);
+}
+
+/// @brief Widening conversion of `n` elements of a 16-bit storage type to floats
+template <typename ISA, typename S>
+inline std::enable_if_t<is_float16_v<S>> convert(ISA, const S* in, float* out, const std::size_t& n)
+{
+	std::size_t i{ internal::_float16_ops<S, ISA>::widen(in, out, 0, n) };
+	for (; i < n; i++)
+		out[i] = static_cast<float>(in[i]);
+}
+
+/// @brief Convert a whole vector, eg. `convert<half>(samples)` or `convert<float>(stored)`
+template <typename To, typename From, typename ISA = native>
+inline std::vector<To> convert(const std::vector<From>& in, ISA = ISA())
+{
+	std::vector<To> _res(in.size());
+	convert(ISA(), in.data(), _res.data(), in.size());
+	return _res;
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename S>
+inline std::enable_if_t<is_float16_v<S>> convert(const float* in, S* out, const std::size_t& n) { convert(native{}, in, out, n); }
+template <typename S>
+inline std::enable_if_t<is_float16_v<S>> convert(const S* in, float* out, const std::size_t& n) { convert(native{}, in, out, n); }
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_HALF
@@ -0,0 +1,320 @@
+#ifndef FCPUT_ALGODS_SIMD_REDUCE
+#define FCPUT_ALGODS_SIMD_REDUCE
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <thread>
+
+/* Vectorized reductions over contiguous arrays.
+ *
+ * Sums and dot products keep `internal::_accumulators` independent accumulators so that consecutive
+ * additions/FMAs don't wait on each other's latency. The summation policy tags select between the
+ * plain accumulation and the compensated ones: Kahan's, and Neumaier's (implemented branch-free
+ * through Knuth's TwoSum, which yields the same correction term). Compensated kernels must not be
+ * compiled with `-ffast-math` or any flag allowing reassociation, which would optimize the
+ * compensation away.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+// Summation policy tags
+struct plain_summation{};
+struct kahan_summation{};
+struct neumaier_summation{};
+
+/// @brief Number of elements reduced by each task of the parallel reductions
+/// @details It is fixed (not derived from the number of threads) so that the partial results, and
+/// the order in which they are combined, are the same whatever the number of threads is
+constexpr std::size_t parallel_reduce_block{ 1 << 15 };
+
+namespace internal
+{
+	// Independent accumulators of the sums and dot products
+	constexpr std::size_t _accumulators{ 4 };
+
+	// Running sum of one register; `result()` is only meaningful for scalar packs
+	template <typename P, typename Summation>
+	struct _accumulator;
+
+	template <typename P>
+	struct _accumulator<P, plain_summation>
+	{
+		typename P::type s{ P::zero() };
+
+		inline void add(const typename P::type& x) { s = P::add(s, x); }
+		inline void fmadd(const typename P::type& a, const typename P::type& b) { s = P::fmadd(a, b, s); }
+		inline typename P::scalar_type result(void) const { return s; }
+
+		// Fold every lane of `o` into this (scalar) accumulator
+		template <typename O>
+		inline void fold(const O& o)
+		{
+			alignas(64) typename P::scalar_type _s[O::pack_width];
+			O::pack::storeu(_s, o.s);
+			for (std::size_t l{0}; l < O::pack_width; l++)
+				add(_s[l]);
+		}
+
+		using pack = P;
+		constexpr static std::size_t pack_width = P::width;
+	};
+
+	template <typename P>
+	struct _accumulator<P, kahan_summation>
+	{
+		typename P::type s{ P::zero() };
+		typename P::type c{ P::zero() };	// sum = s - c
+
+		inline void add(const typename P::type& x)
+		{
+			const auto _y = P::sub(x, c);
+			const auto _t = P::add(s, _y);
+			c = P::sub(P::sub(_t, s), _y);
+			s = _t;
+		}
+		inline void fmadd(const typename P::type& a, const typename P::type& b) { add(P::mul(a, b)); }
+		inline typename P::scalar_type result(void) const { return s - c; }
+
+		template <typename O>
+		inline void fold(const O& o)
+		{
+			alignas(64) typename P::scalar_type _s[O::pack_width], _c[O::pack_width];
+			O::pack::storeu(_s, o.s);
+			O::pack::storeu(_c, o.c);
+			for (std::size_t l{0}; l < O::pack_width; l++)
+			{
+				add(_s[l]);
+				c += _c[l];
+			}
+		}
+
+		using pack = P;
+		constexpr static std::size_t pack_width = P::width;
+	};
+
+	template <typename P>
+	struct _accumulator<P, neumaier_summation>
+	{
+		typename P::type s{ P::zero() };
+		typename P::type c{ P::zero() };	// sum = s + c
+
+		inline void add(const typename P::type& x)
+		{
+			// TwoSum: exact rounding error of `s + x` whichever operand is larger
+			const auto _t = P::add(s, x);
+			const auto _z = P::sub(_t, s);
+			c = P::add(c, P::add(P::sub(s, P::sub(_t, _z)), P::sub(x, _z)));
+			s = _t;
+		}
+		inline void fmadd(const typename P::type& a, const typename P::type& b) { add(P::mul(a, b)); }
+		inline typename P::scalar_type result(void) const { return s + c; }
+
+		template <typename O>
+		inline void fold(const O& o)
+		{
+			alignas(64) typename P::scalar_type _s[O::pack_width], _c[O::pack_width];
+			O::pack::storeu(_s, o.s);
+			O::pack::storeu(_c, o.c);
+			for (std::size_t l{0}; l < O::pack_width; l++)
+			{
+				add(_s[l]);
+				c += _c[l];
+			}
+		}
+
+		using pack = P;
+		constexpr static std::size_t pack_width = P::width;
+	};
+
+	template <typename T, typename Summation>
+	using _scalar_accumulator = _accumulator<pack<T, scalar>, Summation>;
+
+	// Accumulate `a[i]` (or `a[i]*b[i]` when `b` is given) for i in [0, n) into a scalar accumulator
+	template <typename P, bool Aligned, typename Summation, typename T>
+	inline void _accumulate(_scalar_accumulator<T, Summation>& res, const T* a, const T* b, const std::size_t& n)
+	{
+		constexpr std::size_t _step{ _accumulators * P::width };
+		_accumulator<P, Summation> _acc[_accumulators];
+		std::size_t i{0};
+		if (nullptr == b)
+		{
+			for (; i + _step <= n; i += _step)
+				for (std::size_t k{0}; k < _accumulators; k++)
+					_acc[k].add(_load<P, Aligned>(a + i + k * P::width));
+			for (; i + P::width <= n; i += P::width)
+				_acc[0].add(_load<P, Aligned>(a + i));
+		} else {
+			for (; i + _step <= n; i += _step)
+				for (std::size_t k{0}; k < _accumulators; k++)
+					_acc[k].fmadd(_load<P, Aligned>(a + i + k * P::width), _load<P, Aligned>(b + i + k * P::width));
+			for (; i + P::width <= n; i += P::width)
+				_acc[0].fmadd(_load<P, Aligned>(a + i), _load<P, Aligned>(b + i));
+		}
+
+		for (std::size_t k{0}; k < _accumulators; k++)
+			res.fold(_acc[k]);
+
+		// Remainder
+		for (; i < n; i++)
+			if (nullptr == b) res.add(a[i]); else res.fmadd(a[i], b[i]);
+	}
+
+	template <typename ISA, typename Summation, typename T>
+	inline _scalar_accumulator<T, Summation> _accumulate(const T* a, const T* b, const std::size_t& n)
+	{
+		using _P = pack<T, ISA>;
+		_scalar_accumulator<T, Summation> _res;
+		if (nullptr == b ? _is_aligned<_P>(a) : _is_aligned<_P>(a, b))
+			_accumulate<_P, true, Summation>(_res, a, b, n);
+		else
+			_accumulate<_P, false, Summation>(_res, a, b, n);
+		return _res;
+	}
+
+	template <typename P, bool Aligned, bool Max, typename T>
+	inline T _extremum(const T* a, const std::size_t& n)
+	{
+		constexpr std::size_t _step{ _accumulators * P::width };
+		T _res{ Max ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity() };
+		std::size_t i{0};
+		if (n >= P::width)
+		{
+			typename P::type _acc[_accumulators];
+			for (std::size_t k{0}; k < _accumulators; k++)
+				_acc[k] = P::set1(_res);
+			for (; i + _step <= n; i += _step)
+				for (std::size_t k{0}; k < _accumulators; k++)
+					_acc[k] = Max ? P::max(_load<P, Aligned>(a + i + k * P::width), _acc[k])
+					              : P::min(_load<P, Aligned>(a + i + k * P::width), _acc[k]);
+			for (; i + P::width <= n; i += P::width)
+				_acc[0] = Max ? P::max(_load<P, Aligned>(a + i), _acc[0]) : P::min(_load<P, Aligned>(a + i), _acc[0]);
+			for (std::size_t k{1}; k < _accumulators; k++)
+				_acc[0] = Max ? P::max(_acc[k], _acc[0]) : P::min(_acc[k], _acc[0]);
+			_res = Max ? P::reduce_max(_acc[0]) : P::reduce_min(_acc[0]);
+		}
+		for (; i < n; i++)
+			_res = Max ? (a[i] > _res ? a[i] : _res) : (a[i] < _res ? a[i] : _res);
+		return _res;
+	}
+
+	template <typename ISA, typename Summation, typename T>
+	inline T _parallel_accumulate(const T* a, const T* b, const std::size_t& n, std::size_t threads)
+	{
+		const std::size_t _blocks{ (n + parallel_reduce_block - 1) / parallel_reduce_block };
+		if (0 == threads) threads = std::thread::hardware_concurrency();
+		if (threads > _blocks) threads = _blocks;
+
+		std::vector<_scalar_accumulator<T, Summation>> _partials(_blocks);
+		auto _work = [&](const std::size_t& first)
+		{
+			for (std::size_t _b{first}; _b < _blocks; _b += threads)
+			{
+				const std::size_t _from{ _b * parallel_reduce_block };
+				const std::size_t _n{ _from + parallel_reduce_block <= n ? parallel_reduce_block : n - _from };
+				_partials[_b] = _accumulate<ISA, Summation>(a + _from, nullptr == b ? nullptr : b + _from, _n);
+			}
+		};
+
+		_run_threads(threads, _work);
+
+		// Combine the partials serially and in block order
+		_scalar_accumulator<T, Summation> _res;
+		for (const auto& _p : _partials)
+			_res.fold(_p);
+		return _res.result();
+	}
+}	// namespace internal
+
+/// @brief Sum of the `n` elements of `a`
+template <typename ISA, typename T, typename Summation = plain_summation>
+inline T sum(ISA, const T* a, const std::size_t& n, Summation = Summation())
+{
+	return internal::_accumulate<ISA, Summation>(a, static_cast<const T*>(nullptr), n).result();
+}
+
+/// @brief Dot product of the arrays `a` and `b` of `n` elements each
+/// @details The compensated policies correct the rounding errors of the additions, not of the products
+template <typename ISA, typename T, typename Summation = plain_summation>
+inline T dot(ISA, const T* a, const T* b, const std::size_t& n, Summation = Summation())
+{
+	return internal::_accumulate<ISA, Summation>(a, b, n).result();
+}
+
+/// @brief Euclidean norm of the array `a` of `n` elements
+/// @details The squares are not rescaled: components beyond the square root of the largest representable value overflow
+template <typename ISA, typename T, typename Summation = plain_summation>
+inline T norm(ISA, const T* a, const std::size_t& n, Summation = Summation())
+{
+	return std::sqrt(dot(ISA(), a, a, n, Summation()));
+}
+
+/// @brief Smallest of the `n` elements of `a` (infinity if `n == 0`)
+/// @details NaN elements are ignored
+template <typename ISA, typename T>
+inline T min(ISA, const T* a, const std::size_t& n)
+{
+	using _P = pack<T, ISA>;
+	return internal::_is_aligned<_P>(a) ? internal::_extremum<_P, true, false>(a, n) : internal::_extremum<_P, false, false>(a, n);
+}
+
+/// @brief Largest of the `n` elements of `a` (minus infinity if `n == 0`)
+/// @details NaN elements are ignored
+template <typename ISA, typename T>
+inline T max(ISA, const T* a, const std::size_t& n)
+{
+	using _P = pack<T, ISA>;
+	return internal::_is_aligned<_P>(a) ? internal::_extremum<_P, true, true>(a, n) : internal::_extremum<_P, false, true>(a, n);
+}
+
+/// @brief Multithreaded sum of the `n` elements of `a`
+/// @details `threads == 0` uses all the hardware threads. The result doesn't depend on the number of threads
+template <typename ISA, typename T, typename Summation = plain_summation>
+inline T parallel_sum(ISA, const T* a, const std::size_t& n, Summation = Summation(), const std::size_t& threads = 0)
+{
+	return internal::_parallel_accumulate<ISA, Summation>(a, static_cast<const T*>(nullptr), n, threads);
+}
+
+/// @brief Multithreaded dot product of the arrays `a` and `b` of `n` elements each
+/// @details `threads == 0` uses all the hardware threads. The result doesn't depend on the number of threads
+template <typename ISA, typename T, typename Summation = plain_summation>
+inline T parallel_dot(ISA, const T* a, const T* b, const std::size_t& n, Summation = Summation(), const std::size_t& threads = 0)
+{
+	return internal::_parallel_accumulate<ISA, Summation>(a, b, n, threads);
+}
+
+/// @brief Multithreaded euclidean norm of the array `a` of `n` elements
+/// @details `threads == 0` uses all the hardware threads. The result doesn't depend on the number of threads
+template <typename ISA, typename T, typename Summation = plain_summation>
+inline T parallel_norm(ISA, const T* a, const std::size_t& n, Summation = Summation(), const std::size_t& threads = 0)
+{
+	return std::sqrt(parallel_dot(ISA(), a, a, n, Summation(), threads));
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename T, typename Summation = plain_summation>
+inline T sum(const T* a, const std::size_t& n, Summation = Summation()) { return sum(native{}, a, n, Summation()); }
+template <typename T, typename Summation = plain_summation>
+inline T dot(const T* a, const T* b, const std::size_t& n, Summation = Summation()) { return dot(native{}, a, b, n, Summation()); }
+template <typename T, typename Summation = plain_summation>
+inline T norm(const T* a, const std::size_t& n, Summation = Summation()) { return norm(native{}, a, n, Summation()); }
+template <typename T>
+inline T min(const T* a, const std::size_t& n) { return min(native{}, a, n); }
+template <typename T>
+inline T max(const T* a, const std::size_t& n) { return max(native{}, a, n); }
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_REDUCE
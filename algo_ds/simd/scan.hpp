@@ -0,0 +1,399 @@
+#ifndef FCPUT_ALGODS_SIMD_SCAN
+#define FCPUT_ALGODS_SIMD_SCAN
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <type_traits>
+
+/* Prefix sums (scans) over contiguous arrays of `std::int32_t`, `float` or `double`.
+ *
+ * Inside a register the scan is computed by log2(width) shift-and-add steps; the running total of
+ * the previous registers is then broadcast and added to every lane. The 256-bit integer scan needs
+ * AVX2, every other one the base instruction set of its tag. Input and output arrays may coincide.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+/// @brief Smallest number of elements handled by each thread of the parallel scans
+constexpr std::size_t parallel_scan_min_chunk{ 1 << 16 };
+
+namespace internal
+{
+	// Register-level operations needed by the scans:
+	// `prefix` is the in-register inclusive scan, `shift1` moves every lane up by one (inserting zero),
+	// `last` broadcasts the highest lane and `first` extracts the lowest one
+	template <typename T, typename ISA>
+	struct _scan_ops;
+
+	template <typename T>
+	struct _scan_ops<T, scalar>
+	{
+		using type = T;
+		constexpr static std::size_t width = 1;
+
+		static inline type set1(const T& s) { return s; }
+		static inline type loadu(const T* p) { return *p; }
+		static inline void storeu(T* p, const type& v) { *p = v; }
+		static inline type add(const type& a, const type& b) { return a + b; }
+		static inline type prefix(const type& v) { return v; }
+		static inline type shift1(const type&) { return T{0}; }
+		static inline type last(const type& v) { return v; }
+		static inline T first(const type& v) { return v; }
+	};
+
+#if FCPUT_SIMD_SSE2
+	template <>
+	struct _scan_ops<float, sse>
+	{
+		using type = __m128;
+		constexpr static std::size_t width = 4;
+
+		static inline type set1(const float& s) { return _mm_set1_ps(s); }
+		static inline type loadu(const float* p) { return _mm_loadu_ps(p); }
+		static inline void storeu(float* p, const type& v) { _mm_storeu_ps(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm_add_ps(a, b); }
+		static inline type shift1(const type& v) { return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)); }
+		static inline type prefix(type v)
+		{
+			v = _mm_add_ps(v, shift1(v));
+			return _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+		}
+		static inline type last(const type& v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+		static inline float first(const type& v) { return _mm_cvtss_f32(v); }
+	};
+
+	template <>
+	struct _scan_ops<double, sse>
+	{
+		using type = __m128d;
+		constexpr static std::size_t width = 2;
+
+		static inline type set1(const double& s) { return _mm_set1_pd(s); }
+		static inline type loadu(const double* p) { return _mm_loadu_pd(p); }
+		static inline void storeu(double* p, const type& v) { _mm_storeu_pd(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm_add_pd(a, b); }
+		static inline type shift1(const type& v) { return _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(v), 8)); }
+		static inline type prefix(const type& v) { return _mm_add_pd(v, shift1(v)); }
+		static inline type last(const type& v) { return _mm_unpackhi_pd(v, v); }
+		static inline double first(const type& v) { return _mm_cvtsd_f64(v); }
+	};
+
+	template <>
+	struct _scan_ops<std::int32_t, sse>
+	{
+		using type = __m128i;
+		constexpr static std::size_t width = 4;
+
+		static inline type set1(const std::int32_t& s) { return _mm_set1_epi32(s); }
+		static inline type loadu(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+		static inline void storeu(std::int32_t* p, const type& v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+		static inline type add(const type& a, const type& b) { return _mm_add_epi32(a, b); }
+		static inline type shift1(const type& v) { return _mm_slli_si128(v, 4); }
+		static inline type prefix(type v)
+		{
+			v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+			return _mm_add_epi32(v, _mm_slli_si128(v, 8));
+		}
+		static inline type last(const type& v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)); }
+		static inline std::int32_t first(const type& v) { return _mm_cvtsi128_si32(v); }
+	};
+#endif	// FCPUT_SIMD_SSE2
+
+#if FCPUT_SIMD_AVX
+	// AVX shifts don't cross the 128-bit lanes: scan each lane, then add the total of the lower lane to the upper one
+	template <>
+	struct _scan_ops<float, avx>
+	{
+		using type = __m256;
+		constexpr static std::size_t width = 8;
+
+		static inline type set1(const float& s) { return _mm256_set1_ps(s); }
+		static inline type loadu(const float* p) { return _mm256_loadu_ps(p); }
+		static inline void storeu(float* p, const type& v) { _mm256_storeu_ps(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm256_add_ps(a, b); }
+		// Broadcast the highest element of the lower lane to the upper lane, zero the lower lane
+		static inline type _carry(const type& v) { return _mm256_permute_ps(_mm256_permute2f128_ps(v, v, 0x08), _MM_SHUFFLE(3, 3, 3, 3)); }
+		static inline type _lane_shift1(const type& v) { return _mm256_blend_ps(_mm256_permute_ps(v, _MM_SHUFFLE(2, 1, 0, 3)), _mm256_setzero_ps(), 0x11); }
+		static inline type shift1(const type& v) { return _mm256_blend_ps(_lane_shift1(v), _carry(v), 0x10); }
+		static inline type prefix(type v)
+		{
+			v = _mm256_add_ps(v, _lane_shift1(v));
+			v = _mm256_add_ps(v, _mm256_blend_ps(_mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2)), _mm256_setzero_ps(), 0x33));
+			return _mm256_add_ps(v, _carry(v));
+		}
+		static inline type last(const type& v) { return _mm256_permute_ps(_mm256_permute2f128_ps(v, v, 0x11), _MM_SHUFFLE(3, 3, 3, 3)); }
+		static inline float first(const type& v) { return _mm256_cvtss_f32(v); }
+	};
+
+	template <>
+	struct _scan_ops<double, avx>
+	{
+		using type = __m256d;
+		constexpr static std::size_t width = 4;
+
+		static inline type set1(const double& s) { return _mm256_set1_pd(s); }
+		static inline type loadu(const double* p) { return _mm256_loadu_pd(p); }
+		static inline void storeu(double* p, const type& v) { _mm256_storeu_pd(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm256_add_pd(a, b); }
+		static inline type _carry(const type& v) { return _mm256_permute_pd(_mm256_permute2f128_pd(v, v, 0x08), 0xF); }
+		static inline type _lane_shift1(const type& v) { return _mm256_blend_pd(_mm256_permute_pd(v, 0x0), _mm256_setzero_pd(), 0x5); }
+		static inline type shift1(const type& v) { return _mm256_blend_pd(_lane_shift1(v), _carry(v), 0x4); }
+		static inline type prefix(type v)
+		{
+			v = _mm256_add_pd(v, _lane_shift1(v));
+			return _mm256_add_pd(v, _carry(v));
+		}
+		static inline type last(const type& v) { return _mm256_permute_pd(_mm256_permute2f128_pd(v, v, 0x11), 0xF); }
+		static inline double first(const type& v) { return _mm256_cvtsd_f64(v); }
+	};
+#endif	// FCPUT_SIMD_AVX
+
+#if FCPUT_SIMD_AVX2
+	template <>
+	struct _scan_ops<std::int32_t, avx>
+	{
+		using type = __m256i;
+		constexpr static std::size_t width = 8;
+
+		static inline type set1(const std::int32_t& s) { return _mm256_set1_epi32(s); }
+		static inline type loadu(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+		static inline void storeu(std::int32_t* p, const type& v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+		static inline type add(const type& a, const type& b) { return _mm256_add_epi32(a, b); }
+		static inline type _carry(const type& v) { return _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x08), _MM_SHUFFLE(3, 3, 3, 3)); }
+		static inline type shift1(const type& v) { return _mm256_blend_epi32(_mm256_slli_si256(v, 4), _carry(v), 0x10); }
+		static inline type prefix(type v)
+		{
+			v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+			v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+			return _mm256_add_epi32(v, _carry(v));
+		}
+		static inline type last(const type& v) { return _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x11), _MM_SHUFFLE(3, 3, 3, 3)); }
+		static inline std::int32_t first(const type& v) { return _mm_cvtsi128_si32(_mm256_castsi256_si128(v)); }
+	};
+#endif	// FCPUT_SIMD_AVX2
+
+#if FCPUT_SIMD_AVX512F
+	// `valignd`/`valignq` shift across the whole register: lanes are moved up by K, zeroes come in from below
+	template <>
+	struct _scan_ops<std::int32_t, avx512>
+	{
+		using type = __m512i;
+		constexpr static std::size_t width = 16;
+
+		template <int K>
+		static inline type _shift(const type& v) { return _mm512_alignr_epi32(v, _mm512_setzero_si512(), 16 - K); }
+
+		static inline type set1(const std::int32_t& s) { return _mm512_set1_epi32(s); }
+		static inline type loadu(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+		static inline void storeu(std::int32_t* p, const type& v) { _mm512_storeu_si512(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm512_add_epi32(a, b); }
+		static inline type shift1(const type& v) { return _shift<1>(v); }
+		static inline type prefix(type v)
+		{
+			v = _mm512_add_epi32(v, _shift<1>(v));
+			v = _mm512_add_epi32(v, _shift<2>(v));
+			v = _mm512_add_epi32(v, _shift<4>(v));
+			return _mm512_add_epi32(v, _shift<8>(v));
+		}
+		static inline type last(const type& v) { return _mm512_permutexvar_epi32(_mm512_set1_epi32(15), v); }
+		static inline std::int32_t first(const type& v) { return _mm_cvtsi128_si32(_mm512_castsi512_si128(v)); }
+	};
+
+	template <>
+	struct _scan_ops<float, avx512>
+	{
+		using type = __m512;
+		constexpr static std::size_t width = 16;
+
+		static inline type set1(const float& s) { return _mm512_set1_ps(s); }
+		static inline type loadu(const float* p) { return _mm512_loadu_ps(p); }
+		static inline void storeu(float* p, const type& v) { _mm512_storeu_ps(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm512_add_ps(a, b); }
+		template <int K>
+		static inline type _shift(const type& v) { return _mm512_castsi512_ps(_scan_ops<std::int32_t, avx512>::_shift<K>(_mm512_castps_si512(v))); }
+		static inline type shift1(const type& v) { return _shift<1>(v); }
+		static inline type prefix(type v)
+		{
+			v = _mm512_add_ps(v, _shift<1>(v));
+			v = _mm512_add_ps(v, _shift<2>(v));
+			v = _mm512_add_ps(v, _shift<4>(v));
+			return _mm512_add_ps(v, _shift<8>(v));
+		}
+		static inline type last(const type& v) { return _mm512_permutexvar_ps(_mm512_set1_epi32(15), v); }
+		static inline float first(const type& v) { return _mm512_cvtss_f32(v); }
+	};
+
+	template <>
+	struct _scan_ops<double, avx512>
+	{
+		using type = __m512d;
+		constexpr static std::size_t width = 8;
+
+		template <int K>
+		static inline type _shift(const type& v) { return _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(v), _mm512_setzero_si512(), 8 - K)); }
+
+		static inline type set1(const double& s) { return _mm512_set1_pd(s); }
+		static inline type loadu(const double* p) { return _mm512_loadu_pd(p); }
+		static inline void storeu(double* p, const type& v) { _mm512_storeu_pd(p, v); }
+		static inline type add(const type& a, const type& b) { return _mm512_add_pd(a, b); }
+		static inline type shift1(const type& v) { return _shift<1>(v); }
+		static inline type prefix(type v)
+		{
+			v = _mm512_add_pd(v, _shift<1>(v));
+			v = _mm512_add_pd(v, _shift<2>(v));
+			return _mm512_add_pd(v, _shift<4>(v));
+		}
+		static inline type last(const type& v) { return _mm512_permutexvar_pd(_mm512_set1_epi64(7), v); }
+		static inline double first(const type& v) { return _mm512_cvtsd_f64(v); }
+	};
+#endif	// FCPUT_SIMD_AVX512F
+
+	// Scan `n` elements starting from `init`; returns `init` plus the sum of all the elements
+	template <typename O, bool Inclusive, typename T>
+	inline T _scan(const T* in, T* out, const std::size_t& n, const T& init)
+	{
+		auto _carry = O::set1(init);
+		std::size_t i{0};
+		for (; i + O::width <= n; i += O::width)
+		{
+			const auto _p = O::prefix(O::loadu(in + i));
+			if constexpr (Inclusive)
+				O::storeu(out + i, O::add(_p, _carry));
+			else
+				O::storeu(out + i, O::add(O::shift1(_p), _carry));
+			_carry = O::add(_carry, O::last(_p));
+		}
+
+		// Remainder
+		T _c{ O::first(_carry) };
+		for (; i < n; i++)
+		{
+			const T _x{ in[i] };
+			if constexpr (Inclusive) { _c += _x; out[i] = _c; }
+			else { out[i] = _c; _c += _x; }
+		}
+		return _c;
+	}
+
+	template <typename O, typename T>
+	inline T _total(const T* in, const std::size_t& n)
+	{
+		auto _acc = O::set1(T{0});
+		std::size_t i{0};
+		for (; i + O::width <= n; i += O::width)
+			_acc = O::add(_acc, O::loadu(in + i));
+		T _t{ O::first(O::last(O::prefix(_acc))) };
+		for (; i < n; i++)
+			_t += in[i];
+		return _t;
+	}
+
+	// Two-pass block scan: per-chunk totals, serial scan of the totals, then per-chunk scans starting from them
+	template <typename ISA, bool Inclusive, typename T>
+	inline T _parallel_scan(const T* in, T* out, const std::size_t& n, const T& init, std::size_t threads)
+	{
+		using _O = _scan_ops<T, ISA>;
+		if (0 == threads) threads = std::thread::hardware_concurrency();
+		if (threads > n / parallel_scan_min_chunk) threads = n / parallel_scan_min_chunk;
+		if (threads <= 1)
+			return _scan<_O, Inclusive>(in, out, n, init);
+
+		const std::size_t _chunk{ (n + threads - 1) / threads };
+		std::vector<T> _offsets(threads + 1);
+		auto _bounds = [&](const std::size_t& t, std::size_t& from, std::size_t& count)
+		{
+			from = t * _chunk < n ? t * _chunk : n;
+			count = from + _chunk <= n ? _chunk : n - from;
+		};
+
+		// First pass: totals of each chunk (read only, so the input is not written twice)
+		_run_threads(threads, [&](const std::size_t& t)
+		{
+			std::size_t _from, _n;
+			_bounds(t, _from, _n);
+			_offsets[t + 1] = _total<_O>(in + _from, _n);
+		});
+
+		_offsets[0] = init;
+		for (std::size_t t{0}; t < threads; t++)
+			_offsets[t + 1] += _offsets[t];
+
+		// Second pass: each chunk is scanned starting from the total of the previous ones
+		_run_threads(threads, [&](const std::size_t& t)
+		{
+			std::size_t _from, _n;
+			_bounds(t, _from, _n);
+			_scan<_O, Inclusive>(in + _from, out + _from, _n, _offsets[t]);
+		});
+
+		return _offsets[threads];
+	}
+}	// namespace internal
+
+/// @brief Inclusive prefix sum: `out[i] = init + in[0] + ... + in[i]`
+/// @return `init` plus the sum of all the elements
+template <typename ISA, typename T>
+inline T inclusive_scan(ISA, const T* in, T* out, const std::size_t& n, const T& init = T{0})
+{
+	return internal::_scan<internal::_scan_ops<T, ISA>, true>(in, out, n, init);
+}
+
+/// @brief Exclusive prefix sum: `out[i] = init + in[0] + ... + in[i-1]`
+/// @return `init` plus the sum of all the elements
+template <typename ISA, typename T>
+inline T exclusive_scan(ISA, const T* in, T* out, const std::size_t& n, const T& init = T{0})
+{
+	return internal::_scan<internal::_scan_ops<T, ISA>, false>(in, out, n, init);
+}
+
+/// @brief Multithreaded inclusive prefix sum
+/// @details `threads == 0` uses all the hardware threads. Floating point results may differ from the serial
+/// scan in the last bits, since the chunk totals are added in a different order
+template <typename ISA, typename T>
+inline T parallel_inclusive_scan(ISA, const T* in, T* out, const std::size_t& n, const T& init = T{0}, const std::size_t& threads = 0)
+{
+	return internal::_parallel_scan<ISA, true>(in, out, n, init, threads);
+}
+
+/// @brief Multithreaded exclusive prefix sum
+/// @details `threads == 0` uses all the hardware threads. Floating point results may differ from the serial
+/// scan in the last bits, since the chunk totals are added in a different order
+template <typename ISA, typename T>
+inline T parallel_exclusive_scan(ISA, const T* in, T* out, const std::size_t& n, const T& init = T{0}, const std::size_t& threads = 0)
+{
+	return internal::_parallel_scan<ISA, false>(in, out, n, init, threads);
+}
+
+// Overloads using the widest ISA extension enabled at compile time (AVX integer scans need AVX2)
+
+namespace internal
+{
+#if FCPUT_SIMD_AVX and not FCPUT_SIMD_AVX2 and not FCPUT_SIMD_AVX512F
+	template <typename T>
+	using _scan_native = typename std::conditional<std::is_integral<T>::value, sse, native>::type;
+#else
+	template <typename T>
+	using _scan_native = native;
+#endif
+}	// namespace internal
+
+template <typename T>
+inline T inclusive_scan(const T* in, T* out, const std::size_t& n, const T& init = T{0}) { return inclusive_scan(internal::_scan_native<T>{}, in, out, n, init); }
+template <typename T>
+inline T exclusive_scan(const T* in, T* out, const std::size_t& n, const T& init = T{0}) { return exclusive_scan(internal::_scan_native<T>{}, in, out, n, init); }
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_SCAN
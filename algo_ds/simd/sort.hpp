@@ -0,0 +1,726 @@
+#ifndef FCPUT_ALGODS_SIMD_SORT
+#define FCPUT_ALGODS_SIMD_SORT
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <bitset>
+
+/* Ascending sorts of `std::int32_t`/`float` keys, optionally carrying 32-bit values along.
+ *
+ * Small arrays (up to `sort_small_max` elements) are padded to a power-of-two number of registers
+ * and sorted by a bitonic network: every register is first sorted in-register (lane permutations
+ * followed by min/max and a constant blend), then the registers are merged by min/max between
+ * whole registers and by in-register merges. Larger arrays are quicksorted: the vectorized
+ * partition splits every register by a comparison mask and a lookup-table permutation (a compress
+ * with AVX-512F), storing it at both ends of the free region of the array, and the leaves are
+ * sorted by the networks.
+ *
+ * The SSE tag needs SSE4.1 and the AVX one AVX2 (falling back to SSE4.1); without them the scalar
+ * code is used. Equal keys are not kept in their original order (the sorts are not stable) and
+ * `float` keys must not be NaN.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+/// @brief Largest number of elements sorted by a single bitonic network
+constexpr std::size_t sort_small_max{ 64 };
+
+namespace internal
+{
+	// Bit `i` is set when lane `i` of a `W`-lanes register takes the maximum at the step comparing lanes `J` apart
+	// inside blocks of `K` lanes (bit K of the lane index reverses the direction; K = 0: ascending everywhere)
+	constexpr unsigned _lane_mask(const std::size_t& W, const std::size_t& J, const std::size_t& K)
+	{
+		unsigned _m{0};
+		for (std::size_t i{0}; i < W; i++)
+			if (((i & J) != 0) != ((i & K) != 0))
+				_m |= 1u << i;
+		return _m;
+	}
+
+	// Number of lanes set in a mask (std::bitset compiles to popcnt where available, and also builds with MSVC)
+	inline unsigned _popcount(const unsigned& m) { return static_cast<unsigned>(std::bitset<32>(m).count()); }
+
+	// Partition permutations: the lanes whose mask bit is set first, then the others, each group in order
+	struct _lut4_t { std::uint8_t bytes[16][16]; };	// pshufb control, 4 lanes
+	struct _lut8_t { std::uint32_t nibbles[256]; };	// lane index of position p in bits [4p, 4p+4), 8 lanes
+
+	constexpr _lut4_t _make_lut4(void)
+	{
+		_lut4_t _t{};
+		for (unsigned m{0}; m < 16; m++)
+		{
+			unsigned _pos{0};
+			for (unsigned _set : { 1u, 0u })
+				for (unsigned l{0}; l < 4; l++)
+					if (((m >> l) & 1u) == _set)
+					{
+						for (unsigned b{0}; b < 4; b++)
+							_t.bytes[m][4*_pos + b] = static_cast<std::uint8_t>(4*l + b);
+						_pos++;
+					}
+		}
+		return _t;
+	}
+
+	constexpr _lut8_t _make_lut8(void)
+	{
+		_lut8_t _t{};
+		for (unsigned m{0}; m < 256; m++)
+		{
+			unsigned _pos{0};
+			for (unsigned _set : { 1u, 0u })
+				for (unsigned l{0}; l < 8; l++)
+					if (((m >> l) & 1u) == _set)
+						_t.nibbles[m] |= l << (4 * _pos++);
+		}
+		return _t;
+	}
+
+	inline constexpr _lut4_t _lut4{ _make_lut4() };
+	inline constexpr _lut8_t _lut8{ _make_lut8() };
+
+	// Register operations needed by the sorts. The primary template marks the combinations without a vectorized sort
+	template <typename T, typename ISA>
+	struct _sort_lanes
+	{
+		constexpr static bool vectorized = false;
+	};
+
+#if FCPUT_SIMD_SSE41
+	template <>
+	struct _sort_lanes<float, sse>
+	{
+		constexpr static bool vectorized = true;
+		constexpr static std::size_t width = 4;
+		using type = __m128;
+		using mask_type = __m128;
+		using index_type = __m128i;
+
+		static inline type loadu(const void* p) { return _mm_loadu_ps(static_cast<const float*>(p)); }
+		static inline void storeu(void* p, const type& v) { _mm_storeu_ps(static_cast<float*>(p), v); }
+		static inline type set1(const float& s) { return _mm_set1_ps(s); }
+		static inline type min(const type& a, const type& b) { return _mm_min_ps(a, b); }
+		static inline type max(const type& a, const type& b) { return _mm_max_ps(a, b); }
+		static inline mask_type lt(const type& a, const type& b) { return _mm_cmplt_ps(a, b); }
+		static inline mask_type le(const type& a, const type& b) { return _mm_cmple_ps(a, b); }
+		static inline unsigned movemask(const mask_type& m) { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+		// `b` where the mask is set, `a` elsewhere
+		static inline type blendv(const type& a, const type& b, const mask_type& m) { return _mm_blendv_ps(a, b, m); }
+		template <unsigned M> static inline type blend(const type& a, const type& b) { return _mm_blend_ps(a, b, M); }
+		template <unsigned M> static inline mask_type blend_mask(const mask_type& a, const mask_type& b) { return _mm_blend_ps(a, b, M); }
+		template <std::size_t J> static inline type permute_xor(const type& v)
+		{
+			if constexpr (1 == J) return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+			else return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+		}
+		static inline index_type perm_index(const unsigned& m) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(_lut4.bytes[m])); }
+		static inline type permute(const type& v, const index_type& idx) { return _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(v), idx)); }
+	};
+
+	template <>
+	struct _sort_lanes<std::int32_t, sse>
+	{
+		constexpr static bool vectorized = true;
+		constexpr static std::size_t width = 4;
+		using type = __m128i;
+		using mask_type = __m128i;
+		using index_type = __m128i;
+
+		// 32-bit lane mask to 16-bit lane mask, for `_mm_blend_epi16`
+		constexpr static int _m16(const unsigned& m) { return static_cast<int>((m & 1u) * 0x03u | (m & 2u) * 0x06u | (m & 4u) * 0x0cu | (m & 8u) * 0x18u); }
+
+		static inline type loadu(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+		static inline void storeu(void* p, const type& v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+		static inline type set1(const std::int32_t& s) { return _mm_set1_epi32(s); }
+		static inline type min(const type& a, const type& b) { return _mm_min_epi32(a, b); }
+		static inline type max(const type& a, const type& b) { return _mm_max_epi32(a, b); }
+		static inline mask_type lt(const type& a, const type& b) { return _mm_cmplt_epi32(a, b); }
+		static inline mask_type le(const type& a, const type& b) { return _mm_xor_si128(_mm_cmpgt_epi32(a, b), _mm_set1_epi32(-1)); }
+		static inline unsigned movemask(const mask_type& m) { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m))); }
+		static inline type blendv(const type& a, const type& b, const mask_type& m) { return _mm_blendv_epi8(a, b, m); }
+		template <unsigned M> static inline type blend(const type& a, const type& b) { return _mm_blend_epi16(a, b, _m16(M)); }
+		template <unsigned M> static inline mask_type blend_mask(const mask_type& a, const mask_type& b) { return blend<M>(a, b); }
+		template <std::size_t J> static inline type permute_xor(const type& v)
+		{
+			if constexpr (1 == J) return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+			else return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+		}
+		static inline index_type perm_index(const unsigned& m) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(_lut4.bytes[m])); }
+		static inline type permute(const type& v, const index_type& idx) { return _mm_shuffle_epi8(v, idx); }
+	};
+#endif	// FCPUT_SIMD_SSE41
+
+#if FCPUT_SIMD_AVX2
+	// Lane indices of the partition permutation from the packed lookup table
+	inline __m256i _perm_index8(const unsigned& m)
+	{
+		const __m256i _shifts{ _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28) };
+		return _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(_lut8.nibbles[m])), _shifts), _mm256_set1_epi32(0xf));
+	}
+
+	template <>
+	struct _sort_lanes<float, avx>
+	{
+		constexpr static bool vectorized = true;
+		constexpr static std::size_t width = 8;
+		using type = __m256;
+		using mask_type = __m256;
+		using index_type = __m256i;
+
+		static inline type loadu(const void* p) { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+		static inline void storeu(void* p, const type& v) { _mm256_storeu_ps(static_cast<float*>(p), v); }
+		static inline type set1(const float& s) { return _mm256_set1_ps(s); }
+		static inline type min(const type& a, const type& b) { return _mm256_min_ps(a, b); }
+		static inline type max(const type& a, const type& b) { return _mm256_max_ps(a, b); }
+		static inline mask_type lt(const type& a, const type& b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static inline mask_type le(const type& a, const type& b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static inline unsigned movemask(const mask_type& m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+		static inline type blendv(const type& a, const type& b, const mask_type& m) { return _mm256_blendv_ps(a, b, m); }
+		template <unsigned M> static inline type blend(const type& a, const type& b) { return _mm256_blend_ps(a, b, M); }
+		template <unsigned M> static inline mask_type blend_mask(const mask_type& a, const mask_type& b) { return _mm256_blend_ps(a, b, M); }
+		template <std::size_t J> static inline type permute_xor(const type& v)
+		{
+			if constexpr (1 == J) return _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+			else if constexpr (2 == J) return _mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2));
+			else return _mm256_permute2f128_ps(v, v, 0x01);
+		}
+		static inline index_type perm_index(const unsigned& m) { return _perm_index8(m); }
+		static inline type permute(const type& v, const index_type& idx) { return _mm256_permutevar8x32_ps(v, idx); }
+	};
+
+	template <>
+	struct _sort_lanes<std::int32_t, avx>
+	{
+		constexpr static bool vectorized = true;
+		constexpr static std::size_t width = 8;
+		using type = __m256i;
+		using mask_type = __m256i;
+		using index_type = __m256i;
+
+		static inline type loadu(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+		static inline void storeu(void* p, const type& v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+		static inline type set1(const std::int32_t& s) { return _mm256_set1_epi32(s); }
+		static inline type min(const type& a, const type& b) { return _mm256_min_epi32(a, b); }
+		static inline type max(const type& a, const type& b) { return _mm256_max_epi32(a, b); }
+		static inline mask_type lt(const type& a, const type& b) { return _mm256_cmpgt_epi32(b, a); }
+		static inline mask_type le(const type& a, const type& b) { return _mm256_xor_si256(_mm256_cmpgt_epi32(a, b), _mm256_set1_epi32(-1)); }
+		static inline unsigned movemask(const mask_type& m) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))); }
+		static inline type blendv(const type& a, const type& b, const mask_type& m) { return _mm256_blendv_epi8(a, b, m); }
+		template <unsigned M> static inline type blend(const type& a, const type& b) { return _mm256_blend_epi32(a, b, M); }
+		template <unsigned M> static inline mask_type blend_mask(const mask_type& a, const mask_type& b) { return _mm256_blend_epi32(a, b, M); }
+		template <std::size_t J> static inline type permute_xor(const type& v)
+		{
+			if constexpr (1 == J) return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+			else if constexpr (2 == J) return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+			else return _mm256_permute2x128_si256(v, v, 0x01);
+		}
+		static inline index_type perm_index(const unsigned& m) { return _perm_index8(m); }
+		static inline type permute(const type& v, const index_type& idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+	};
+#elif FCPUT_SIMD_SSE41
+	template <typename T>
+	struct _sort_lanes<T, avx> : _sort_lanes<T, sse> {};
+#endif	// FCPUT_SIMD_AVX2
+
+#if FCPUT_SIMD_AVX512F
+	// The partition permutation is built by compressing the lane indices
+	inline __m512i _perm_index16(const unsigned& m)
+	{
+		const __m512i _iota{ _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15) };
+		const __mmask16 _m{ static_cast<__mmask16>(m) };
+		const __mmask16 _high{ static_cast<__mmask16>(0xffffu << _popcount(m)) };
+		return _mm512_mask_expand_epi32(_mm512_maskz_compress_epi32(_m, _iota), _high, _mm512_maskz_compress_epi32(static_cast<__mmask16>(~_m), _iota));
+	}
+
+	template <>
+	struct _sort_lanes<float, avx512>
+	{
+		constexpr static bool vectorized = true;
+		constexpr static std::size_t width = 16;
+		using type = __m512;
+		using mask_type = __mmask16;
+		using index_type = __m512i;
+
+		static inline type loadu(const void* p) { return _mm512_loadu_ps(p); }
+		static inline void storeu(void* p, const type& v) { _mm512_storeu_ps(p, v); }
+		static inline type set1(const float& s) { return _mm512_set1_ps(s); }
+		static inline type min(const type& a, const type& b) { return _mm512_min_ps(a, b); }
+		static inline type max(const type& a, const type& b) { return _mm512_max_ps(a, b); }
+		static inline mask_type lt(const type& a, const type& b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+		static inline mask_type le(const type& a, const type& b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+		static inline unsigned movemask(const mask_type& m) { return m; }
+		static inline type blendv(const type& a, const type& b, const mask_type& m) { return _mm512_mask_blend_ps(m, a, b); }
+		template <unsigned M> static inline type blend(const type& a, const type& b) { return _mm512_mask_blend_ps(static_cast<__mmask16>(M), a, b); }
+		template <unsigned M> static inline mask_type blend_mask(const mask_type& a, const mask_type& b)
+		{
+			return static_cast<mask_type>((a & ~M) | (b & M));
+		}
+		template <std::size_t J> static inline type permute_xor(const type& v)
+		{
+			if constexpr (1 == J) return _mm512_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+			else if constexpr (2 == J) return _mm512_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2));
+			else if constexpr (4 == J) return _mm512_shuffle_f32x4(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+			else return _mm512_shuffle_f32x4(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+		}
+		static inline index_type perm_index(const unsigned& m) { return _perm_index16(m); }
+		static inline type permute(const type& v, const index_type& idx) { return _mm512_permutexvar_ps(idx, v); }
+	};
+
+	template <>
+	struct _sort_lanes<std::int32_t, avx512>
+	{
+		constexpr static bool vectorized = true;
+		constexpr static std::size_t width = 16;
+		using type = __m512i;
+		using mask_type = __mmask16;
+		using index_type = __m512i;
+
+		static inline type loadu(const void* p) { return _mm512_loadu_si512(p); }
+		static inline void storeu(void* p, const type& v) { _mm512_storeu_si512(p, v); }
+		static inline type set1(const std::int32_t& s) { return _mm512_set1_epi32(s); }
+		static inline type min(const type& a, const type& b) { return _mm512_min_epi32(a, b); }
+		static inline type max(const type& a, const type& b) { return _mm512_max_epi32(a, b); }
+		static inline mask_type lt(const type& a, const type& b) { return _mm512_cmplt_epi32_mask(a, b); }
+		static inline mask_type le(const type& a, const type& b) { return _mm512_cmple_epi32_mask(a, b); }
+		static inline unsigned movemask(const mask_type& m) { return m; }
+		static inline type blendv(const type& a, const type& b, const mask_type& m) { return _mm512_mask_blend_epi32(m, a, b); }
+		template <unsigned M> static inline type blend(const type& a, const type& b) { return _mm512_mask_blend_epi32(static_cast<__mmask16>(M), a, b); }
+		template <unsigned M> static inline mask_type blend_mask(const mask_type& a, const mask_type& b)
+		{
+			return static_cast<mask_type>((a & ~M) | (b & M));
+		}
+		template <std::size_t J> static inline type permute_xor(const type& v)
+		{
+			if constexpr (1 == J) return _mm512_shuffle_epi32(v, static_cast<_MM_PERM_ENUM>(_MM_SHUFFLE(2, 3, 0, 1)));
+			else if constexpr (2 == J) return _mm512_shuffle_epi32(v, static_cast<_MM_PERM_ENUM>(_MM_SHUFFLE(1, 0, 3, 2)));
+			else if constexpr (4 == J) return _mm512_shuffle_i32x4(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+			else return _mm512_shuffle_i32x4(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+		}
+		static inline index_type perm_index(const unsigned& m) { return _perm_index16(m); }
+		static inline type permute(const type& v, const index_type& idx) { return _mm512_permutexvar_epi32(idx, v); }
+	};
+#endif	// FCPUT_SIMD_AVX512F
+
+	// Compare-exchange policies of the networks: keys only, or keys with the values following them
+
+	template <typename L>
+	struct _keys_network
+	{
+		using type = typename L::type;
+
+		static inline type load(const void* k, const void*) { return L::loadu(k); }
+		static inline void store(void* k, void*, const type& v) { L::storeu(k, v); }
+		template <std::size_t J> static inline type permute_xor(const type& v) { return L::template permute_xor<J>(v); }
+		// Lanes of `M` take the maximum of themselves and their partner `p`, the others the minimum
+		template <unsigned M> static inline type exchange(const type& v, const type& p) { return L::template blend<M>(L::min(v, p), L::max(v, p)); }
+		static inline void minmax(type& a, type& b)
+		{
+			const type _min{ L::min(a, b) };
+			b = L::max(a, b);
+			a = _min;
+		}
+	};
+
+	template <typename L>
+	struct _key_values_network
+	{
+		struct type { typename L::type k, v; };
+
+		static inline type load(const void* k, const void* v) { return { L::loadu(k), L::loadu(v) }; }
+		static inline void store(void* k, void* v, const type& x) { L::storeu(k, x.k); L::storeu(v, x.v); }
+		template <std::size_t J> static inline type permute_xor(const type& x) { return { L::template permute_xor<J>(x.k), L::template permute_xor<J>(x.v) }; }
+		template <unsigned M> static inline type exchange(const type& x, const type& p)
+		{
+			const auto _take{ L::template blend_mask<M>(L::lt(p.k, x.k), L::lt(x.k, p.k)) };
+			return { L::blendv(x.k, p.k, _take), L::blendv(x.v, p.v, _take) };
+		}
+		static inline void minmax(type& a, type& b)
+		{
+			const auto _swap{ L::lt(b.k, a.k) };
+			const type _a{ L::blendv(a.k, b.k, _swap), L::blendv(a.v, b.v, _swap) };
+			b = { L::blendv(b.k, a.k, _swap), L::blendv(b.v, a.v, _swap) };
+			a = _a;
+		}
+	};
+
+	// In-register merge of a bitonic sequence, ascending or descending
+	template <typename O, std::size_t W, std::size_t J>
+	inline typename O::type _merge_register(typename O::type v, const bool& descending)
+	{
+		constexpr unsigned _m{ _lane_mask(W, J, 0) }, _all{ (1u << W) - 1 };
+		const typename O::type _p{ O::template permute_xor<J>(v) };
+		v = descending ? O::template exchange<_all & ~_m>(v, _p) : O::template exchange<_m>(v, _p);
+		if constexpr (J > 1) return _merge_register<O, W, J / 2>(v, descending);
+		else return v;
+	}
+
+	// Stages of the in-register sort whose blocks (`K` lanes) are smaller than the register
+	template <typename O, std::size_t W, std::size_t K, std::size_t J>
+	inline typename O::type _sort_register_stages(typename O::type v)
+	{
+		v = O::template exchange<_lane_mask(W, J, K)>(v, O::template permute_xor<J>(v));
+		if constexpr (J > 1) return _sort_register_stages<O, W, K, J / 2>(v);
+		else if constexpr (2 * K < W) return _sort_register_stages<O, W, 2 * K, K>(v);
+		else return v;
+	}
+
+	template <typename O, std::size_t W>
+	inline typename O::type _sort_register(typename O::type v, const bool& descending)
+	{
+		if constexpr (W > 2) v = _sort_register_stages<O, W, 2, 1>(v);
+		return _merge_register<O, W, W / 2>(v, descending);
+	}
+
+	// Bitonic sort of `r` registers (a power of two) as a single sequence
+	template <typename O, std::size_t W>
+	inline void _bitonic_sort(typename O::type* v, const std::size_t& r)
+	{
+		for (std::size_t i{0}; i < r; i++)
+			v[i] = _sort_register<O, W>(v[i], i & 1);
+		for (std::size_t k{2 * W}; k <= r * W; k <<= 1)
+		{
+			for (std::size_t j{k / 2}; j >= W; j >>= 1)
+				for (std::size_t i{0}; i < r; i++)
+				{
+					const std::size_t _p{ i ^ (j / W) };
+					if (_p < i) continue;
+					O::minmax(v[i], v[_p]);
+					if ((i * W) & k) std::swap(v[i], v[_p]);
+				}
+			for (std::size_t i{0}; i < r; i++)
+				v[i] = _merge_register<O, W, W / 2>(v[i], ((i * W) & k) != 0);
+		}
+	}
+
+	template <typename T>
+	constexpr T _sentinel(void)
+	{
+		if constexpr (std::numeric_limits<T>::has_infinity) return std::numeric_limits<T>::infinity();
+		else return std::numeric_limits<T>::max();
+	}
+
+	// Scalar sorts, for the tags without a vectorized one
+	template <typename T, typename V>
+	inline void _insertion_sort(T* keys, V* values, const std::size_t& n)
+	{
+		for (std::size_t i{1}; i < n; i++)
+		{
+			const T _k{ keys[i] };
+			std::size_t j{i};
+			if constexpr (std::is_void_v<V>)
+			{
+				for (; j > 0 and _k < keys[j - 1]; j--)
+					keys[j] = keys[j - 1];
+			}
+			else
+			{
+				const V _v{ values[i] };
+				for (; j > 0 and _k < keys[j - 1]; j--)
+				{
+					keys[j] = keys[j - 1];
+					values[j] = values[j - 1];
+				}
+				values[j] = _v;
+			}
+			keys[j] = _k;
+		}
+	}
+
+	// Sort of at most `sort_small_max` elements; `V` is void for keys only
+	template <typename L, typename T, typename V>
+	inline void _sort_small(T* keys, V* values, const std::size_t& n)
+	{
+		if constexpr (not L::vectorized)
+			_insertion_sort(keys, values, n);
+		else
+		{
+			constexpr std::size_t W{ L::width };
+			constexpr bool _kv{ not std::is_void_v<V> };
+			using O = std::conditional_t<_kv, _key_values_network<L>, _keys_network<L>>;
+			if (n < 2) return;
+
+			std::size_t _r{1};
+			while (_r * W < n) _r <<= 1;
+
+			// Pad with the largest key; with values, the real elements having that key are restored afterwards
+			alignas(64) T _k[sort_small_max];
+			alignas(64) std::uint32_t _v[sort_small_max];
+			std::copy(keys, keys + n, _k);
+			std::fill(_k + n, _k + _r * W, _sentinel<T>());
+			if constexpr (_kv) { std::memcpy(_v, values, n * sizeof(V)); std::fill(_v + n, _v + _r * W, 0u); }
+
+			typename O::type _regs[sort_small_max / W];
+			for (std::size_t i{0}; i < _r; i++)
+				_regs[i] = O::load(_k + i * W, _v + i * W);
+			_bitonic_sort<O, W>(_regs, _r);
+			for (std::size_t i{0}; i < _r; i++)
+				O::store(_k + i * W, _v + i * W, _regs[i]);
+
+			if constexpr (_kv)
+			{
+				std::size_t _at_sentinel{0};
+				for (std::size_t i{0}; i < n; i++)
+					if (keys[i] == _sentinel<T>()) std::memcpy(_v + (n - ++_at_sentinel), values + i, sizeof(V));
+				std::memcpy(values, _v, n * sizeof(V));
+			}
+			std::copy(_k, _k + n, keys);
+		}
+	}
+
+	// Lomuto partition, for short arrays
+	template <bool OrEqual, typename T, typename V>
+	inline std::size_t _partition_scalar(T* keys, V* values, const std::size_t& n, const T& pivot)
+	{
+		std::size_t _c{0};
+		for (std::size_t i{0}; i < n; i++)
+			if (OrEqual ? not (pivot < keys[i]) : keys[i] < pivot)
+			{
+				std::swap(keys[i], keys[_c]);
+				if constexpr (not std::is_void_v<V>) std::swap(values[i], values[_c]);
+				_c++;
+			}
+		return _c;
+	}
+
+	// Moves the elements smaller than (or equal to, if `OrEqual`) the pivot first and returns their number.
+	// Two registers are set aside, so that both ends of the region still to be written have room for a whole register
+	template <typename L, bool OrEqual, typename T, typename V>
+	inline std::size_t _partition(T* keys, V* values, const std::size_t& n, const T& pivot)
+	{
+		if constexpr (not L::vectorized)
+			return _partition_scalar<OrEqual>(keys, values, n, pivot);
+		else
+		{
+			constexpr std::size_t W{ L::width };
+			constexpr bool _kv{ not std::is_void_v<V> };
+			if (n < 4 * W) return _partition_scalar<OrEqual>(keys, values, n, pivot);
+
+			using type = typename L::type;
+			const type _pivot{ L::set1(pivot) };
+			std::size_t _wl{0}, _wr{n};
+
+			// Permute the selected lanes first and store the register at both ends
+			auto _store = [&](const type& k, const type& v)
+			{
+				const unsigned _m{ L::movemask(OrEqual ? L::le(k, _pivot) : L::lt(k, _pivot)) };
+				const auto _idx{ L::perm_index(_m) };
+				const type _pk{ L::permute(k, _idx) };
+				L::storeu(keys + _wl, _pk);
+				L::storeu(keys + _wr - W, _pk);
+				if constexpr (_kv)
+				{
+					const type _pv{ L::permute(v, _idx) };
+					L::storeu(values + _wl, _pv);
+					L::storeu(values + _wr - W, _pv);
+				}
+				const std::size_t _c{ static_cast<std::size_t>(_popcount(_m)) };
+				_wl += _c;
+				_wr -= W - _c;
+			};
+			auto _load_values = [&](const std::size_t& i) { if constexpr (_kv) return L::loadu(values + i); else return type{}; };
+
+			const type _saved_lk{ L::loadu(keys) }, _saved_lv{ _load_values(0) };
+			const type _saved_rk{ L::loadu(keys + n - W) }, _saved_rv{ _load_values(n - W) };
+			std::size_t _l{W}, _r{n - W};
+			while (_r - _l >= W)
+			{
+				if (_l - _wl <= _wr - _r)
+				{
+					_store(L::loadu(keys + _l), _load_values(_l));
+					_l += W;
+				}
+				else
+				{
+					_r -= W;
+					_store(L::loadu(keys + _r), _load_values(_r));
+				}
+			}
+
+			// The unread tail and the right register go element by element, once the left one is stored
+			alignas(64) T _tk[2 * W];
+			alignas(64) std::uint32_t _tv[2 * W];
+			const std::size_t _t{ _r - _l };
+			std::copy(keys + _l, keys + _r, _tk);
+			L::storeu(_tk + _t, _saved_rk);
+			if constexpr (_kv)
+			{
+				std::memcpy(_tv, values + _l, _t * sizeof(V));
+				L::storeu(_tv + _t, _saved_rv);
+			}
+			_store(_saved_lk, _saved_lv);
+			for (std::size_t i{0}; i < _t + W; i++)
+			{
+				const std::size_t _dst{ (OrEqual ? not (pivot < _tk[i]) : _tk[i] < pivot) ? _wl++ : --_wr };
+				keys[_dst] = _tk[i];
+				if constexpr (_kv) std::memcpy(values + _dst, _tv + i, sizeof(V));
+			}
+			return _wl;
+		}
+	}
+
+	template <typename T>
+	inline T _median3(const T& a, const T& b, const T& c)
+	{
+		return std::max(std::min(a, b), std::min(std::max(a, b), c));
+	}
+
+	// Quicksort with network-sorted leaves; past `depth` levels of recursion the rest is sorted by `std::sort`
+	template <typename L, typename T, typename V>
+	inline void _sort(T* keys, V* values, std::size_t n, std::size_t depth)
+	{
+		while (n > sort_small_max)
+		{
+			if (0 == depth--)
+			{
+				if constexpr (std::is_void_v<V>)
+					std::sort(keys, keys + n);
+				else
+				{
+					std::vector<std::pair<T, V>> _pairs(n);
+					for (std::size_t i{0}; i < n; i++) _pairs[i] = { keys[i], values[i] };
+					std::sort(_pairs.begin(), _pairs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+					for (std::size_t i{0}; i < n; i++) { keys[i] = _pairs[i].first; values[i] = _pairs[i].second; }
+				}
+				return;
+			}
+
+			const T _pivot{ _median3(keys[0], keys[n / 2], keys[n - 1]) };
+			std::size_t _c{ _partition<L, false>(keys, values, n, _pivot) };
+			if (0 == _c)
+			{
+				// Nothing is smaller than the pivot: split off the elements equal to it, which are in place
+				_c = _partition<L, true>(keys, values, n, _pivot);
+				keys += _c;
+				if constexpr (not std::is_void_v<V>) values += _c;
+				n -= _c;
+				continue;
+			}
+
+			// Recurse into the smaller part, iterate over the larger one
+			if (_c < n - _c)
+			{
+				_sort<L>(keys, values, _c, depth);
+				keys += _c;
+				if constexpr (not std::is_void_v<V>) values += _c;
+				n -= _c;
+			}
+			else
+			{
+				if constexpr (std::is_void_v<V>) _sort<L>(keys + _c, values, n - _c, depth);
+				else _sort<L>(keys + _c, values + _c, n - _c, depth);
+				n = _c;
+			}
+		}
+		_sort_small<L>(keys, values, n);
+	}
+
+	template <typename V>
+	constexpr bool _is_sort_value(void)
+	{
+		if constexpr (std::is_void_v<V>) return true;
+		else return sizeof(V) == 4 and std::is_trivially_copyable_v<V>;
+	}
+
+	template <typename T, typename V>
+	constexpr bool _is_sortable_v = (std::is_same_v<T, std::int32_t> or std::is_same_v<T, float>) and _is_sort_value<V>();
+
+	inline std::size_t _max_depth(std::size_t n)
+	{
+		std::size_t _d{0};
+		for (; n > 1; n >>= 1) _d += 2;
+		return _d;
+	}
+}	// namespace internal
+
+/// @brief Sort at most `sort_small_max` keys with a bitonic network
+/// @details Longer arrays fall back to `sort()`
+template <typename ISA, typename T>
+inline void sort_small(ISA, T* keys, const std::size_t& n)
+{
+	static_assert(internal::_is_sortable_v<T, void>, "function sort_small(): keys must be std::int32_t or float.\n");
+	if (n > sort_small_max)
+		internal::_sort<internal::_sort_lanes<T, ISA>, T, void>(keys, nullptr, n, internal::_max_depth(n));
+	else
+		internal::_sort_small<internal::_sort_lanes<T, ISA>, T, void>(keys, nullptr, n);
+}
+
+/// @brief Sort at most `sort_small_max` keys with a bitonic network, permuting the 32-bit `values` along
+/// @details Longer arrays fall back to `sort()`
+template <typename ISA, typename T, typename V>
+inline void sort_small(ISA, T* keys, V* values, const std::size_t& n)
+{
+	static_assert(internal::_is_sortable_v<T, V>, "function sort_small(): keys must be std::int32_t or float, values 32-bit wide.\n");
+	if (n > sort_small_max)
+		internal::_sort<internal::_sort_lanes<T, ISA>>(keys, values, n, internal::_max_depth(n));
+	else
+		internal::_sort_small<internal::_sort_lanes<T, ISA>>(keys, values, n);
+}
+
+/// @brief Partition `keys` around `pivot`: the keys smaller than it come first
+/// @return The number of keys smaller than `pivot`
+template <typename ISA, typename T>
+inline std::size_t partition(ISA, T* keys, const std::size_t& n, const T& pivot)
+{
+	static_assert(internal::_is_sortable_v<T, void>, "function partition(): keys must be std::int32_t or float.\n");
+	return internal::_partition<internal::_sort_lanes<T, ISA>, false, T, void>(keys, nullptr, n, pivot);
+}
+
+/// @brief Partition `keys` around `pivot`, permuting the 32-bit `values` along
+template <typename ISA, typename T, typename V>
+inline std::size_t partition(ISA, T* keys, V* values, const std::size_t& n, const T& pivot)
+{
+	static_assert(internal::_is_sortable_v<T, V>, "function partition(): keys must be std::int32_t or float, values 32-bit wide.\n");
+	return internal::_partition<internal::_sort_lanes<T, ISA>, false>(keys, values, n, pivot);
+}
+
+/// @brief Sort `n` keys
+template <typename ISA, typename T>
+inline void sort(ISA, T* keys, const std::size_t& n)
+{
+	static_assert(internal::_is_sortable_v<T, void>, "function sort(): keys must be std::int32_t or float.\n");
+	internal::_sort<internal::_sort_lanes<T, ISA>, T, void>(keys, nullptr, n, internal::_max_depth(n));
+}
+
+/// @brief Sort `n` keys, permuting the 32-bit `values` along
+template <typename ISA, typename T, typename V>
+inline void sort(ISA, T* keys, V* values, const std::size_t& n)
+{
+	static_assert(internal::_is_sortable_v<T, V>, "function sort(): keys must be std::int32_t or float, values 32-bit wide.\n");
+	internal::_sort<internal::_sort_lanes<T, ISA>>(keys, values, n, internal::_max_depth(n));
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename T>
+inline void sort_small(T* keys, const std::size_t& n) { sort_small(native{}, keys, n); }
+template <typename T, typename V>
+inline void sort_small(T* keys, V* values, const std::size_t& n) { sort_small(native{}, keys, values, n); }
+template <typename T>
+inline std::size_t partition(T* keys, const std::size_t& n, const T& pivot) { return partition(native{}, keys, n, pivot); }
+template <typename T, typename V>
+inline std::size_t partition(T* keys, V* values, const std::size_t& n, const T& pivot) { return partition(native{}, keys, values, n, pivot); }
+template <typename T>
+inline void sort(T* keys, const std::size_t& n) { sort(native{}, keys, n); }
+template <typename T, typename V>
+inline void sort(T* keys, V* values, const std::size_t& n) { sort(native{}, keys, values, n); }
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_SORT
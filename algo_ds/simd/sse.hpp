@@ -1,17 +1,19 @@
 #ifndef FCPUT_ALGODS_SIMD_SSE
 #define FCPUT_ALGODS_SIMD_SSE
 
-#include <immintrin.h>
-
 #include "algo_ds/common/common.hpp"
 #include "common_simd.hpp"
 
+#if FCPUT_SIMD_SSE2
+
+#include <immintrin.h>
+
 FCP_NAMESPACE_BEGIN
 FCP_NAMESPACE_ALGODS_BEGIN
 FCP_NAMESPACE_SIMD_BEGIN
 
 /// @brief Compute dot product of four vectors passed to the function via four vectors of the components along a single axis each
-inline FCPUT_CPP14_CONSTEXPR __m128 dot(
+inline __m128 dot(
 		const __m128& ax, const __m128& ay, const __m128& az, const __m128& aw,
 	 	const __m128& bx, const __m128& by, const __m128& bz, const __m128& bw
 		)
@@ -25,10 +27,122 @@ inline FCPUT_CPP14_CONSTEXPR __m128 dot(
 	__m128 _s2 = _mm_add_ps(_dz, _dw);
 
 	return _mm_add_ps(_s1, _s2);
-}	
+}
+
+/// @brief Compute dot product of four three-dimensional vectors passed to the function via three vectors of the components along a single axis each
+inline __m128 dot(
+		const __m128& ax, const __m128& ay, const __m128& az,
+	 	const __m128& bx, const __m128& by, const __m128& bz
+		)
+{
+	__m128 _dx = _mm_mul_ps(ax, bx);
+	__m128 _dy = _mm_mul_ps(ay, by);
+	__m128 _dz = _mm_mul_ps(az, bz);
+
+	return _mm_add_ps(_mm_add_ps(_dx, _dy), _dz);
+}
+
+template <>
+struct pack<float, sse>
+{
+	using type = __m128;
+	using scalar_type = float;
+	constexpr static std::size_t width = 4;
+	constexpr static std::size_t alignment = 16;
+
+	// Initialization
+	static inline type zero(void) { return _mm_setzero_ps(); }
+	static inline type set1(const float& s) { return _mm_set1_ps(s); }
+
+	// Loading/storing operations
+	static inline type load(const float* p) { return _mm_load_ps(p); }
+	static inline type loadu(const float* p) { return _mm_loadu_ps(p); }
+	static inline void store(float* p, const type& v) { _mm_store_ps(p, v); }
+	static inline void storeu(float* p, const type& v) { _mm_storeu_ps(p, v); }
+
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return _mm_add_ps(a, b); }
+	static inline type sub(const type& a, const type& b) { return _mm_sub_ps(a, b); }
+	static inline type mul(const type& a, const type& b) { return _mm_mul_ps(a, b); }
+	static inline type div(const type& a, const type& b) { return _mm_div_ps(a, b); }
+	static inline type fmadd(const type& a, const type& b, const type& c)
+	{
+#if FCPUT_SIMD_FMA
+		return _mm_fmadd_ps(a, b, c);
+#else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+	}
+	static inline type sqrt(const type& a) { return _mm_sqrt_ps(a); }
+	static inline type min(const type& a, const type& b) { return _mm_min_ps(a, b); }
+	static inline type max(const type& a, const type& b) { return _mm_max_ps(a, b); }
+
+	// Horizontal operations
+	static inline float reduce_add(const type& v)
+	{
+		__m128 _s = _mm_add_ps(v, _mm_movehl_ps(v, v));	// (0+2, 1+3, ...)
+		_s = _mm_add_ss(_s, _mm_shuffle_ps(_s, _s, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(_s);
+	}
+	static inline float reduce_min(const type& v)
+	{
+		__m128 _s = _mm_min_ps(v, _mm_movehl_ps(v, v));
+		_s = _mm_min_ss(_s, _mm_shuffle_ps(_s, _s, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(_s);
+	}
+	static inline float reduce_max(const type& v)
+	{
+		__m128 _s = _mm_max_ps(v, _mm_movehl_ps(v, v));
+		_s = _mm_max_ss(_s, _mm_shuffle_ps(_s, _s, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(_s);
+	}
+};
+
+template <>
+struct pack<double, sse>
+{
+	using type = __m128d;
+	using scalar_type = double;
+	constexpr static std::size_t width = 2;
+	constexpr static std::size_t alignment = 16;
+
+	// Initialization
+	static inline type zero(void) { return _mm_setzero_pd(); }
+	static inline type set1(const double& s) { return _mm_set1_pd(s); }
+
+	// Loading/storing operations
+	static inline type load(const double* p) { return _mm_load_pd(p); }
+	static inline type loadu(const double* p) { return _mm_loadu_pd(p); }
+	static inline void store(double* p, const type& v) { _mm_store_pd(p, v); }
+	static inline void storeu(double* p, const type& v) { _mm_storeu_pd(p, v); }
+
+	// Arithmetic
+	static inline type add(const type& a, const type& b) { return _mm_add_pd(a, b); }
+	static inline type sub(const type& a, const type& b) { return _mm_sub_pd(a, b); }
+	static inline type mul(const type& a, const type& b) { return _mm_mul_pd(a, b); }
+	static inline type div(const type& a, const type& b) { return _mm_div_pd(a, b); }
+	static inline type fmadd(const type& a, const type& b, const type& c)
+	{
+#if FCPUT_SIMD_FMA
+		return _mm_fmadd_pd(a, b, c);
+#else
+		return _mm_add_pd(_mm_mul_pd(a, b), c);
+#endif
+	}
+	static inline type sqrt(const type& a) { return _mm_sqrt_pd(a); }
+	static inline type min(const type& a, const type& b) { return _mm_min_pd(a, b); }
+	static inline type max(const type& a, const type& b) { return _mm_max_pd(a, b); }
+
+	// Horizontal operations
+	static inline double reduce_add(const type& v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+	static inline double reduce_min(const type& v) { return _mm_cvtsd_f64(_mm_min_sd(v, _mm_unpackhi_pd(v, v))); }
+	static inline double reduce_max(const type& v) { return _mm_cvtsd_f64(_mm_max_sd(v, _mm_unpackhi_pd(v, v))); }
+};
 
 FCP_NAMESPACE_SIMD_END
 FCP_NAMESPACE_ALGODS_END
 FCP_NAMESPACE_END
 
+#endif	// FCPUT_SIMD_SSE2
+
 #endif	// FCPUT_ALGODS_SIMD_SSE
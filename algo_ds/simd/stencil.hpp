@@ -0,0 +1,225 @@
+#ifndef FCPUT_ALGODS_SIMD_STENCIL
+#define FCPUT_ALGODS_SIMD_STENCIL
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <utility>
+
+/* Sliding-window dot products (one-dimensional stencils) over contiguous arrays.
+ *
+ * Each output register is the sum over the stencil points of a broadcast coefficient times the
+ * input register starting at that point, so every input element is loaded (unaligned) once per
+ * coefficient and never gathered. `internal::_stencil_registers` output registers are computed
+ * together, sharing the broadcast of each coefficient and hiding the latency of the FMAs.
+ *
+ * The variable stencils have different coefficients at each output, stored by rows (one per stencil
+ * point, `stride` apart) so that the coefficients of consecutive outputs are loaded as registers too.
+ *
+ * The linear combinations take one input array per coefficient, so the points of a stencil may lie
+ * anywhere (e.g. in other lines and planes of a multi-dimensional field, or in other fields).
+ *
+ * The batched stencils apply one stencil, of a size known at compile time, to many arrays at once
+ * (e.g. all the fields sampled on a grid), keeping its broadcast coefficients in registers.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+namespace internal
+{
+	// Output registers computed together by the stencils
+	constexpr std::size_t _stencil_registers{ 8 };
+
+	// `sizeof...(R)` consecutive output registers; the accumulators are unrolled so that they stay in registers
+	template <typename P, bool Aligned, typename T, std::size_t... R>
+	inline void _stencil_block(const T* in, const T* coeff, const std::size_t& m, T* out, std::index_sequence<R...>)
+	{
+		typename P::type _acc[sizeof...(R)]{ (static_cast<void>(R), P::zero())... };
+		for (std::size_t k{0}; k < m; k++)
+		{
+			const typename P::type _c{ P::set1(coeff[k]) };
+			((_acc[R] = P::fmadd(_c, P::loadu(in + k + R * P::width), _acc[R])), ...);
+		}
+		(_store<P, Aligned>(out + R * P::width, _acc[R]), ...);
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _stencil(const T* in, const T* coeff, const std::size_t& m, T* out, const std::size_t& n)
+	{
+		constexpr std::size_t _step{ _stencil_registers * P::width };
+		std::size_t i{0};
+		for (; i + _step <= n; i += _step)
+			_stencil_block<P, Aligned>(in + i, coeff, m, out + i, std::make_index_sequence<_stencil_registers>());
+		for (; i + P::width <= n; i += P::width)
+			_stencil_block<P, Aligned>(in + i, coeff, m, out + i, std::index_sequence<0>());
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T, std::size_t... R>
+	inline void _variable_stencil_block(const T* in, const T* coeff, const std::size_t& stride, const std::size_t& m, T* out,
+																			std::index_sequence<R...>)
+	{
+		typename P::type _acc[sizeof...(R)]{ (static_cast<void>(R), P::zero())... };
+		for (std::size_t k{0}; k < m; k++)
+			((_acc[R] = P::fmadd(P::loadu(coeff + k * stride + R * P::width), P::loadu(in + k + R * P::width), _acc[R])), ...);
+		(_store<P, Aligned>(out + R * P::width, _acc[R]), ...);
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _variable_stencil(const T* in, const T* coeff, const std::size_t& stride, const std::size_t& m, T* out, const std::size_t& n)
+	{
+		constexpr std::size_t _step{ _stencil_registers * P::width };
+		std::size_t i{0};
+		for (; i + _step <= n; i += _step)
+			_variable_stencil_block<P, Aligned>(in + i, coeff + i, stride, m, out + i, std::make_index_sequence<_stencil_registers>());
+		for (; i + P::width <= n; i += P::width)
+			_variable_stencil_block<P, Aligned>(in + i, coeff + i, stride, m, out + i, std::index_sequence<0>());
+		return i;
+	}
+
+	template <typename P, bool Aligned, typename T, std::size_t... R>
+	inline void _combination_block(const T* const* in, const T* coeff, const std::size_t& m, const std::size_t& i, T* out,
+																 std::index_sequence<R...>)
+	{
+		typename P::type _acc[sizeof...(R)]{ (static_cast<void>(R), P::zero())... };
+		for (std::size_t k{0}; k < m; k++)
+		{
+			const typename P::type _c{ P::set1(coeff[k]) };
+			((_acc[R] = P::fmadd(_c, P::loadu(in[k] + i + R * P::width), _acc[R])), ...);
+		}
+		(_store<P, Aligned>(out + i + R * P::width, _acc[R]), ...);
+	}
+
+	template <typename P, bool Aligned, typename T>
+	inline std::size_t _combination(const T* const* in, const T* coeff, const std::size_t& m, T* out, std::size_t i, const std::size_t& n)
+	{
+		constexpr std::size_t _step{ _stencil_registers * P::width };
+		for (; i + _step <= n; i += _step)
+			_combination_block<P, Aligned>(in, coeff, m, i, out, std::make_index_sequence<_stencil_registers>());
+		// Short arrays (the lines of a small grid) would otherwise be left to a single chain of dependent fmadds
+		for (; i + _step / 2 <= n; i += _step / 2)
+			_combination_block<P, Aligned>(in, coeff, m, i, out, std::make_index_sequence<_stencil_registers / 2>());
+		for (; i + P::width <= n; i += P::width)
+			_combination_block<P, Aligned>(in, coeff, m, i, out, std::index_sequence<0>());
+		return i;
+	}
+
+	// Stencil of `M` points whose broadcast coefficients `c` are loaded once for all the arrays of a batch
+	template <typename P, bool Aligned, std::size_t M, typename T, std::size_t... R>
+	inline void _batched_block(const T* in, const typename P::type (&c)[M], T* out, std::index_sequence<R...>)
+	{
+		typename P::type _acc[sizeof...(R)]{ (static_cast<void>(R), P::zero())... };
+		for (std::size_t k{0}; k < M; k++)
+			((_acc[R] = P::fmadd(c[k], P::loadu(in + k + R * P::width), _acc[R])), ...);
+		(_store<P, Aligned>(out + R * P::width, _acc[R]), ...);
+	}
+
+	template <typename P, bool Aligned, std::size_t M, typename T>
+	inline std::size_t _batched_stencil(const T* in, const typename P::type (&c)[M], T* out, const std::size_t& n)
+	{
+		constexpr std::size_t _step{ _stencil_registers * P::width };
+		std::size_t i{0};
+		for (; i + _step <= n; i += _step)
+			_batched_block<P, Aligned>(in + i, c, out + i, std::make_index_sequence<_stencil_registers>());
+		for (; i + P::width <= n; i += P::width)
+			_batched_block<P, Aligned>(in + i, c, out + i, std::index_sequence<0>());
+		return i;
+	}
+}	// namespace internal
+
+/// @brief Apply the stencil `coeff` of `m` points: `out[i] = coeff[0]*in[i] + ... + coeff[m-1]*in[i+m-1]` for i in [0, n)
+/// @details `in` holds `n + m - 1` elements; `out` must not overlap it
+template <typename ISA, typename T>
+inline void stencil(ISA, const T* in, const T* coeff, const std::size_t& m, T* out, const std::size_t& n)
+{
+	using _P = pack<T, ISA>;
+	const std::size_t i{ internal::_is_aligned<_P>(out) ? internal::_stencil<_P, true>(in, coeff, m, out, n)
+	                                                    : internal::_stencil<_P, false>(in, coeff, m, out, n) };
+	internal::_stencil<pack<T, scalar>, false>(in + i, coeff, m, out + i, n - i);
+}
+
+/// @brief Apply a stencil of `m` points with different coefficients at each output:
+/// `out[i] = coeff[i]*in[i] + coeff[stride + i]*in[i+1] + ... + coeff[(m-1)*stride + i]*in[i+m-1]` for i in [0, n)
+/// @details `in` holds `n + m - 1` elements and each of the `m` rows of `coeff` at least `n`; `out` must overlap neither
+template <typename ISA, typename T>
+inline void variable_stencil(ISA, const T* in, const T* coeff, const std::size_t& stride, const std::size_t& m, T* out, const std::size_t& n)
+{
+	using _P = pack<T, ISA>;
+	const std::size_t i{ internal::_is_aligned<_P>(out) ? internal::_variable_stencil<_P, true>(in, coeff, stride, m, out, n)
+	                                                    : internal::_variable_stencil<_P, false>(in, coeff, stride, m, out, n) };
+	internal::_variable_stencil<pack<T, scalar>, false>(in + i, coeff + i, stride, m, out + i, n - i);
+}
+
+/// @brief Linear combination of `m` arrays: `out[i] = coeff[0]*in[0][i] + ... + coeff[m-1]*in[m-1][i]` for i in [0, n)
+/// @details `out` must not overlap any input
+template <typename ISA, typename T>
+inline void linear_combination(ISA, const T* const* in, const T* coeff, const std::size_t& m, T* out, const std::size_t& n)
+{
+	using _P = pack<T, ISA>;
+	const std::size_t i{ internal::_is_aligned<_P>(out) ? internal::_combination<_P, true>(in, coeff, m, out, 0, n)
+	                                                    : internal::_combination<_P, false>(in, coeff, m, out, 0, n) };
+	internal::_combination<pack<T, scalar>, false>(in, coeff, m, out, i, n);
+}
+
+/// @brief Apply the same stencil of `M` points to a batch of `batch` arrays:
+/// `out[b*out_stride + i] = coeff[0]*in[b*in_stride + i] + ... + coeff[M-1]*in[b*in_stride + i+M-1]` for i in [0, n)
+/// @details The coefficients are broadcast once and stay in registers while all the arrays stream through. Each input
+/// array holds `n + M - 1` elements; the outputs must not overlap the inputs
+template <std::size_t M, typename ISA, typename T>
+inline void batched_stencil(ISA, const T* in, const std::size_t& in_stride, const T* coeff, T* out, const std::size_t& out_stride,
+														const std::size_t& n, const std::size_t& batch)
+{
+	using _P = pack<T, ISA>;
+	using _S = pack<T, scalar>;
+	typename _P::type _c[M];
+	typename _S::type _cs[M];
+	for (std::size_t k{0}; k < M; k++)
+	{
+		_c[k] = _P::set1(coeff[k]);
+		_cs[k] = _S::set1(coeff[k]);
+	}
+	for (std::size_t b{0}; b < batch; b++)
+	{
+		const T* _in{ in + b * in_stride };
+		T* _out{ out + b * out_stride };
+		const std::size_t i{ internal::_is_aligned<_P>(_out) ? internal::_batched_stencil<_P, true>(_in, _c, _out, n)
+		                                                     : internal::_batched_stencil<_P, false>(_in, _c, _out, n) };
+		internal::_batched_stencil<_S, false>(_in + i, _cs, _out + i, n - i);
+	}
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename T>
+inline void stencil(const T* in, const T* coeff, const std::size_t& m, T* out, const std::size_t& n) { stencil(native{}, in, coeff, m, out, n); }
+
+template <typename T>
+inline void variable_stencil(const T* in, const T* coeff, const std::size_t& stride, const std::size_t& m, T* out, const std::size_t& n)
+{
+	variable_stencil(native{}, in, coeff, stride, m, out, n);
+}
+
+template <typename T>
+inline void linear_combination(const T* const* in, const T* coeff, const std::size_t& m, T* out, const std::size_t& n)
+{
+	linear_combination(native{}, in, coeff, m, out, n);
+}
+
+template <std::size_t M, typename T>
+inline void batched_stencil(const T* in, const std::size_t& in_stride, const T* coeff, T* out, const std::size_t& out_stride, const std::size_t& n,
+														const std::size_t& batch)
+{
+	batched_stencil<M>(native{}, in, in_stride, coeff, out, out_stride, n, batch);
+}
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_STENCIL
@@ -0,0 +1,170 @@
+/*
+ * gather.cpp -- Gather/scatter correctness check and benchmark against scalar indexed loads
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+#include "algo_ds/simd/gather.hpp"
+
+#define REPETITIONS 20
+
+namespace simd = fcp::algods::simd;
+
+// Index patterns
+enum class pattern { SEQUENTIAL, STENCIL, RANDOM };
+
+std::vector<std::int32_t> make_indices(const pattern& p, const std::size_t& n, const std::size_t& table_size, std::mt19937& rng)
+{
+	std::vector<std::int32_t> idx(n);
+	std::uniform_int_distribution<std::int32_t> any(0, table_size - 1), near(-3, 3);
+	for (std::size_t i{0}; i < n; i++)
+	{
+		const std::int64_t _base{ static_cast<std::int64_t>(i % table_size) };
+		switch (p)
+		{
+			case pattern::SEQUENTIAL: idx[i] = _base; break;
+			// Neighbours of the current point, like the stencil of an unstructured mesh
+			case pattern::STENCIL: idx[i] = std::min<std::int64_t>(table_size - 1, std::max<std::int64_t>(0, _base + near(rng))); break;
+			case pattern::RANDOM: idx[i] = any(rng); break;
+		}
+	}
+	return idx;
+}
+
+// Operations timed, the masked ones skip every third element
+enum class operation { GATHER, MASKED_GATHER, SCATTER, MASKED_SCATTER };
+
+// Time `REPETITIONS` runs of `op` and return the throughput in million elements per second
+template <typename ISA, typename T>
+double time_operation(const operation& op, std::vector<T>& table, const std::vector<std::int32_t>& idx, const bool* mask, std::vector<T>& values)
+{
+	const auto _start = std::chrono::steady_clock::now();
+	for (int r{0}; r < REPETITIONS; r++)
+		switch (op)
+		{
+			case operation::GATHER: simd::gather(ISA(), table.data(), idx.data(), values.data(), idx.size()); break;
+			case operation::MASKED_GATHER: simd::gather(ISA(), table.data(), idx.data(), mask, values.data(), idx.size()); break;
+			case operation::SCATTER: simd::scatter(ISA(), values.data(), idx.data(), table.data(), idx.size()); break;
+			case operation::MASKED_SCATTER: simd::scatter(ISA(), values.data(), idx.data(), mask, table.data(), idx.size()); break;
+		}
+	const std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+	return REPETITIONS * idx.size() / _elapsed.count() / 1e6;
+}
+
+template <typename ISA, typename T>
+bool check(const std::vector<T>& table, const std::vector<std::int32_t>& idx)
+{
+	std::vector<T> expected(idx.size()), result(idx.size());
+	std::unique_ptr<bool[]> mask(new bool[idx.size()]);
+	for (std::size_t i{0}; i < idx.size(); i++)
+		mask[i] = (i % 3) != 0;
+
+	// Plain and masked gather
+	for (std::size_t i{0}; i < idx.size(); i++)
+		expected[i] = table[idx[i]];
+	simd::gather(ISA(), table.data(), idx.data(), result.data(), idx.size());
+	if (expected != result) return false;
+	for (std::size_t i{0}; i < idx.size(); i++)
+		expected[i] = mask[i] ? table[idx[i]] : T{-1};
+	std::fill(result.begin(), result.end(), T{-1});
+	simd::gather(ISA(), table.data(), idx.data(), mask.get(), result.data(), idx.size());
+	if (expected != result) return false;
+
+	// Plain and masked scatter (the last write to a location wins)
+	std::vector<T> expected_table(table.size(), T{0}), result_table(table.size(), T{0});
+	for (std::size_t i{0}; i < idx.size(); i++)
+		expected_table[idx[i]] = static_cast<T>(i);
+	for (std::size_t i{0}; i < idx.size(); i++)
+		result[i] = static_cast<T>(i);
+	simd::scatter(ISA(), result.data(), idx.data(), result_table.data(), idx.size());
+	if (expected_table != result_table) return false;
+	std::fill(expected_table.begin(), expected_table.end(), T{0});
+	std::fill(result_table.begin(), result_table.end(), T{0});
+	for (std::size_t i{0}; i < idx.size(); i++)
+		if (mask[i]) expected_table[idx[i]] = static_cast<T>(i);
+	simd::scatter(ISA(), result.data(), idx.data(), mask.get(), result_table.data(), idx.size());
+	return expected_table == result_table;
+}
+
+// Benchmark every operation and return the number of ISAs failing the correctness check
+template <typename T>
+int run(const std::string_view& type_name)
+{
+	std::mt19937 rng(42);
+	constexpr std::size_t _n{ 1 << 20 };
+	std::unique_ptr<bool[]> mask(new bool[_n]);
+	for (std::size_t i{0}; i < _n; i++)
+		mask[i] = (i % 3) != 0;
+
+	std::cout << '\n' << type_name << " (Melements/s, " << REPETITIONS << " x " << _n << " elements)\n";
+	std::cout << std::left << std::setw(16) << "operation" << std::setw(12) << "table" << std::setw(12) << "pattern"
+						<< std::setw(12) << "scalar" << std::setw(12) << "sse" << std::setw(12) << "avx" << std::setw(12) << "avx512" << '\n';
+
+	// Table sizes fitting L1, L2 and only DRAM
+	for (const std::size_t _size : { std::size_t{1} << 10, std::size_t{1} << 15, std::size_t{1} << 24 })
+	{
+		std::vector<T> table(_size), values(_n);
+		for (std::size_t i{0}; i < _size; i++)
+			table[i] = static_cast<T>(i);
+
+		for (const auto& [_p, _name] : { std::pair{pattern::SEQUENTIAL, "sequential"}, std::pair{pattern::STENCIL, "stencil"}, std::pair{pattern::RANDOM, "random"} })
+		{
+			const auto idx = make_indices(_p, _n, _size, rng);
+			for (const auto& [_op, _op_name] : { std::pair{operation::GATHER, "gather"}, std::pair{operation::MASKED_GATHER, "masked gather"},
+																					 std::pair{operation::SCATTER, "scatter"}, std::pair{operation::MASKED_SCATTER, "masked scatter"} })
+			{
+				std::cout << std::setw(16) << _op_name << std::setw(12) << _size << std::setw(12) << _name << std::fixed << std::setprecision(1);
+				std::cout << std::setw(12) << time_operation<simd::scalar>(_op, table, idx, mask.get(), values);
+				std::cout << std::setw(12) << time_operation<simd::sse>(_op, table, idx, mask.get(), values);
+#if FCPUT_SIMD_AVX
+				std::cout << std::setw(12) << time_operation<simd::avx>(_op, table, idx, mask.get(), values);
+#else
+				std::cout << std::setw(12) << "-";
+#endif
+#if FCPUT_SIMD_AVX512F
+				std::cout << std::setw(12) << time_operation<simd::avx512>(_op, table, idx, mask.get(), values);
+#else
+				std::cout << std::setw(12) << "-";
+#endif
+				std::cout << '\n';
+			}
+		}
+	}
+
+	// Correctness (odd size to exercise the remainder loops, repeated indices for the scatters)
+	std::vector<T> values(1000);
+	for (std::size_t i{0}; i < values.size(); i++)
+		values[i] = static_cast<T>(3 * i);
+	const auto idx = make_indices(pattern::STENCIL, 1001, values.size(), rng);
+	int failures{0};
+	auto report = [&](const char* name, const bool& ok)
+	{
+		failures += ok ? 0 : 1;
+		std::cout << name << (ok ? "SUCCESS" : "FAILURE");
+	};
+	report("Correctness: sse ", check<simd::sse>(values, idx));
+#if FCPUT_SIMD_AVX
+	report(", avx ", check<simd::avx>(values, idx));
+#endif
+#if FCPUT_SIMD_AVX512F
+	report(", avx512 ", check<simd::avx512>(values, idx));
+#endif
+	std::cout << '\n';
+	return failures;
+}
+
+int main(void)
+{
+	int _failures{0};
+	_failures += run<float>("float");
+	_failures += run<double>("double");
+	return _failures;
+}
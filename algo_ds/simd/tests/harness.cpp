@@ -0,0 +1,473 @@
+/*
+ * harness.cpp -- Scalar-vs-SIMD equivalence and throughput of every kernel of algo_ds/simd
+ *
+ * Exits with the number of implementations whose error exceeds their tolerance.
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+#include "algo_ds/simd/geometry.hpp"
+#include "algo_ds/simd/reduce.hpp"
+#include "algo_ds/simd/scan.hpp"
+#include "algo_ds/simd/gather.hpp"
+#include "algo_ds/simd/mat4.hpp"
+#include "algo_ds/simd/half.hpp"
+#include "algo_ds/simd/sort.hpp"
+#include "algo_ds/simd/stencil.hpp"
+#include "algo_ds/simd/tridiagonal.hpp"
+
+namespace simd = fcp::algods::simd;
+
+// Error scale of a reduction: sum of the magnitudes of its terms
+template <typename T>
+void sum_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	double _s{0};
+	for (std::size_t i{0}; i < n; i++)
+		_s += std::abs(static_cast<double>(in[0][i]));
+	scale[0] = _s;
+}
+
+template <typename T>
+void dot_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	double _s{0};
+	for (std::size_t i{0}; i < n; i++)
+		_s += std::abs(static_cast<double>(in[0][i]) * in[1][i]);
+	scale[0] = _s;
+}
+
+// Error scale of a scan: running sum of the magnitudes
+template <typename T>
+void scan_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	double _s{0};
+	for (std::size_t i{0}; i < n; i++)
+		scale[i] = (_s += std::abs(static_cast<double>(in[0][i])));
+}
+
+// Error scale of a stencil: magnitude of its terms
+template <typename T>
+void stencil_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	for (std::size_t i{0}; i + 9 <= n; i++)
+	{
+		scale[i] = 0;
+		for (std::size_t k{0}; k < 9; k++)
+			scale[i] += 8 * std::abs(static_cast<double>(in[0][i + k]));
+	}
+}
+
+template <typename T>
+void variable_stencil_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	for (std::size_t i{0}; i + 3 <= n; i++)
+	{
+		scale[i] = 0;
+		for (std::size_t k{0}; k < 3; k++)
+			scale[i] += 8 * std::abs(static_cast<double>(in[0][i + k]) * in[1][i + k]);
+	}
+}
+
+template <typename T>
+void combination_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	for (std::size_t i{0}; i + 5 <= n; i++)
+	{
+		scale[i] = 0;
+		for (std::size_t k{0}; k < 5; k++)
+			scale[i] += 8 * std::abs(static_cast<double>(in[0][i + k]));
+	}
+}
+
+// Error scale of a tridiagonal solve over 16 interleaved systems: sum of the magnitudes of the right-hand side of the
+// system (the inverse of the diagonally dominant matrix used is bounded by 3)
+template <typename T>
+void tridiagonal_scale(const T* const* in, const std::size_t& n, double* scale)
+{
+	const std::size_t _rows{ n / 16 };
+	for (std::size_t l{0}; l < 16; l++)
+	{
+		double _s{0};
+		for (std::size_t i{0}; i < _rows; i++)
+			_s += 4 * std::abs(static_cast<double>(in[0][i * 16 + l]));
+		for (std::size_t i{0}; i < _rows; i++)
+			scale[i * 16 + l] = _s;
+	}
+}
+
+// A permutation of [0, n) mixing short and long jumps
+inline std::vector<std::int32_t> indices(const std::size_t& n)
+{
+	std::vector<std::int32_t> _idx(n);
+	for (std::size_t i{0}; i < n; i++)
+		_idx[i] = static_cast<std::int32_t>((i * 7 + n / 2) % n);
+	if (n % 7 == 0)
+		for (std::size_t i{0}; i < n; i++)
+			_idx[i] = static_cast<std::int32_t>(n - 1 - i);
+	return _idx;
+}
+
+// Distinct finite keys: the non-finite, zero and denormal inputs are replaced by their index, so that the
+// sorted order (and the one of the values following the keys) is unique
+inline void sort_keys(const float* in, float* keys, std::int32_t* values, const std::size_t& n)
+{
+	for (std::size_t i{0}; i < n; i++)
+	{
+		keys[i] = std::isnormal(in[i]) ? in[i] : static_cast<float>(i + 2);
+		values[i] = static_cast<std::int32_t>(i);
+	}
+}
+
+// Well-conditioned copy of a matrix: non-finite elements are zeroed and the diagonal is made dominant
+template <typename T>
+void conditioned(const T* m, T* out)
+{
+	for (std::size_t i{0}; i < 16; i++)
+		out[i] = std::isfinite(m[i]) ? m[i] : T{0};
+	for (std::size_t i{0}; i < 4; i++)
+		out[5*i] += 4;
+}
+
+template <typename T>
+void register_kernels(const double& tol)
+{
+	using harness::add;
+	using vec3 = simd::soa_vec3<const T>;
+	using vec4 = simd::soa_vec4<const T>;
+
+	// Geometry (every input array is one component)
+	add<T>("dot3", 6, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::dot(isa, vec3{in[0], in[1], in[2]}, vec3{in[3], in[4], in[5]}, out[0], n); });
+	add<T>("dot4", 8, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::dot(isa, vec4{in[0], in[1], in[2], in[3]}, vec4{in[4], in[5], in[6], in[7]}, out[0], n); });
+	add<T>("cross", 6, 3, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::cross(isa, vec3{in[0], in[1], in[2]}, vec3{in[3], in[4], in[5]}, simd::soa_vec3<T>{out[0], out[1], out[2]}, n); });
+	add<T>("length3", 3, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::length(isa, vec3{in[0], in[1], in[2]}, out[0], n); });
+	add<T>("length4", 4, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::length(isa, vec4{in[0], in[1], in[2], in[3]}, out[0], n); });
+	add<T>("normalize3", 3, 3, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::normalize(isa, vec3{in[0], in[1], in[2]}, simd::soa_vec3<T>{out[0], out[1], out[2]}, n); });
+	add<T>("normalize4", 4, 4, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::normalize(isa, vec4{in[0], in[1], in[2], in[3]}, simd::soa_vec4<T>{out[0], out[1], out[2], out[3]}, n); });
+	add<T>("distance3", 6, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::distance(isa, vec3{in[0], in[1], in[2]}, vec3{in[3], in[4], in[5]}, out[0], n); });
+	// Views of mutable components passed as inputs, without spelling out the template arguments
+	add<T>("length3 of normalize3", 3, 4, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+	{
+		const simd::soa_vec3<T> unit{out[0], out[1], out[2]};
+		simd::normalize(isa, vec3{in[0], in[1], in[2]}, unit, n);
+		simd::length(isa, unit, out[3], n);
+	});
+
+	// Reductions: the lanes reassociate the sum, so the error is relative to the sum of the magnitudes
+	add<T>("sum", 1, 1, true, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::sum(isa, in[0], n); }, sum_scale<T>);
+	add<T>("sum (kahan)", 1, 1, true, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::sum(isa, in[0], n, simd::kahan_summation()); }, sum_scale<T>);
+	add<T>("sum (neumaier)", 1, 1, true, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::sum(isa, in[0], n, simd::neumaier_summation()); }, sum_scale<T>);
+	add<T>("dot", 2, 1, true, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::dot(isa, in[0], in[1], n); }, dot_scale<T>);
+	add<T>("norm", 1, 1, true, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::norm(isa, in[0], n); });
+	add<T>("min", 1, 1, true, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::min(isa, in[0], n); });
+	add<T>("max", 1, 1, true, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::max(isa, in[0], n); });
+	add<T>("parallel_sum (2 threads)", 1, 1, true, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ out[0][0] = simd::parallel_sum(isa, in[0], n, simd::plain_summation(), 2); }, sum_scale<T>);
+
+	// Scans
+	add<T>("inclusive_scan", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::inclusive_scan(isa, in[0], out[0], n); }, scan_scale<T>);
+	add<T>("exclusive_scan", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::exclusive_scan(isa, in[0], out[0], n, T{1}); }, scan_scale<T>);
+
+	// Stencil: eighth-order central second derivative, over the first n - 8 outputs
+	add<T>("stencil (9 points)", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			const T _c[9] = { T(-1)/560, T(8)/315, T(-1)/5, T(8)/5, T(-205)/72, T(8)/5, T(-1)/5, T(8)/315, T(-1)/560 };
+			if (n >= 9)
+				simd::stencil(isa, in[0], _c, 9, out[0], n - 8);
+		}, stencil_scale<T>);
+	// Variable stencil: 3 points, the coefficient rows overlapping in the second input (stride 1)
+	add<T>("variable_stencil (3 points)", 2, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			if (n >= 3)
+				simd::variable_stencil(isa, in[0], in[1], 1, 3, out[0], n - 2);
+		}, variable_stencil_scale<T>);
+	// Linear combination: the 5-point Laplacian weights over five shifted views of the input
+	add<T>("linear_combination (5)", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			const T* _in[5] = { in[0], in[0] + 1, in[0] + 2, in[0] + 3, in[0] + 4 };
+			const T _c[5] = { T(-1)/12, T(4)/3, T(-5)/2, T(4)/3, T(-1)/12 };
+			if (n >= 5)
+				simd::linear_combination(isa, _in, _c, 5, out[0], n - 4);
+		}, combination_scale<T>);
+	// Batched stencil: the same 5-point weights over the input split into four consecutive arrays
+	add<T>("batched_stencil (5, x4)", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			const T _c[5] = { T(-1)/12, T(4)/3, T(-5)/2, T(4)/3, T(-1)/12 };
+			const std::size_t _len{ n / 4 };
+			if (_len >= 5)
+				simd::batched_stencil<5>(isa, in[0], _len, _c, out[0], _len, _len - 4, 4);
+		}, combination_scale<T>);
+
+	// Tridiagonal solve: 16 interleaved systems of the sixth-order compact first derivative matrix
+	add<T>("tridiagonal_solve (x16)", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			const std::size_t _rows{ n / 16 };
+			std::vector<T> _lower(_rows, T(1)/3), _diag(_rows, T(1)), _cp(_rows), _inv(_rows);
+			simd::tridiagonal_factor(_lower.data(), _diag.data(), _lower.data(), _cp.data(), _inv.data(), _rows);
+			std::copy(in[0], in[0] + _rows * 16, out[0]);
+			simd::tridiagonal_solve(isa, _lower.data(), _cp.data(), _inv.data(), out[0], _rows, 16, 16);
+		}, tridiagonal_scale<T>);
+
+	// Gather/scatter through a fixed permutation; the masked versions skip every third element
+	add<T>("gather", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			static thread_local std::vector<std::int32_t> _idx;
+			if (_idx.size() != n) _idx = indices(n);
+			simd::gather(isa, in[0], _idx.data(), out[0], n);
+		});
+	add<T>("gather (masked)", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			static thread_local std::vector<std::int32_t> _idx;
+			static thread_local std::unique_ptr<bool[]> _mask;
+			if (_idx.size() != n)
+			{
+				_idx = indices(n);
+				_mask.reset(new bool[n + 1]);
+				for (std::size_t i{0}; i < n; i++) _mask[i] = i % 3 != 0;
+			}
+			simd::gather(isa, in[0], _idx.data(), _mask.get(), out[0], n);
+		});
+	add<T>("scatter", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			static thread_local std::vector<std::int32_t> _idx;
+			if (_idx.size() != n) _idx = indices(n);
+			simd::scatter(isa, in[0], _idx.data(), out[0], n);
+		});
+
+	// 4x4 matrices: the arrays hold n/16 matrices or n/4 vectors
+	add<T>("mat4_mul", 2, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			for (std::size_t i{0}; i + 16 <= n; i += 16)
+				simd::mat4_mul(isa, in[0] + i, in[1] + i, out[0] + i);
+		});
+	add<T>("mat4_transpose", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			for (std::size_t i{0}; i + 16 <= n; i += 16)
+				simd::mat4_transpose(isa, in[0] + i, out[0] + i);
+		});
+	add<T>("mat4_inverse", 1, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			T _m[16];
+			for (std::size_t i{0}; i + 16 <= n; i += 16)
+			{
+				conditioned(in[0] + i, _m);
+				simd::mat4_inverse(isa, _m, out[0] + i);
+			}
+		});
+	add<T>("mat4_transform", 2, 1, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			if (n >= 16)
+				simd::mat4_transform(isa, in[0], in[1], out[0], n / 4);
+		});
+	add<T>("mat4_transform_points", 3, 3, false, tol, [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			const T _m[16] = { 0.5, 0.25, -1, 0, 2, 1, 0.125, 0, -0.75, 3, 1, 0, 10, -5, 0.5, 1 };
+			simd::mat4_transform_points(isa, _m, simd::soa_vec3<const T>{in[0], in[1], in[2]}, simd::soa_vec3<T>{out[0], out[1], out[2]}, n);
+		});
+
+	// 16-bit storage: round trip through the narrowing and widening conversions, which are exact w.r.t. the scalar ones
+	if constexpr (std::is_same_v<T, float>)
+	{
+		auto _round_trip = [](auto storage)
+		{
+			return [](auto isa, const float* const* in, float* const* out, const std::size_t& n)
+			{
+				std::vector<decltype(storage)> _s(n);
+				simd::convert(isa, in[0], _s.data(), n);
+				simd::convert(isa, _s.data(), out[0], n);
+			};
+		};
+		add<T>("half round trip", 1, 1, false, 0., _round_trip(simd::half()));
+		add<T>("bfloat16 round trip", 1, 1, false, 0., _round_trip(simd::bfloat16()));
+
+		// Sorts: the values carry the original positions, written out as floats
+		add<T>("sort", 1, 1, false, 0., [](auto isa, const float* const* in, float* const* out, const std::size_t& n)
+			{
+				std::vector<std::int32_t> _v(n);
+				sort_keys(in[0], out[0], _v.data(), n);
+				simd::sort(isa, out[0], n);
+			});
+		add<T>("sort (key-value)", 1, 2, false, 0., [](auto isa, const float* const* in, float* const* out, const std::size_t& n)
+			{
+				std::vector<std::int32_t> _v(n);
+				sort_keys(in[0], out[0], _v.data(), n);
+				simd::sort(isa, out[0], _v.data(), n);
+				std::copy(_v.begin(), _v.end(), out[1]);
+			});
+		// The sizes above sort_small_max (65 included) take the fallback to the general sort
+		add<T>("sort_small", 1, 1, false, 0., [](auto isa, const float* const* in, float* const* out, const std::size_t& n)
+			{
+				std::vector<std::int32_t> _v(n);
+				sort_keys(in[0], out[0], _v.data(), n);
+				simd::sort_small(isa, out[0], n);
+			});
+		add<T>("sort_small (key-value)", 1, 2, false, 0., [](auto isa, const float* const* in, float* const* out, const std::size_t& n)
+			{
+				std::vector<std::int32_t> _v(n);
+				sort_keys(in[0], out[0], _v.data(), n);
+				simd::sort_small(isa, out[0], _v.data(), n);
+				std::copy(_v.begin(), _v.end(), out[1]);
+			});
+	}
+}
+
+// Integer kernels, which must match the scalar reference exactly
+void register_integer_kernels(void)
+{
+	using harness::add;
+	using T = std::int32_t;
+
+	add<T>("inclusive_scan", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::inclusive_scan(isa, in[0], out[0], n); });
+	add<T>("exclusive_scan", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{ simd::exclusive_scan(isa, in[0], out[0], n, T{1}); });
+
+	// Sorts: the repeated keys are made distinct by their position for the key-value sort, whose values are the positions
+	add<T>("sort", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			std::copy(in[0], in[0] + n, out[0]);
+			simd::sort(isa, out[0], n);
+		});
+	add<T>("sort (key-value)", 1, 2, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			for (std::size_t i{0}; i < n; i++)
+			{
+				out[0][i] = in[0][i] * 2048 + static_cast<T>(i);
+				out[1][i] = static_cast<T>(i);
+			}
+			simd::sort(isa, out[0], out[1], n);
+		});
+	add<T>("sort_small", 1, 1, false, 0., [](auto isa, const T* const* in, T* const* out, const std::size_t& n)
+		{
+			std::copy(in[0], in[0] + n, out[0]);
+			simd::sort_small(isa, out[0], n);
+		});
+}
+
+// Scans of small integers, whose sums are exact in every type, against a serial reference: every ISA tag compiled in and
+// supported by the host (the int32 specializations included), and the parallel scans over several chunks, in place too
+template <typename T>
+int check_scans(const std::string_view& type_name)
+{
+	const std::size_t n{ 4 * simd::parallel_scan_min_chunk + 77 };
+	const T init{3};
+	std::mt19937 rng(11);
+	std::vector<T> in(n), inclusive(n), exclusive(n), out(n);
+	for (auto& _x : in)
+		_x = static_cast<T>(static_cast<int>(rng() % 21) - 10);
+	T total{init};
+	for (std::size_t i{0}; i < n; i++)
+	{
+		exclusive[i] = total;
+		total += in[i];
+		inclusive[i] = total;
+	}
+
+	int failures{0};
+	auto check = [&](const std::string& name, const bool& ok)
+	{
+		failures += ok ? 0 : 1;
+		std::cout << std::left << std::setw(56) << name << std::setw(9) << type_name << (ok ? "SUCCESS" : "FAILURE") << '\n';
+	};
+	auto scans = [&](auto isa)
+	{
+		using ISA = decltype(isa);
+		if constexpr (simd::is_supported_v<ISA>)
+		{
+			if (not simd::is_host_supported<ISA>()) return;
+			const std::string name{ harness::isa_name<ISA> };
+			bool ok{ total == simd::inclusive_scan(isa, in.data(), out.data(), n, init) and out == inclusive };
+			check("inclusive_scan (" + name + ")", ok);
+			ok = total == simd::exclusive_scan(isa, in.data(), out.data(), n, init) and out == exclusive;
+			check("exclusive_scan (" + name + ")", ok);
+			for (const std::size_t threads : { 1, 2, 4 })
+			{
+				const std::string suffix{ " (" + name + ", " + std::to_string(threads) + " threads)" };
+				ok = total == simd::parallel_inclusive_scan(isa, in.data(), out.data(), n, init, threads) and out == inclusive;
+				check("parallel_inclusive_scan" + suffix, ok);
+				out = in;
+				ok = total == simd::parallel_exclusive_scan(isa, out.data(), out.data(), n, init, threads) and out == exclusive;
+				check("parallel_exclusive_scan, in place" + suffix, ok);
+			}
+		}
+	};
+	scans(simd::scalar());
+	scans(simd::sse());
+	scans(simd::avx());
+	scans(simd::avx512());
+	return failures;
+}
+
+// The parallel reductions combine blocks of a fixed size in a fixed order, so their results must be the same bit for bit
+// whatever the number of threads: checked on inputs of several blocks, with a partial last one
+template <typename T>
+int check_parallel_determinism(const std::string_view& type_name)
+{
+	const std::size_t n{ 5 * simd::parallel_reduce_block + 123 };
+	std::mt19937 rng(7);
+	harness::buffer<T> a(n, 0), b(n, 0);
+	harness::fill(a, n, harness::input_kind::RANDOM, rng);
+	harness::fill(b, n, harness::input_kind::RANDOM, rng);
+
+	int failures{0};
+	auto check = [&](const std::string& name, const auto& f)
+	{
+		const T one{ f(1) }, two{ f(2) }, four{ f(4) };
+		const bool ok{ 0 == std::memcmp(&one, &two, sizeof(T)) and 0 == std::memcmp(&one, &four, sizeof(T)) };
+		failures += ok ? 0 : 1;
+		std::cout << std::left << std::setw(44) << name + " (1/2/4 threads)" << std::setw(9) << type_name
+							<< (ok ? "SUCCESS" : "FAILURE") << '\n';
+	};
+	check("parallel_sum", [&](const std::size_t& t) { return simd::parallel_sum(simd::native{}, a.data(), n, simd::plain_summation(), t); });
+	check("parallel_sum (kahan)", [&](const std::size_t& t) { return simd::parallel_sum(simd::native{}, a.data(), n, simd::kahan_summation(), t); });
+	check("parallel_dot", [&](const std::size_t& t) { return simd::parallel_dot(simd::native{}, a.data(), b.data(), n, simd::plain_summation(), t); });
+	check("parallel_norm (neumaier)", [&](const std::size_t& t) { return simd::parallel_norm(simd::native{}, a.data(), n, simd::neumaier_summation(), t); });
+	return failures;
+}
+
+int main(void)
+{
+	register_kernels<float>(1e-5);
+	register_kernels<double>(1e-13);
+	register_integer_kernels();
+
+	int _failures{0};
+	_failures += harness::run_all<float>("float");
+	_failures += harness::run_all<double>("double");
+	_failures += harness::run_all<std::int32_t>("int32");
+
+	std::cout << '\n';
+	_failures += check_parallel_determinism<float>("float");
+	_failures += check_parallel_determinism<double>("double");
+	_failures += check_scans<std::int32_t>("int32");
+	_failures += check_scans<float>("float");
+	_failures += check_scans<double>("double");
+
+	std::cout << '\n' << (0 == _failures ? "SUCCESS" : "FAILURE") << ": " << _failures << " implementation(s) out of tolerance\n";
+	return _failures;
+}
@@ -0,0 +1,283 @@
+/*
+ * harness.hpp -- Scalar-vs-SIMD equivalence and throughput harness
+ *
+ * Every kernel implementation is registered once per ISA tag compiled in. For each kernel the
+ * implementation of the `scalar` tag is the reference: every other one, when the host supports
+ * it, runs on the same randomized and edge-case inputs (NaN, infinities, signed zeros, denormals,
+ * or large magnitudes for integers) for many sizes (to exercise the remainder loops) and with misaligned arrays, and its largest
+ * error is compared with the tolerance stated at registration. Throughput is measured on an
+ * L2-sized input and reported next to the accuracy, together with the speedup over the reference.
+ */
+
+#ifndef FCPUT_ALGODS_SIMD_TESTS_HARNESS
+#define FCPUT_ALGODS_SIMD_TESTS_HARNESS
+
+#include "algo_ds/simd/common_simd.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <random>
+#include <memory>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace harness
+{
+	namespace simd = fcp::algods::simd;
+
+	// Name of an ISA tag
+	template <typename ISA> constexpr std::string_view isa_name = "?";
+	template <> constexpr std::string_view isa_name<simd::scalar> = "scalar";
+	template <> constexpr std::string_view isa_name<simd::sse> = "sse";
+	template <> constexpr std::string_view isa_name<simd::avx> = "avx";
+	template <> constexpr std::string_view isa_name<simd::avx512> = "avx512";
+
+	/// @brief One implementation (ISA tag) of a kernel working on arrays of `T`
+	template <typename T>
+	struct kernel_impl
+	{
+		std::string kernel;
+		std::string_view isa;
+		std::size_t inputs;	// number of input arrays of `n` elements
+		std::size_t outputs;	// number of output arrays
+		bool reduction;	// outputs hold one element instead of `n`
+		double tolerance;	// largest error allowed, relative to the scale of each output element
+		bool (*host_supported)(void);
+		std::function<void(const T* const* in, T* const* out, const std::size_t& n)> run;
+		// Scale of the error of each element of the outputs; max(1, |reference|) if empty
+		std::function<void(const T* const* in, const std::size_t& n, double* scale)> scale;
+	};
+
+	template <typename T>
+	inline std::vector<kernel_impl<T>>& registry(void)
+	{
+		static std::vector<kernel_impl<T>> _registry;
+		return _registry;
+	}
+
+	/// @brief Register `kernel` for every ISA tag compiled in
+	/// @details `f` is a generic callable invoked as `f(isa_tag, in, out, n)`
+	template <typename T, typename F>
+	inline void add(const std::string& kernel, const std::size_t& inputs, const std::size_t& outputs, const bool& reduction,
+									const double& tolerance, F f,
+									std::function<void(const T* const*, const std::size_t&, double*)> scale = nullptr)
+	{
+		auto _add = [&](auto isa)
+		{
+			using ISA = decltype(isa);
+			registry<T>().push_back(kernel_impl<T>{ kernel, isa_name<ISA>, inputs, outputs, reduction, tolerance,
+				&simd::is_host_supported<ISA>,
+				[f](const T* const* in, T* const* out, const std::size_t& n) { f(ISA(), in, out, n); },
+				scale });
+		};
+		_add(simd::scalar());
+		if constexpr (simd::is_supported_v<simd::sse>) _add(simd::sse());
+		if constexpr (simd::is_supported_v<simd::avx>) _add(simd::avx());
+		if constexpr (simd::is_supported_v<simd::avx512>) _add(simd::avx512());
+	}
+
+	// Arrays over-allocated so that they can start at any offset from a 64 bytes boundary
+	template <typename T>
+	struct buffer
+	{
+		buffer(const std::size_t& n, const std::size_t& offset)
+			: m_storage((n + offset) * sizeof(T) + 128), m_n{n}
+		{
+			void* _p = m_storage.data();
+			std::size_t _space{ m_storage.size() };
+			_p = std::align(64, sizeof(T), _p, _space);
+			m_data = static_cast<T*>(_p) + offset;
+		}
+
+		T* data(void) { return m_data; }
+		const T* data(void) const { return m_data; }
+		T& operator[](const std::size_t& i) { return m_data[i]; }
+		const T& operator[](const std::size_t& i) const { return m_data[i]; }
+
+		std::vector<unsigned char> m_storage;
+		std::size_t m_n;
+		T* m_data;
+	};
+
+	enum class input_kind { RANDOM, EDGE };
+
+	// Special values mixed into the edge-case inputs; the integer ones dominate the random values without overflowing
+	// the sums of the scans
+	template <typename T>
+	inline std::vector<T> edge_values(void)
+	{
+		if constexpr (std::is_integral_v<T>)
+			return { T{0}, T{1}, T{-1}, T{1} << 19, -(T{1} << 19) };
+		else
+			return {
+				std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+				T{0}, -T{0}, std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::min() / 3, -std::numeric_limits<T>::min() / 5
+			};
+	}
+
+	template <typename T>
+	inline void fill(buffer<T>& b, const std::size_t& n, const input_kind& kind, std::mt19937& rng)
+	{
+		using _distribution = std::conditional_t<std::is_integral_v<T>, std::uniform_int_distribution<T>, std::uniform_real_distribution<T>>;
+		_distribution _dist(std::is_integral_v<T> ? -1000 : -1, std::is_integral_v<T> ? 1000 : 1);
+		for (std::size_t i{0}; i < n; i++)
+			b[i] = _dist(rng);
+		if (input_kind::EDGE == kind)
+		{
+			const auto _specials{ edge_values<T>() };
+			std::uniform_int_distribution<std::size_t> _which(0, _specials.size() - 1), _coin(0, 7);
+			for (std::size_t i{0}; i < n; i++)
+				if (0 == _coin(rng)) b[i] = _specials[_which(rng)];
+		}
+	}
+
+	// Error of `r` against the reference `e`, relative to `scale`; matching NaNs and infinities have no error
+	inline double error(const double& e, const double& r, const double& scale)
+	{
+		if (std::isnan(e) or std::isnan(r)) return std::isnan(e) and std::isnan(r) ? 0. : std::numeric_limits<double>::infinity();
+		if (std::isinf(e) or std::isinf(r)) return e == r ? 0. : std::numeric_limits<double>::infinity();
+		return std::abs(e - r) / scale;
+	}
+
+	struct accuracy_result
+	{
+		double max_error{0};
+		std::string worst_case;
+	};
+
+	// Compare `impl` with `ref` over every input kind, size and offset
+	template <typename T>
+	inline accuracy_result check_accuracy(const kernel_impl<T>& ref, const kernel_impl<T>& impl)
+	{
+		constexpr std::size_t _sizes[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 129, 1000, 1031 };
+		accuracy_result _res;
+		std::mt19937 _rng(1234);
+
+		for (const auto _kind : { input_kind::RANDOM, input_kind::EDGE })
+			for (const std::size_t _n : _sizes)
+				for (const std::size_t _offset : { std::size_t{0}, std::size_t{1}, std::size_t{3} })
+				{
+					const std::size_t _out_n{ ref.reduction ? 1 : _n };
+					std::vector<buffer<T>> _in, _out_ref, _out;
+					std::vector<const T*> _in_p;
+					std::vector<T*> _out_ref_p, _out_p;
+					for (std::size_t k{0}; k < ref.inputs; k++)
+					{
+						_in.emplace_back(_n, _offset);
+						fill(_in.back(), _n, _kind, _rng);
+					}
+					for (std::size_t k{0}; k < ref.outputs; k++)
+					{
+						_out_ref.emplace_back(_out_n, _offset);
+						_out.emplace_back(_out_n, _offset);
+					}
+					for (auto& _b : _in) _in_p.push_back(_b.data());
+					for (auto& _b : _out_ref) { std::fill(_b.data(), _b.data() + _out_n, T{0}); _out_ref_p.push_back(_b.data()); }
+					for (auto& _b : _out) { std::fill(_b.data(), _b.data() + _out_n, T{0}); _out_p.push_back(_b.data()); }
+
+					ref.run(_in_p.data(), _out_ref_p.data(), _n);
+					impl.run(_in_p.data(), _out_p.data(), _n);
+
+					std::vector<double> _scale(_out_n, 1.);
+					if (ref.scale)
+						ref.scale(_in_p.data(), _n, _scale.data());
+					for (std::size_t k{0}; k < ref.outputs; k++)
+						for (std::size_t i{0}; i < _out_n; i++)
+						{
+							const double _s{ ref.scale ? std::max(1., _scale[i]) : std::max(1., std::abs(static_cast<double>(_out_ref[k][i]))) };
+							const double _e{ error(_out_ref[k][i], _out[k][i], _s) };
+							if (_e > _res.max_error or (std::isinf(_e) and _res.worst_case.empty()))
+							{
+								_res.max_error = _e;
+								_res.worst_case = std::string(input_kind::RANDOM == _kind ? "random" : "edge")
+									+ " n=" + std::to_string(_n) + " offset=" + std::to_string(_offset)
+									+ " i=" + std::to_string(i) + " expected " + std::to_string(static_cast<double>(_out_ref[k][i]))
+									+ " got " + std::to_string(static_cast<double>(_out[k][i]));
+							}
+						}
+				}
+		return _res;
+	}
+
+	// Throughput in million elements per second on an aligned input of `n` elements
+	template <typename T>
+	inline double throughput(const kernel_impl<T>& impl, const std::size_t& n)
+	{
+		std::mt19937 _rng(99);
+		std::vector<buffer<T>> _in, _out;
+		std::vector<const T*> _in_p;
+		std::vector<T*> _out_p;
+		for (std::size_t k{0}; k < impl.inputs; k++)
+		{
+			_in.emplace_back(n, 0);
+			fill(_in.back(), n, input_kind::RANDOM, _rng);
+			_in_p.push_back(_in.back().data());
+		}
+		for (std::size_t k{0}; k < impl.outputs; k++)
+		{
+			_out.emplace_back(impl.reduction ? 1 : n, 0);
+			_out_p.push_back(_out.back().data());
+		}
+
+		impl.run(_in_p.data(), _out_p.data(), n);	// warm-up
+		std::size_t _reps{0};
+		const auto _start = std::chrono::steady_clock::now();
+		std::chrono::duration<double> _elapsed{0};
+		do {
+			impl.run(_in_p.data(), _out_p.data(), n);
+			_reps++;
+			_elapsed = std::chrono::steady_clock::now() - _start;
+		} while (_elapsed.count() < 0.02);
+		return static_cast<double>(_reps * n) / _elapsed.count() / 1e6;
+	}
+
+	/// @brief Run every registered implementation supported by the host; returns the number of failures
+	template <typename T>
+	inline int run_all(const std::string_view& type_name, const std::size_t& throughput_n = 1 << 14)
+	{
+		int _failures{0};
+		std::cout << '\n' << type_name << '\n';
+		std::cout << std::left << std::setw(28) << "kernel" << std::setw(8) << "isa" << std::setw(13) << "max error"
+							<< std::setw(11) << "tolerance" << std::setw(9) << "result" << std::setw(12) << "Melem/s" << "speedup\n";
+
+		const auto& _impls = registry<T>();
+		for (std::size_t r{0}; r < _impls.size(); r++)
+		{
+			if ("scalar" != _impls[r].isa) continue;
+			const auto& _ref = _impls[r];
+			const double _ref_tp{ throughput(_ref, throughput_n) };
+			for (const auto& _impl : _impls)
+			{
+				if (_impl.kernel != _ref.kernel) continue;
+				std::cout << std::setw(28) << _impl.kernel << std::setw(8) << _impl.isa;
+				if (not _impl.host_supported())
+				{
+					std::cout << "not supported by the host\n";
+					continue;
+				}
+				const auto _acc = check_accuracy(_ref, _impl);
+				const bool _ok{ _acc.max_error <= _impl.tolerance };
+				const double _tp{ &_impl == &_ref ? _ref_tp : throughput(_impl, throughput_n) };
+				_failures += _ok ? 0 : 1;
+				std::cout << std::scientific << std::setprecision(2) << std::setw(13) << _acc.max_error << std::setw(11) << _impl.tolerance
+									<< std::setw(9) << (_ok ? "SUCCESS" : "FAILURE")
+									<< std::fixed << std::setprecision(1) << std::setw(12) << _tp << std::setprecision(2) << _tp / _ref_tp << 'x'
+									<< (&_impl != &_ref and _tp < _ref_tp ? " (slower than scalar)" : "") << '\n';
+				if (not _ok)
+					std::cout << "\tworst case: " << _acc.worst_case << '\n';
+			}
+		}
+		return _failures;
+	}
+}	// namespace harness
+
+#endif	// FCPUT_ALGODS_SIMD_TESTS_HARNESS
@@ -0,0 +1,104 @@
+#ifndef FCPUT_ALGODS_SIMD_TRIDIAGONAL
+#define FCPUT_ALGODS_SIMD_TRIDIAGONAL
+
+#include "algo_ds/common/common.hpp"
+#include "common_simd.hpp"
+#include "sse.hpp"
+#include "avx.hpp"
+#include "avx512.hpp"
+
+#include <cstddef>
+#include <utility>
+
+/* Batched tridiagonal solves (Thomas algorithm) over `float`/`double`.
+ *
+ * A batch is made of independent systems sharing the same matrix, e.g. the lines of a multi-dimensional
+ * field along one axis. The matrix is factorized once by `tridiagonal_factor()`; the right-hand sides
+ * are interleaved, the `i`-th unknown of the `l`-th system being `x[i*stride + l]`, so that each step
+ * of the forward and backward sweeps is a single register operation over consecutive systems.
+ * `internal::_tridiagonal_registers` registers of systems are swept together, hiding the latency of
+ * the dependency chain along the unknowns.
+ */
+
+FCP_NAMESPACE_BEGIN
+FCP_NAMESPACE_ALGODS_BEGIN
+FCP_NAMESPACE_SIMD_BEGIN
+
+namespace internal
+{
+	// Registers of systems swept together
+	constexpr std::size_t _tridiagonal_registers{ 4 };
+
+	// Both sweeps over `sizeof...(R)` consecutive registers of systems
+	template <typename P, typename T, std::size_t... R>
+	inline void _tridiagonal_block(const T* lower, const T* cp, const T* inv, T* x, const std::size_t& n, const std::size_t& stride,
+																 std::index_sequence<R...>)
+	{
+		typename P::type _y[sizeof...(R)]{ (static_cast<void>(R), P::zero())... };
+		for (std::size_t i{0}; i < n; i++)
+		{
+			const typename P::type _l{ P::set1(lower[i]) }, _v{ P::set1(inv[i]) };
+			T* _x{ x + i * stride };
+			((_y[R] = P::mul(P::sub(P::loadu(_x + R * P::width), P::mul(_l, _y[R])), _v)), ...);
+			(P::storeu(_x + R * P::width, _y[R]), ...);
+		}
+		for (std::size_t i{n - 1}; i-- > 0;)
+		{
+			const typename P::type _c{ P::set1(cp[i]) };
+			T* _x{ x + i * stride };
+			((_y[R] = P::sub(P::loadu(_x + R * P::width), P::mul(_c, _y[R]))), ...);
+			(P::storeu(_x + R * P::width, _y[R]), ...);
+		}
+	}
+
+	template <typename P, typename T>
+	inline std::size_t _tridiagonal(const T* lower, const T* cp, const T* inv, T* x, const std::size_t& n, const std::size_t& stride,
+																	std::size_t l, const std::size_t& batch)
+	{
+		constexpr std::size_t _step{ _tridiagonal_registers * P::width };
+		for (; l + _step <= batch; l += _step)
+			_tridiagonal_block<P>(lower, cp, inv, x + l, n, stride, std::make_index_sequence<_tridiagonal_registers>());
+		for (; l + P::width <= batch; l += P::width)
+			_tridiagonal_block<P>(lower, cp, inv, x + l, n, stride, std::index_sequence<0>());
+		return l;
+	}
+}	// namespace internal
+
+/// @brief Factorize the tridiagonal matrix of `n` rows `lower[i]*x[i-1] + diag[i]*x[i] + upper[i]*x[i+1]` for `tridiagonal_solve()`
+/// @details Writes the `n` modified upper coefficients into `cp` and the inverses of the `n` pivots into `inv`; `lower[0]`
+/// and `upper[n-1]` are not used. No pivoting is done, so the matrix should be diagonally dominant
+template <typename T>
+inline void tridiagonal_factor(const T* lower, const T* diag, const T* upper, T* cp, T* inv, const std::size_t& n)
+{
+	for (std::size_t i{0}; i < n; i++)
+	{
+		inv[i] = T{1} / (diag[i] - (i > 0 ? lower[i] * cp[i - 1] : T{0}));
+		cp[i] = i + 1 < n ? upper[i] * inv[i] : T{0};
+	}
+}
+
+/// @brief Solve in place `batch` tridiagonal systems of `n` unknowns sharing the matrix factorized by `tridiagonal_factor()`
+/// @details `lower` is the lower diagonal of the matrix (`lower[0]` must be finite), `cp` and `inv` its factors. The right-hand
+/// side of the `l`-th system, replaced by its solution, is `x[l], x[stride + l], ..., x[(n-1)*stride + l]`
+template <typename ISA, typename T>
+inline void tridiagonal_solve(ISA, const T* lower, const T* cp, const T* inv, T* x, const std::size_t& n, const std::size_t& stride,
+															const std::size_t& batch)
+{
+	if (0 == n) return;
+	const std::size_t l{ internal::_tridiagonal<pack<T, ISA>>(lower, cp, inv, x, n, stride, 0, batch) };
+	internal::_tridiagonal<pack<T, scalar>>(lower, cp, inv, x, n, stride, l, batch);
+}
+
+// Overloads using the widest ISA extension enabled at compile time
+
+template <typename T>
+inline void tridiagonal_solve(const T* lower, const T* cp, const T* inv, T* x, const std::size_t& n, const std::size_t& stride, const std::size_t& batch)
+{
+	tridiagonal_solve(native{}, lower, cp, inv, x, n, stride, batch);
+}
+
+FCP_NAMESPACE_SIMD_END
+FCP_NAMESPACE_ALGODS_END
+FCP_NAMESPACE_END
+
+#endif	// FCPUT_ALGODS_SIMD_TRIDIAGONAL
@@ -1,13 +1,102 @@
 #ifndef FCPUT_ARCHITECTURE_SIMD
 #define FCPUT_ARCHITECTURE_SIMD
 
-/* Detect SIMD extensions */
+/* Detect SIMD extensions
+ *
+ * The extensions are detected at compile time from the flags passed to the compiler
+ * (eg. `-march=native`, `-mavx2`, `/arch:AVX512`). Each macro is either 1 or 0.
+ */
 
 // Depends on the OS because Windows is weird
 #if 1 == FCPUT_WINDOWS
 // Detect SIMD for Windows
+// MSVC doesn't define the SSE macros, but x64 always provides SSE2 and `_M_IX86_FP` tells the rest on x86
+#if defined(_M_X64) or defined(_M_AMD64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 1)
+#define FCPUT_SIMD_SSE 1
+#else
+#define FCPUT_SIMD_SSE 0
+#endif
+#if defined(_M_X64) or defined(_M_AMD64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#define FCPUT_SIMD_SSE2 1
+#else
+#define FCPUT_SIMD_SSE2 0
+#endif
+// There are no SSE4.1, FMA and F16C macros either: every CPU supporting AVX/AVX2 has them
+#ifdef __AVX__
+#define FCPUT_SIMD_SSE41 1
+#define FCPUT_SIMD_AVX 1
+#else
+#define FCPUT_SIMD_SSE41 0
+#define FCPUT_SIMD_AVX 0
+#endif
+#ifdef __AVX2__
+#define FCPUT_SIMD_AVX2 1
+#define FCPUT_SIMD_FMA 1
+#define FCPUT_SIMD_F16C 1
+#else
+#define FCPUT_SIMD_AVX2 0
+#define FCPUT_SIMD_FMA 0
+#define FCPUT_SIMD_F16C 0
+#endif
 #else
 // Detect SIMD for Linux/Unix
+#ifdef __SSE__
+#define FCPUT_SIMD_SSE 1
+#else
+#define FCPUT_SIMD_SSE 0
+#endif
+#ifdef __SSE2__
+#define FCPUT_SIMD_SSE2 1
+#else
+#define FCPUT_SIMD_SSE2 0
+#endif
+#ifdef __SSE4_1__
+#define FCPUT_SIMD_SSE41 1
+#else
+#define FCPUT_SIMD_SSE41 0
+#endif
+#ifdef __AVX__
+#define FCPUT_SIMD_AVX 1
+#else
+#define FCPUT_SIMD_AVX 0
+#endif
+#ifdef __AVX2__
+#define FCPUT_SIMD_AVX2 1
+#else
+#define FCPUT_SIMD_AVX2 0
+#endif
+#ifdef __FMA__
+#define FCPUT_SIMD_FMA 1
+#else
+#define FCPUT_SIMD_FMA 0
+#endif
+#ifdef __F16C__
+#define FCPUT_SIMD_F16C 1
+#else
+#define FCPUT_SIMD_F16C 0
+#endif
+#endif
+
+// AVX-512 macros are the same for every supported compiler
+#ifdef __AVX512F__
+#define FCPUT_SIMD_AVX512F 1
+#else
+#define FCPUT_SIMD_AVX512F 0
+#endif
+#ifdef __AVX512BW__
+#define FCPUT_SIMD_AVX512BW 1
+#else
+#define FCPUT_SIMD_AVX512BW 0
+#endif
+#ifdef __AVX512VL__
+#define FCPUT_SIMD_AVX512VL 1
+#else
+#define FCPUT_SIMD_AVX512VL 0
+#endif
+#ifdef __AVX512DQ__
+#define FCPUT_SIMD_AVX512DQ 1
+#else
+#define FCPUT_SIMD_AVX512DQ 0
 #endif
 
 #endif	// FCPUT_ARCHITECTURE_SIMD
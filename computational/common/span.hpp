@@ -0,0 +1,63 @@
+#ifndef FCPUT_COMPUTATIONAL_SPAN
+#define FCPUT_COMPUTATIONAL_SPAN
+
+#include "computational/common/common.hpp"
+
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <type_traits>
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Non-owning view over a contiguous array (a C++17 stand-in for `std::span` with dynamic extent)
+/// @details `span<const T>` is a read-only view; every `span<T>` converts to it
+template <typename T>
+class span
+{
+	public:
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using iterator = T*;
+
+		span(void) noexcept: m_data{nullptr}, m_size{0} {}
+		span(T* data, const std::size_t& size) noexcept: m_data{data}, m_size{size} {}
+
+		template <typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+		span(const span<U>& other) noexcept: m_data{other.data()}, m_size{other.size()} {}
+
+		template <typename U, typename Allocator, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+		span(std::vector<U, Allocator>& v) noexcept: m_data{v.data()}, m_size{v.size()} {}
+
+		template <typename U, typename Allocator, typename = std::enable_if_t<std::is_convertible_v<const U(*)[], T(*)[]>>>
+		span(const std::vector<U, Allocator>& v) noexcept: m_data{v.data()}, m_size{v.size()} {}
+
+		template <typename U, std::size_t N, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+		span(std::array<U, N>& a) noexcept: m_data{a.data()}, m_size{N} {}
+
+		template <typename U, std::size_t N, typename = std::enable_if_t<std::is_convertible_v<const U(*)[], T(*)[]>>>
+		span(const std::array<U, N>& a) noexcept: m_data{a.data()}, m_size{N} {}
+
+		T* data(void) const noexcept { return m_data; }
+		std::size_t size(void) const noexcept { return m_size; }
+		bool empty(void) const noexcept { return 0 == m_size; }
+
+		/// @brief Returns the `i`-th element without any bounds checking
+		T& operator[](const std::size_t& i) const noexcept { return m_data[i]; }
+
+		iterator begin(void) const noexcept { return m_data; }
+		iterator end(void) const noexcept { return m_data + m_size; }
+
+		/// @brief View over the `count` elements starting at `offset`, without any bounds checking
+		span subspan(const std::size_t& offset, const std::size_t& count) const noexcept { return span(m_data + offset, count); }
+
+	private:
+		T* m_data;
+		std::size_t m_size;
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_SPAN
@@ -0,0 +1,141 @@
+#ifndef FCPUT_COMPUTATIONAL_THREAD_POOL
+#define FCPUT_COMPUTATIONAL_THREAD_POOL
+
+#include "computational/common/common.hpp"
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Worker threads started once and reused by every parallel evaluation
+/// @details `run()` hands out numbered tasks to the workers and to the calling thread, which takes part too, and returns
+/// once all of them are done. The pool grows to the largest number of threads a call asks for, and keeps them until it
+/// is destroyed. Calls from different threads are served one after the other; a task must not call `run()` on its pool
+class thread_pool
+{
+	public:
+		/// @brief Pool with `workers` threads besides the calling one
+		explicit thread_pool(const std::size_t& workers = 0) { this->_grow(workers); }
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		~thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> _lock(m_mutex);
+				m_stop = true;
+			}
+			m_wake.notify_all();
+			for (auto& _t : m_workers)
+				_t.join();
+		}
+
+		/// @brief Number of worker threads
+		std::size_t size(void) const
+		{
+			std::lock_guard<std::mutex> _lock(m_mutex);
+			return m_workers.size();
+		}
+
+		/// @brief Call `task(t)` for every t in [0, tasks), on at most `tasks` threads (the calling one included)
+		/// @details The first exception thrown by a task is rethrown once all of them are done
+		template <typename F>
+		void run(const std::size_t& tasks, const F& task)
+		{
+			if (0 == tasks) return;
+			std::lock_guard<std::mutex> _serial(m_run);
+			this->_grow(tasks - 1);
+
+			{
+				std::lock_guard<std::mutex> _lock(m_mutex);
+				m_task = [&task](const std::size_t& t) { task(t); };
+				m_tasks = tasks;
+				m_next = 0;
+				m_finished = 0;
+				m_error = nullptr;
+				m_generation++;
+			}
+			m_wake.notify_all();
+			this->_work();
+
+			// Every worker checks in, so that none is left holding the task once this call returns
+			std::unique_lock<std::mutex> _lock(m_mutex);
+			m_done.wait(_lock, [this]() { return m_finished == m_workers.size(); });
+			m_task = nullptr;
+			if (m_error) std::rethrow_exception(m_error);
+		}
+
+		/// @brief Pool shared by the parallel evaluations of the library, started with the hardware threads
+		static thread_pool& shared(void)
+		{
+			static thread_pool _pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+			return _pool;
+		}
+
+	private:
+		// Claim tasks until none is left
+		void _work(void)
+		{
+			for (std::size_t t{ m_next++ }; t < m_tasks; t = m_next++)
+				try
+				{
+					m_task(t);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> _lock(m_mutex);
+					if (not m_error) m_error = std::current_exception();
+				}
+		}
+
+		void _loop(std::size_t seen)
+		{
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> _lock(m_mutex);
+					m_wake.wait(_lock, [&]() { return m_stop or m_generation != seen; });
+					if (m_stop) return;
+					seen = m_generation;
+				}
+				this->_work();
+				{
+					std::lock_guard<std::mutex> _lock(m_mutex);
+					m_finished++;
+				}
+				m_done.notify_one();
+			}
+		}
+
+		// Start workers up to `workers`; only called while no task is running
+		void _grow(const std::size_t& workers)
+		{
+			std::lock_guard<std::mutex> _lock(m_mutex);
+			while (m_workers.size() < workers)
+				m_workers.emplace_back(&thread_pool::_loop, this, m_generation);
+		}
+
+		std::vector<std::thread> m_workers;
+		mutable std::mutex m_mutex;
+		std::mutex m_run;
+		std::condition_variable m_wake, m_done;
+		std::function<void(const std::size_t&)> m_task;
+		std::size_t m_tasks{0}, m_finished{0}, m_generation{0};
+		std::atomic<std::size_t> m_next{0};
+		std::exception_ptr m_error;
+		bool m_stop{false};
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_THREAD_POOL
@@ -0,0 +1,382 @@
+#ifndef FCPUT_COMPUTATIONAL_ADJOINT
+#define FCPUT_COMPUTATIONAL_ADJOINT
+
+#include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "computational/differentiation/autodiff.hpp"
+#include "algo_ds/allocators/arena.hpp"
+
+#include <type_traits>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+/* Reverse-mode automatic differentiation.
+ *
+ * Every operation on `var` numbers appends a node to a `tape`: the indices of its (at most two)
+ * operands and the partial derivatives with respect to them. A sweep over the tape in reverse order
+ * accumulates the adjoints (the derivatives of an output with respect to every node), so the whole
+ * gradient of a scalar function costs a small constant multiple of one evaluation, whatever the
+ * number of inputs. The nodes live in blocks taken from a bump-pointer arena and are reused after a
+ * rewind, so recording allocates nothing in steady state.
+ *
+ * The sweeps are vectorized across outputs: with `packed` adjoints, a single sweep computes as many
+ * rows of a Jacobian as the register lanes.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+template <typename T>
+class tape;
+
+/// @brief Number recorded on a `tape`, or a constant if not attached to any
+template <typename T>
+class var
+{
+	public:
+		/// @brief Constant
+		var(const T& value = T{0}): m_value{value}, m_index{0}, m_tape{nullptr} {}
+
+		template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> and not std::is_same_v<S, T>>>
+		var(const S& s): var(static_cast<T>(s)) {}
+
+		const T& value(void) const { return m_value; }
+
+		/// @brief Node of the number on its tape (0 for the constants)
+		std::size_t index(void) const { return m_index; }
+
+		tape<T>* get_tape(void) const { return m_tape; }
+
+	private:
+		friend class tape<T>;
+
+		var(const T& value, const std::size_t& index, tape<T>* t): m_value{value}, m_index{index}, m_tape{t} {}
+
+		T m_value;
+		std::size_t m_index;
+		tape<T>* m_tape;
+};
+
+namespace internal
+{
+	// Node of a tape: the operands and the partial derivatives with respect to them. Node 0 stands for the constants
+	// (and the missing operands), so that every node is swept the same way. The sweeps are bound by the memory
+	// traffic, hence the 32-bit indices
+	template <typename T>
+	struct _tape_node
+	{
+		std::uint32_t lhs, rhs;
+		T dl, dr;
+	};
+}	// namespace internal
+
+/// @brief Record of the operations on `var` numbers, for reverse-mode differentiation
+/// @details Not thread-safe: each thread records on its own tape
+template <typename T>
+class tape
+{
+	public:
+		/// @brief Number of nodes taken at once from the arena, which allocates memory for 64 such blocks at a time
+		constexpr static std::size_t block_nodes{ 1 << 12 };
+
+		/// @brief Maximum number of nodes
+		constexpr static std::size_t max_size{ std::numeric_limits<std::uint32_t>::max() };
+
+		tape(void): m_arena{ 64 * block_nodes * sizeof(internal::_tape_node<T>) }, m_block{nullptr}, m_size{0}
+		{
+			this->record(T{0}, var<T>(), T{0});
+		}
+		tape(const tape&) = delete;
+		tape& operator=(const tape&) = delete;
+
+		/// @brief New independent variable
+		var<T> variable(const T& value)
+		{
+			return this->record(value, var<T>(), T{0});
+		}
+
+		/// @brief Record the result `value` of an operation on `a` (and `b`), with partial derivatives `da` (and `db`)
+		/// @details Throws `std::length_error` past `max_size` nodes
+		var<T> record(const T& value, const var<T>& a, const T& da, const var<T>& b = var<T>(), const T& db = T{0})
+		{
+			const std::size_t _i{ m_size % block_nodes };
+			if (0 == _i)
+				_next_block();
+			m_block[_i] = { static_cast<std::uint32_t>(a.index()), static_cast<std::uint32_t>(b.index()), da, db };
+			return var<T>(value, m_size++, this);
+		}
+
+		/// @brief Number of nodes recorded
+		std::size_t size(void) const { return m_size; }
+
+		/// @brief Drop the nodes recorded after the first `position` ones (a previous `size()`), keeping their memory
+		/// @details The variables recorded after it must not be used anymore
+		void rewind(const std::size_t& position)
+		{
+			if (position < 1 or position > m_size)
+				throw std::out_of_range("method tape::rewind(): position out of the tape was requested.\n");
+			m_size = position;
+			m_block = m_blocks[(m_size - 1) / block_nodes];
+		}
+
+		/// @brief Drop all the nodes, keeping their memory
+		void clear(void) { this->rewind(1); }
+
+		/// @brief Adjoints of every node for the output `sum(seeds[k] * outputs[k])`, by a single reverse sweep
+		/// @details The one of node 0 sums those of every constant operand and isn't a derivative
+		std::vector<T> adjoints(const span<const var<T>>& outputs, const span<const T>& seeds) const
+		{
+			if (outputs.size() != seeds.size())
+				throw std::invalid_argument("method tape::adjoints(): the numbers of outputs and of seeds differ.\n");
+			std::vector<T> _res(m_size, T{0});
+			for (std::size_t k{0}; k < outputs.size(); k++)
+				_res[_node_of(outputs[k])] += seeds[k];
+			_sweep(_res);
+			return _res;
+		}
+
+		/// @brief Derivatives of `output` with respect to `inputs`, zero for the constants among them
+		std::vector<T> gradient(const var<T>& output, const span<const var<T>>& inputs) const
+		{
+			const T _one{1};
+			const std::vector<T> _adj{ this->adjoints(span<const var<T>>(&output, 1), span<const T>(&_one, 1)) };
+			std::vector<T> _res(inputs.size());
+			for (std::size_t j{0}; j < inputs.size(); j++)
+				_res[j] = 0 == _node_of(inputs[j]) ? T{0} : _adj[_node_of(inputs[j])];
+			return _res;
+		}
+
+		/// @brief Derivatives of `outputs` with respect to `inputs`, row-major (one row per output), zero for the constants
+		/// among the inputs
+		/// @details Each reverse sweep carries the adjoints of a register's worth of outputs in the lanes of `packed`
+		/// numbers of the ISA extension `ISA`
+		template <typename ISA = fcp::algods::simd::native>
+		std::vector<T> jacobian(const span<const var<T>>& outputs, const span<const var<T>>& inputs) const
+		{
+			using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, ISA, fcp::algods::simd::scalar>;
+			using _p_t = packed<T, _isa>;
+			constexpr std::size_t _W{ _p_t::width };
+
+			std::vector<T> _res(outputs.size() * inputs.size());
+			std::vector<_p_t> _adj(m_size);
+			T _lanes[_W];
+			for (std::size_t r{0}; r < outputs.size(); r += _W)
+			{
+				std::fill(_adj.begin(), _adj.end(), _p_t());
+				for (std::size_t l{0}; l < _W and r + l < outputs.size(); l++)
+				{
+					_adj[_node_of(outputs[r + l])].storeu(_lanes);
+					_lanes[l] += T{1};
+					_adj[_node_of(outputs[r + l])] = _p_t::loadu(_lanes);
+				}
+				_sweep(_adj);
+				for (std::size_t j{0}; j < inputs.size(); j++)
+				{
+					// Node 0 gathers the adjoints of every constant operand
+					(0 == _node_of(inputs[j]) ? _p_t() : _adj[_node_of(inputs[j])]).storeu(_lanes);
+					for (std::size_t l{0}; l < _W and r + l < outputs.size(); l++)
+						_res[(r + l) * inputs.size() + j] = _lanes[l];
+				}
+			}
+			return _res;
+		}
+
+	private:
+		// Move to the block of the node `m_size`, which is the first one of a block, taking it from the arena if new
+		void _next_block(void)
+		{
+			if (m_size >= max_size)
+				throw std::length_error("method tape::record(): too many nodes were recorded.\n");
+			const std::size_t _b{ m_size / block_nodes };
+			if (_b == m_blocks.size())
+				m_blocks.push_back(m_arena.allocate<internal::_tape_node<T>>(block_nodes));
+			m_block = m_blocks[_b];
+		}
+
+		// Node of a number, which must be a constant or recorded on this tape (and not rewound)
+		std::size_t _node_of(const var<T>& x) const
+		{
+			if ((x.get_tape() and x.get_tape() != this) or x.index() >= m_size)
+				throw std::invalid_argument("class tape: the number was not recorded on this tape.\n");
+			return x.index();
+		}
+
+		// Propagate the adjoints `adj` (one per node, scalars or packs) from the last node to the first
+		template <typename V>
+		void _sweep(std::vector<V>& adj) const
+		{
+			for (std::size_t b{ (m_size + block_nodes - 1) / block_nodes }; b-- > 0;)
+			{
+				const internal::_tape_node<T>* _nodes{ m_blocks[b] };
+				const std::size_t _first{ b * block_nodes };
+				for (std::size_t i{ std::min(block_nodes, m_size - _first) }; i-- > 0;)
+				{
+					const V _a{ adj[_first + i] };
+					const auto& _n{ _nodes[i] };
+					adj[_n.lhs] += V(_n.dl) * _a;
+					adj[_n.rhs] += V(_n.dr) * _a;
+				}
+			}
+		}
+
+		fcp::algods::arena m_arena;
+		std::vector<internal::_tape_node<T>*> m_blocks;
+		internal::_tape_node<T>* m_block;
+		std::size_t m_size;
+};
+
+namespace internal
+{
+	// Result `value` of an operation on `x`, with derivative `dx`
+	template <typename T>
+	var<T> _unary(const var<T>& x, const T& value, const T& dx)
+	{
+		return x.get_tape() ? x.get_tape()->record(value, x, dx) : var<T>(value);
+	}
+
+	// Result `value` of an operation on `a` and `b`, with partial derivatives `da` and `db`
+	template <typename T>
+	var<T> _binary(const var<T>& a, const var<T>& b, const T& value, const T& da, const T& db)
+	{
+		if (a.get_tape() and b.get_tape() and a.get_tape() != b.get_tape())
+			throw std::invalid_argument("reverse-mode differentiation: operands recorded on different tapes.\n");
+		tape<T>* _t{ a.get_tape() ? a.get_tape() : b.get_tape() };
+		return _t ? _t->record(value, a, da, b, db) : var<T>(value);
+	}
+
+	template <typename T, typename S>
+	using _enable_var_scalar = std::enable_if_t<std::is_arithmetic_v<S>, var<T>>;
+}	// namespace internal
+
+// Arithmetic between numbers, and with scalars on either side
+
+template <typename T> var<T> operator+(const var<T>& a, const var<T>& b) { return internal::_binary(a, b, a.value() + b.value(), T{1}, T{1}); }
+template <typename T> var<T> operator-(const var<T>& a, const var<T>& b) { return internal::_binary(a, b, a.value() - b.value(), T{1}, T{-1}); }
+template <typename T> var<T> operator*(const var<T>& a, const var<T>& b) { return internal::_binary(a, b, a.value() * b.value(), b.value(), a.value()); }
+template <typename T> var<T> operator/(const var<T>& a, const var<T>& b)
+{
+	const T _inv{ T{1} / b.value() }, _q{ a.value() * _inv };
+	return internal::_binary(a, b, _q, _inv, -_q * _inv);
+}
+template <typename T> var<T> operator-(const var<T>& a) { return internal::_unary(a, -a.value(), T{-1}); }
+
+template <typename T, typename S> internal::_enable_var_scalar<T, S> operator+(const var<T>& a, const S& b) { return internal::_unary(a, a.value() + T(b), T{1}); }
+template <typename T, typename S> internal::_enable_var_scalar<T, S> operator-(const var<T>& a, const S& b) { return internal::_unary(a, a.value() - T(b), T{1}); }
+template <typename T, typename S> internal::_enable_var_scalar<T, S> operator*(const var<T>& a, const S& b) { return internal::_unary(a, a.value() * T(b), T(b)); }
+template <typename T, typename S> internal::_enable_var_scalar<T, S> operator/(const var<T>& a, const S& b) { return internal::_unary(a, a.value() / T(b), T{1} / T(b)); }
+template <typename S, typename T> internal::_enable_var_scalar<T, S> operator+(const S& a, const var<T>& b) { return internal::_unary(b, T(a) + b.value(), T{1}); }
+template <typename S, typename T> internal::_enable_var_scalar<T, S> operator-(const S& a, const var<T>& b) { return internal::_unary(b, T(a) - b.value(), T{-1}); }
+template <typename S, typename T> internal::_enable_var_scalar<T, S> operator*(const S& a, const var<T>& b) { return internal::_unary(b, T(a) * b.value(), T(a)); }
+template <typename S, typename T> internal::_enable_var_scalar<T, S> operator/(const S& a, const var<T>& b)
+{
+	const T _q{ T(a) / b.value() };
+	return internal::_unary(b, _q, -_q / b.value());
+}
+
+template <typename T> var<T>& operator+=(var<T>& a, const var<T>& b) { return a = a + b; }
+template <typename T> var<T>& operator-=(var<T>& a, const var<T>& b) { return a = a - b; }
+template <typename T> var<T>& operator*=(var<T>& a, const var<T>& b) { return a = a * b; }
+template <typename T> var<T>& operator/=(var<T>& a, const var<T>& b) { return a = a / b; }
+
+// Elementary functions
+
+template <typename T> var<T> sin(const var<T>& x) { return internal::_unary(x, std::sin(x.value()), std::cos(x.value())); }
+template <typename T> var<T> cos(const var<T>& x) { return internal::_unary(x, std::cos(x.value()), -std::sin(x.value())); }
+template <typename T> var<T> exp(const var<T>& x) { const T _e{ std::exp(x.value()) }; return internal::_unary(x, _e, _e); }
+template <typename T> var<T> log(const var<T>& x) { return internal::_unary(x, std::log(x.value()), T{1} / x.value()); }
+template <typename T> var<T> sqrt(const var<T>& x) { const T _r{ std::sqrt(x.value()) }; return internal::_unary(x, _r, T(0.5) / _r); }
+template <typename T> var<T> tan(const var<T>& x) { const T _t{ std::tan(x.value()) }; return internal::_unary(x, _t, T{1} + _t * _t); }
+template <typename T> var<T> tanh(const var<T>& x) { const T _t{ std::tanh(x.value()) }; return internal::_unary(x, _t, T{1} - _t * _t); }
+
+/// @brief `x` to the scalar power `p`
+/// @details The value is a power of its own, so that it is exact at `x = 0` whatever `p`; the adjoint of a constant is zero
+template <typename T, typename S> internal::_enable_var_scalar<T, S> pow(const var<T>& x, const S& p)
+{
+	const T _v{ std::pow(x.value(), T(p)) };
+	return internal::_unary(x, _v, S(0) == p ? T{0} : T(p) * std::pow(x.value(), T(p) - T{1}));
+}
+
+/// @brief Gradient of the scalar function `f` at `x`, by a single reverse sweep
+/// @details `f` is called once with a `std::vector` of `var<T>`, typically through a templated `operator()` using the
+/// elementary functions unqualified (like the functors of `AutoDifferentiate`)
+template <typename T, class Functor>
+FCP_COMPUTATIONAL_API std::vector<T> adjoint_gradient(const Functor& f, const span<const T>& x)
+{
+	tape<T> _tape;
+	std::vector<var<T>> _x;
+	_x.reserve(x.size());
+	for (const auto& _xi : x)
+		_x.push_back(_tape.variable(_xi));
+	const var<T> _y{ f(static_cast<const std::vector<var<T>>&>(_x)) };
+	return _tape.gradient(_y, _x);
+}
+
+/// @brief Gradient of `objective(step^steps(x))` with respect to the initial state `x`, with checkpointing
+/// @details `step` maps a state (a `std::vector`) to the next one and `objective` a state to a scalar, both for any
+/// scalar type like in `adjoint_gradient()`. The states are evaluated without recording and saved every `interval`
+/// steps; then the segments are recorded one at a time, from the last, and swept backwards, carrying the adjoints of
+/// the states between them. The tape holds at most `interval` steps, at the cost of a second evaluation of each step
+template <typename T, class Step, class Objective>
+FCP_COMPUTATIONAL_API std::vector<T> checkpointed_gradient(const Step& step, const Objective& objective, const span<const T>& x,
+																													 const std::size_t& steps, const std::size_t& interval)
+{
+	if (0 == interval)
+		throw std::invalid_argument("function checkpointed_gradient(): the checkpoint interval must be a positive number.\n");
+
+	// Forward pass, saving the checkpoints
+	std::vector<std::vector<T>> _checkpoints;
+	std::vector<T> _state(x.begin(), x.end());
+	for (std::size_t k{0}; k < steps; k++)
+	{
+		if (k % interval == 0)
+			_checkpoints.push_back(_state);
+		_state = step(static_cast<const std::vector<T>&>(_state));
+	}
+
+	tape<T> _tape;
+	auto _record_state = [&](const std::vector<T>& s)
+	{
+		std::vector<var<T>> _res;
+		_res.reserve(s.size());
+		for (const auto& _si : s)
+			_res.push_back(_tape.variable(_si));
+		return _res;
+	};
+	auto _adjoints_of = [&](const std::vector<T>& adj, const std::vector<var<T>>& v)
+	{
+		std::vector<T> _res(v.size());
+		for (std::size_t j{0}; j < v.size(); j++)
+			_res[j] = adj[v[j].index()];
+		return _res;
+	};
+
+	// Adjoint of the final state
+	std::vector<var<T>> _in{ _record_state(_state) };
+	const var<T> _y{ objective(static_cast<const std::vector<var<T>>&>(_in)) };
+	const T _one{1};
+	std::vector<T> _lambda{ _adjoints_of(_tape.adjoints(span<const var<T>>(&_y, 1), span<const T>(&_one, 1)), _in) };
+
+	// Segments, from the last one
+	for (std::size_t c{_checkpoints.size()}; c-- > 0;)
+	{
+		_tape.clear();
+		_in = _record_state(_checkpoints[c]);
+		std::vector<var<T>> _out{ _in };
+		for (std::size_t k{c * interval}; k < std::min(steps, (c + 1) * interval); k++)
+			_out = step(static_cast<const std::vector<var<T>>&>(_out));
+		if (_out.size() != _lambda.size())
+			throw std::invalid_argument("function checkpointed_gradient(): the steps must preserve the size of the state.\n");
+		_lambda = _adjoints_of(_tape.adjoints(_out, _lambda), _in);
+	}
+	return _lambda;
+}
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_ADJOINT
@@ -0,0 +1,393 @@
+#ifndef FCPUT_COMPUTATIONAL_AUTODIFF
+#define FCPUT_COMPUTATIONAL_AUTODIFF
+
+#include "computational/common/common.hpp"
+#include "computational/mesh/grid.hpp"
+#include "algo_ds/simd/common_simd.hpp"
+#include "algo_ds/simd/sse.hpp"
+#include "algo_ds/simd/avx.hpp"
+#include "algo_ds/simd/avx512.hpp"
+
+#include <type_traits>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+/* Forward-mode automatic differentiation.
+ *
+ * A function written once for a generic scalar type (a functor with a templated `operator()`) is
+ * evaluated on dual numbers `x + ε` (ε² = 0), whose infinitesimal part carries the exact first
+ * derivative, or on hyper-dual numbers `x + ε1 + ε2` (ε1² = ε2² = 0), whose ε1ε2 part carries the
+ * exact second derivative, in a single evaluation and without truncation error.
+ *
+ * The components of the numbers may be `packed` SIMD registers, so that the function is evaluated
+ * at the `width` grid points of a register at once. Arithmetic is vectorized; the elementary
+ * functions other than `sqrt` are applied lane by lane.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Arithmetic type over the lanes of a SIMD register of the ISA extension `ISA`
+/// @details Branches on the values can't be expressed, so functors evaluated on it must be branch-free
+template <typename T, typename ISA = fcp::algods::simd::native>
+struct packed
+{
+	using pack_type = fcp::algods::simd::pack<T, ISA>;
+	using scalar_type = T;
+	constexpr static std::size_t width = pack_type::width;
+
+	typename pack_type::type v;
+
+	packed(void): v{pack_type::zero()} {}
+	packed(const typename pack_type::type& r): v{r} {}
+
+	/// @brief Broadcast of a scalar to all lanes
+	template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> and not std::is_same_v<S, typename pack_type::type>>>
+	packed(const S& s): v{pack_type::set1(static_cast<T>(s))} {}
+
+	static packed loadu(const T* p) { return packed(pack_type::loadu(p)); }
+	void storeu(T* p) const { pack_type::storeu(p, v); }
+
+	packed& operator+=(const packed& o) { v = pack_type::add(v, o.v); return *this; }
+	packed& operator-=(const packed& o) { v = pack_type::sub(v, o.v); return *this; }
+	packed& operator*=(const packed& o) { v = pack_type::mul(v, o.v); return *this; }
+	packed& operator/=(const packed& o) { v = pack_type::div(v, o.v); return *this; }
+};
+
+template <typename T, typename ISA> packed<T, ISA> operator+(packed<T, ISA> a, const packed<T, ISA>& b) { return a += b; }
+template <typename T, typename ISA> packed<T, ISA> operator-(packed<T, ISA> a, const packed<T, ISA>& b) { return a -= b; }
+template <typename T, typename ISA> packed<T, ISA> operator*(packed<T, ISA> a, const packed<T, ISA>& b) { return a *= b; }
+template <typename T, typename ISA> packed<T, ISA> operator/(packed<T, ISA> a, const packed<T, ISA>& b) { return a /= b; }
+template <typename T, typename ISA> packed<T, ISA> operator-(const packed<T, ISA>& a) { return packed<T, ISA>() - a; }
+
+namespace internal
+{
+	// Apply the scalar function `f` to every lane of `a`
+	template <typename T, typename ISA, typename F>
+	packed<T, ISA> _lanewise(const packed<T, ISA>& a, const F& f)
+	{
+		T _lanes[packed<T, ISA>::width];
+		a.storeu(_lanes);
+		for (auto& _l : _lanes)
+			_l = f(_l);
+		return packed<T, ISA>::loadu(_lanes);
+	}
+
+	// Sine and cosine together, in a single pass over the lanes
+	template <typename V>
+	std::pair<V, V> _sincos(const V& a)
+	{
+		using std::sin; using std::cos;
+		return { sin(a), cos(a) };
+	}
+
+	template <typename T, typename ISA>
+	std::pair<packed<T, ISA>, packed<T, ISA>> _sincos(const packed<T, ISA>& a)
+	{
+		T _s[packed<T, ISA>::width], _c[packed<T, ISA>::width];
+		a.storeu(_s);
+		for (std::size_t l{0}; l < packed<T, ISA>::width; l++)
+		{
+			_c[l] = std::cos(_s[l]);
+			_s[l] = std::sin(_s[l]);
+		}
+		return { packed<T, ISA>::loadu(_s), packed<T, ISA>::loadu(_c) };
+	}
+}	// namespace internal
+
+template <typename T, typename ISA> packed<T, ISA> sqrt(const packed<T, ISA>& a) { return packed<T, ISA>(packed<T, ISA>::pack_type::sqrt(a.v)); }
+template <typename T, typename ISA> packed<T, ISA> sin(const packed<T, ISA>& a) { return internal::_lanewise(a, [](const T& x) { return std::sin(x); }); }
+template <typename T, typename ISA> packed<T, ISA> cos(const packed<T, ISA>& a) { return internal::_lanewise(a, [](const T& x) { return std::cos(x); }); }
+template <typename T, typename ISA> packed<T, ISA> tan(const packed<T, ISA>& a) { return internal::_lanewise(a, [](const T& x) { return std::tan(x); }); }
+template <typename T, typename ISA> packed<T, ISA> exp(const packed<T, ISA>& a) { return internal::_lanewise(a, [](const T& x) { return std::exp(x); }); }
+template <typename T, typename ISA> packed<T, ISA> log(const packed<T, ISA>& a) { return internal::_lanewise(a, [](const T& x) { return std::log(x); }); }
+template <typename T, typename ISA> packed<T, ISA> tanh(const packed<T, ISA>& a) { return internal::_lanewise(a, [](const T& x) { return std::tanh(x); }); }
+template <typename T, typename ISA> packed<T, ISA> pow(const packed<T, ISA>& a, const typename packed<T, ISA>::scalar_type& p) { return internal::_lanewise(a, [&](const T& x) { return std::pow(x, p); }); }
+
+/// @brief Dual number `v + d ε`, with `ε² = 0`: a function evaluated at `x + ε` is `f(x) + f'(x) ε`
+/// @details `V` is a floating-point type or `packed`
+template <typename V>
+struct dual
+{
+	V v, d;
+
+	dual(void): v{}, d{} {}
+	dual(const V& value, const V& derivative = V(0)): v{value}, d{derivative} {}
+
+	template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> and not std::is_same_v<S, V>>>
+	dual(const S& s): v(s), d(0) {}
+
+	dual& operator+=(const dual& o) { v += o.v; d += o.d; return *this; }
+	dual& operator-=(const dual& o) { v -= o.v; d -= o.d; return *this; }
+	dual& operator*=(const dual& o) { d = d * o.v + v * o.d; v *= o.v; return *this; }
+	dual& operator/=(const dual& o) { const V _inv{ V(1) / o.v }; v *= _inv; d = (d - v * o.d) * _inv; return *this; }
+};
+
+/// @brief Hyper-dual number `v + d1 ε1 + d2 ε2 + d12 ε1ε2`, with `ε1² = ε2² = 0`: a function evaluated at `x + ε1 + ε2`
+/// is `f(x) + f'(x) ε1 + f'(x) ε2 + f''(x) ε1ε2`
+/// @details `V` is a floating-point type or `packed`
+template <typename V>
+struct hyper_dual
+{
+	V v, d1, d2, d12;
+
+	hyper_dual(void): v{}, d1{}, d2{}, d12{} {}
+	hyper_dual(const V& value, const V& der1 = V(0), const V& der2 = V(0), const V& der12 = V(0)): v{value}, d1{der1}, d2{der2}, d12{der12} {}
+
+	template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> and not std::is_same_v<S, V>>>
+	hyper_dual(const S& s): v(s), d1(0), d2(0), d12(0) {}
+
+	hyper_dual& operator+=(const hyper_dual& o) { v += o.v; d1 += o.d1; d2 += o.d2; d12 += o.d12; return *this; }
+	hyper_dual& operator-=(const hyper_dual& o) { v -= o.v; d1 -= o.d1; d2 -= o.d2; d12 -= o.d12; return *this; }
+	hyper_dual& operator*=(const hyper_dual& o)
+	{
+		d12 = v * o.d12 + d1 * o.d2 + d2 * o.d1 + d12 * o.v;
+		d1 = v * o.d1 + d1 * o.v;
+		d2 = v * o.d2 + d2 * o.v;
+		v *= o.v;
+		return *this;
+	}
+	hyper_dual& operator/=(const hyper_dual& o);
+};
+
+namespace internal
+{
+	template <typename> constexpr bool _is_ad_number = false;
+	template <typename V> constexpr bool _is_ad_number<dual<V>> = true;
+	template <typename V> constexpr bool _is_ad_number<hyper_dual<V>> = true;
+
+	template <typename N>
+	using _enable_number = std::enable_if_t<_is_ad_number<N>, N>;
+
+	template <typename N, typename S>
+	using _enable_scalar = std::enable_if_t<_is_ad_number<N> and std::is_arithmetic_v<S>, N>;
+
+	// Chain rule: `f(x)` from the value and the derivatives of `f` at the value of `x`
+	template <typename V>
+	dual<V> _chain(const dual<V>& x, const V& f0, const V& f1, const V&)
+	{
+		return dual<V>(f0, f1 * x.d);
+	}
+
+	template <typename V>
+	hyper_dual<V> _chain(const hyper_dual<V>& x, const V& f0, const V& f1, const V& f2)
+	{
+		return hyper_dual<V>(f0, f1 * x.d1, f1 * x.d2, f1 * x.d12 + f2 * x.d1 * x.d2);
+	}
+}	// namespace internal
+
+template <typename V>
+hyper_dual<V>& hyper_dual<V>::operator/=(const hyper_dual& o)
+{
+	const V _inv{ V(1) / o.v };
+	return *this *= internal::_chain(o, _inv, -_inv * _inv, V(2) * _inv * _inv * _inv);
+}
+
+// Arithmetic between numbers, and with scalars on either side
+
+template <typename N> internal::_enable_number<N> operator+(N a, const N& b) { return a += b; }
+template <typename N> internal::_enable_number<N> operator-(N a, const N& b) { return a -= b; }
+template <typename N> internal::_enable_number<N> operator*(N a, const N& b) { return a *= b; }
+template <typename N> internal::_enable_number<N> operator/(N a, const N& b) { return a /= b; }
+template <typename N> internal::_enable_number<N> operator-(const N& a) { return N(0) - a; }
+
+template <typename N, typename S> internal::_enable_scalar<N, S> operator+(N a, const S& b) { return a += N(b); }
+template <typename N, typename S> internal::_enable_scalar<N, S> operator-(N a, const S& b) { return a -= N(b); }
+template <typename N, typename S> internal::_enable_scalar<N, S> operator*(N a, const S& b) { return a *= N(b); }
+template <typename N, typename S> internal::_enable_scalar<N, S> operator/(N a, const S& b) { return a /= N(b); }
+template <typename S, typename N> internal::_enable_scalar<N, S> operator+(const S& a, const N& b) { return N(a) += b; }
+template <typename S, typename N> internal::_enable_scalar<N, S> operator-(const S& a, const N& b) { return N(a) -= b; }
+template <typename S, typename N> internal::_enable_scalar<N, S> operator*(const S& a, const N& b) { return N(a) *= b; }
+template <typename S, typename N> internal::_enable_scalar<N, S> operator/(const S& a, const N& b) { return N(a) /= b; }
+
+// Elementary functions
+
+template <typename N> internal::_enable_number<N> sin(const N& x)
+{
+	const auto [_s, _c] = internal::_sincos(x.v);
+	return internal::_chain(x, _s, _c, -_s);
+}
+
+template <typename N> internal::_enable_number<N> cos(const N& x)
+{
+	const auto [_s, _c] = internal::_sincos(x.v);
+	return internal::_chain(x, _c, -_s, -_c);
+}
+
+template <typename N> internal::_enable_number<N> tan(const N& x)
+{
+	using std::tan;
+	const auto _t{ tan(x.v) };
+	const auto _dt{ decltype(_t)(1) + _t * _t };
+	return internal::_chain(x, _t, _dt, decltype(_t)(2) * _t * _dt);
+}
+
+template <typename N> internal::_enable_number<N> exp(const N& x)
+{
+	using std::exp;
+	const auto _e{ exp(x.v) };
+	return internal::_chain(x, _e, _e, _e);
+}
+
+template <typename N> internal::_enable_number<N> log(const N& x)
+{
+	using std::log;
+	const auto _inv{ decltype(x.v)(1) / x.v };
+	return internal::_chain(x, log(x.v), _inv, -_inv * _inv);
+}
+
+template <typename N> internal::_enable_number<N> sqrt(const N& x)
+{
+	using std::sqrt;
+	const auto _r{ sqrt(x.v) };
+	const auto _dr{ decltype(_r)(0.5) / _r };
+	return internal::_chain(x, _r, _dr, -_dr / (decltype(_r)(2) * x.v));
+}
+
+template <typename N> internal::_enable_number<N> tanh(const N& x)
+{
+	using std::tanh;
+	const auto _t{ tanh(x.v) };
+	const auto _dt{ decltype(_t)(1) - _t * _t };
+	return internal::_chain(x, _t, _dt, decltype(_t)(-2) * _t * _dt);
+}
+
+/// @brief `x` to the scalar power `p`
+/// @details Each derivative is a power of its own, so that they are finite at `x = 0` wherever the exact ones are
+template <typename N, typename S> internal::_enable_scalar<N, S> pow(const N& x, const S& p)
+{
+	using std::pow;
+	using _v_t = decltype(x.v);
+	// Constant and identity: their vanishing derivatives would be zero times an infinite power at `x = 0`
+	if (S(0) == p)
+		return internal::_chain(x, _v_t(1), _v_t(0), _v_t(0));
+	if (S(1) == p)
+		return internal::_chain(x, x.v, _v_t(1), _v_t(0));
+	return internal::_chain(x, _v_t(pow(x.v, p)), _v_t(p) * _v_t(pow(x.v, p - 1)), _v_t(p * (p - 1)) * _v_t(pow(x.v, p - 2)));
+}
+
+namespace internal
+{
+	// Number type carrying the derivative of order `DOrder`
+	template <typename V, std::size_t DOrder>
+	using _ad_number = std::conditional_t<DOrder == 1, dual<V>, hyper_dual<V>>;
+
+	// Number at the point `x`, seeded for differentiation with respect to it
+	template <typename V, std::size_t DOrder>
+	_ad_number<V, DOrder> _ad_seed(const V& x)
+	{
+		if constexpr (DOrder == 1)
+			return dual<V>(x, V(1));
+		else
+			return hyper_dual<V>(x, V(1), V(1), V(0));
+	}
+
+	template <std::size_t DOrder, typename V>
+	V _ad_derivative(const _ad_number<V, DOrder>& y)
+	{
+		if constexpr (DOrder == 1)
+			return y.d;
+		else
+			return y.d12;
+	}
+}	// namespace internal
+
+/// @brief Differentiation of a function at the points of a grid by forward-mode automatic differentiation
+/// @details Same interface as `Differentiate`, so that the engines can be switched, but the derivatives are exact (up
+/// to rounding) and cost a single evaluation of the function per point. `Functor` must be callable on `dual` and
+/// `hyper_dual` numbers, typically through a templated `operator()` using the elementary functions unqualified (e.g.
+/// `using std::sin; return x * sin(x);`). `at_range()` evaluates it on numbers of `packed` registers of the ISA
+/// extension `ISA`, which must be `fcp::algods::simd::scalar` for functors branching on their argument
+template <typename T, class Functor, class Grid, std::size_t DiffOrder = 1, typename ISA = fcp::algods::simd::native>
+class AutoDifferentiate
+{
+	// Pre C++20 Concepts
+	static_assert(internal::is_valid_grid<Grid>, "class AutoDifferentiate: invalid Grid class passed.\n");
+	static_assert(std::is_copy_constructible<Grid>::value, "class AutoDifferentiate: Grid class is not copy constructible.\n");
+	static_assert(std::is_invocable_v<const Functor&, const dual<T>&>, "class AutoDifferentiate: Functor is not callable on dual numbers.\n");
+
+	public:
+		/// @brief Generate an `AutoDifferentiate` object
+		/// @detail During generation the `Grid` object will be copy-constructed and the `Functor` object will be default-initialized
+		AutoDifferentiate(const Grid& grid): m_grid{grid}, m_functor() {}
+		AutoDifferentiate(const Grid&& grid): m_grid{grid}, m_functor() {}
+		AutoDifferentiate(const AutoDifferentiate&) = delete;
+		AutoDifferentiate& operator=(const AutoDifferentiate&) = delete;
+		AutoDifferentiate& operator=(AutoDifferentiate&&) = delete;
+
+		/// @brief Returns differential at `i`-th grid point while providing bounds checking through `Grid::at()` method
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API T at(const std::size_t& i) const
+		{
+			return _derivative<DOrder>(m_grid.at(i));
+		}
+
+		/// @brief Returns differential at `i`-th grid point without any bounds checking
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API T operator[](const std::size_t& i) const
+		{
+			return _derivative<DOrder>(m_grid[i]);
+		}
+
+		/// @brief Compute array of values in the specified range of grid points
+		/// @details The function is evaluated on `packed` numbers, at as many grid points at once as the register lanes.
+		/// Throws `std::out_of_range` if the range exceeds the grid
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API std::vector<T> at_range(const std::size_t& from, const std::size_t& to) const
+		{
+			_check<DOrder>();
+			if (from > to or to > m_grid.end())
+				throw std::out_of_range("method AutoDifferentiate::at_range(): range out of the grid was requested.\n");
+			std::vector<T> _res(to - from);
+
+			using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, ISA, fcp::algods::simd::scalar>;
+			using _p_t = packed<T, _isa>;
+			std::size_t i{from};
+			if constexpr (_p_t::width > 1)
+			{
+				T _x[_p_t::width];
+				for (; i + _p_t::width <= to; i += _p_t::width)
+				{
+					for (std::size_t l{0}; l < _p_t::width; l++)
+						_x[l] = m_grid[i + l];
+					const auto _y{ m_functor(internal::_ad_seed<_p_t, DOrder>(_p_t::loadu(_x))) };
+					internal::_ad_derivative<DOrder, _p_t>(_y).storeu(_res.data() + (i - from));
+				}
+			}
+			for (; i < to; i++)
+				_res[i - from] = _derivative<DOrder>(m_grid[i]);
+			return _res;
+		}
+
+		/// @brief Compute array of values over all grid points and return it
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API std::vector<T> data(void) const
+		{
+			return this->at_range<DOrder>(m_grid.begin(), m_grid.end());
+		}
+
+	private:
+		template <std::size_t DOrder>
+		constexpr static void _check(void)
+		{
+			static_assert(DOrder == 1 or DOrder == 2, "class AutoDifferentiate: only first and second derivatives are supported.\n");
+		}
+
+		template <std::size_t DOrder>
+		FCP_COMPUTATIONAL_API T _derivative(const T& x) const
+		{
+			_check<DOrder>();
+			return internal::_ad_derivative<DOrder, T>(m_functor(internal::_ad_seed<T, DOrder>(x)));
+		}
+
+		Grid m_grid;
+		Functor m_functor;
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_AUTODIFF
@@ -0,0 +1,206 @@
+#ifndef FCPUT_COMPUTATIONAL_SAMPLE_CACHE
+#define FCPUT_COMPUTATIONAL_SAMPLE_CACHE
+
+#include "computational/common/common.hpp"
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+/* Caches of the samples of a function at grid points, keyed by grid index.
+ *
+ * The evaluations at single grid points (`Differentiate::at()` and `operator[]`) sample the function
+ * at every point of a stencil, so consecutive points share most of their samples. A cache policy is
+ * a type with a member template `storage<T>`, whose `get(i, sample)` returns the sample at the `i`-th
+ * grid point, calling `sample(i)` only if it is not cached:
+ *
+ *   - `no_sample_cache` calls it every time;
+ *   - `direct_mapped_sample_cache<Size>` keeps the sample of the `i`-th point in the slot `i % Size`:
+ *     a window over the last `Size` points, for sweeps in either direction, with a single comparison
+ *     per access;
+ *   - `lru_sample_cache<Capacity>` keeps the `Capacity` most recently used samples wherever they are,
+ *     for random accesses, in an open-addressing hash table and a linked list preallocated at
+ *     construction, so that no access allocates.
+ *
+ * The samples stay valid as long as the function and the grid, i.e. for the lifetime of the object
+ * owning the cache. Accessing a cache modifies it, so the objects using one must not be shared
+ * between threads.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief No caching: the function is evaluated at each access
+struct no_sample_cache
+{
+	template <typename T>
+	class storage
+	{
+		public:
+			template <typename Sample>
+			T get(const std::size_t& i, const Sample& sample) { return sample(i); }
+
+			void clear(void) {}
+	};
+};
+
+/// @brief Direct-mapped cache of `Size` samples (a power of two), for sequential sweeps over the grid
+template <std::size_t Size = 64>
+struct direct_mapped_sample_cache
+{
+	static_assert(Size > 0 and (Size & (Size - 1)) == 0, "class direct_mapped_sample_cache: the size must be a power of two.\n");
+
+	template <typename T>
+	class storage
+	{
+		public:
+			storage(void) { this->clear(); }
+
+			template <typename Sample>
+			T get(const std::size_t& i, const Sample& sample)
+			{
+				const std::size_t _slot{ i & (Size - 1) };
+				if (m_keys[_slot] != i)
+				{
+					m_values[_slot] = sample(i);
+					m_keys[_slot] = i;
+				}
+				return m_values[_slot];
+			}
+
+			void clear(void) { m_keys.fill(std::numeric_limits<std::size_t>::max()); }
+
+		private:
+			std::array<std::size_t, Size> m_keys;
+			std::array<T, Size> m_values;
+	};
+};
+
+/// @brief Least-recently-used cache of `Capacity` samples, for random accesses to the grid
+template <std::size_t Capacity = 1024>
+struct lru_sample_cache
+{
+	static_assert(Capacity > 0 and Capacity < (std::size_t{1} << 30), "class lru_sample_cache: the capacity is out of range.\n");
+
+	template <typename T>
+	class storage
+	{
+		using _index = std::uint32_t;
+		constexpr static _index _none{ std::numeric_limits<_index>::max() };
+
+		struct _node
+		{
+			std::size_t key;
+			T value;
+			_index prev, next;
+		};
+
+		public:
+			storage(void): m_nodes(Capacity)
+			{
+				// Hash table at most half full
+				while ((std::size_t{1} << m_bits) < 2 * Capacity)
+					m_bits++;
+				m_table.assign(std::size_t{1} << m_bits, _none);
+			}
+
+			template <typename Sample>
+			T get(const std::size_t& i, const Sample& sample)
+			{
+				std::size_t _slot{ this->_find(i) };
+				if (m_table[_slot] != _none)
+				{
+					const _index _n{ m_table[_slot] };
+					this->_unlink(_n);
+					this->_push_front(_n);
+					return m_nodes[_n].value;
+				}
+
+				const T _v{ sample(i) };
+				_index _n;
+				if (m_size < Capacity)
+					_n = static_cast<_index>(m_size++);
+				else
+				{
+					// Evict the least recently used sample
+					_n = m_tail;
+					this->_unlink(_n);
+					this->_erase(this->_find(m_nodes[_n].key));
+					_slot = this->_find(i);
+				}
+				m_nodes[_n].key = i;
+				m_nodes[_n].value = _v;
+				m_table[_slot] = _n;
+				this->_push_front(_n);
+				return _v;
+			}
+
+			void clear(void)
+			{
+				std::fill(m_table.begin(), m_table.end(), _none);
+				m_size = 0;
+				m_head = m_tail = _none;
+			}
+
+		private:
+			std::size_t _home(const std::size_t& key) const
+			{
+				return static_cast<std::size_t>((static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> (64 - m_bits));
+			}
+
+			// Slot of `key`, or the empty slot where it would be inserted
+			std::size_t _find(const std::size_t& key) const
+			{
+				const std::size_t _mask{ m_table.size() - 1 };
+				std::size_t _s{ this->_home(key) };
+				while (m_table[_s] != _none and m_nodes[m_table[_s]].key != key)
+					_s = (_s + 1) & _mask;
+				return _s;
+			}
+
+			// Empty the slot `s`, moving back the following entries of its probe sequence
+			void _erase(std::size_t s)
+			{
+				const std::size_t _mask{ m_table.size() - 1 };
+				for (std::size_t j{ (s + 1) & _mask }; m_table[j] != _none; j = (j + 1) & _mask)
+				{
+					const std::size_t _h{ this->_home(m_nodes[m_table[j]].key) };
+					// The entry at `j` may move to `s` if its home is not in the cyclic range (s, j]
+					if ((j > s and (_h <= s or _h > j)) or (j < s and _h <= s and _h > j))
+					{
+						m_table[s] = m_table[j];
+						s = j;
+					}
+				}
+				m_table[s] = _none;
+			}
+
+			void _unlink(const _index& n)
+			{
+				const _node& _x{ m_nodes[n] };
+				(_x.prev != _none ? m_nodes[_x.prev].next : m_head) = _x.next;
+				(_x.next != _none ? m_nodes[_x.next].prev : m_tail) = _x.prev;
+			}
+
+			void _push_front(const _index& n)
+			{
+				m_nodes[n].prev = _none;
+				m_nodes[n].next = m_head;
+				(m_head != _none ? m_nodes[m_head].prev : m_tail) = n;
+				m_head = n;
+			}
+
+			std::vector<_node> m_nodes;
+			std::vector<_index> m_table;
+			std::size_t m_bits{1}, m_size{0};
+			_index m_head{_none}, m_tail{_none};
+	};
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_SAMPLE_CACHE
@@ -0,0 +1,276 @@
+#ifndef FCPUT_COMPUTATIONAL_COMPACT
+#define FCPUT_COMPUTATIONAL_COMPACT
+
+#include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "computational/mesh/grid.hpp"
+#include "computational/differentiation/operators.hpp"
+#include "algo_ds/simd/stencil.hpp"
+#include "algo_ds/simd/tridiagonal.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
+
+#include <type_traits>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+/* Compact (Padé) finite differences on uniform grids (Lele, 1992).
+ *
+ * The derivatives at all the points are the solution of a tridiagonal system, each row coupling the
+ * derivatives at three neighbouring points to a short stencil of the samples:
+ *
+ *   alpha f'_{i-1} + f'_i + alpha f'_{i+1} = sum_k w_k f_{i+k} / h^DOrder
+ *
+ * With five samples per row, the sixth-order schemes are several times more accurate than the
+ * seven-point explicit stencils of the same order, and resolve short wavelengths far better. The rows
+ * next to the boundaries use the fourth-order scheme and the first and last ones a third-order
+ * one-sided closure. The matrix only depends on the number of points, so it is factorized once and
+ * the systems of all the lines of a field are solved together, in SIMD lanes.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Number of lines along the first axis whose systems are transposed and solved together by the compact schemes
+constexpr std::size_t compact_batch_lines{ 64 };
+
+/// @brief Number of interleaved lines (along the other axes) whose systems are solved together by the compact schemes
+/// @details Large enough for the rows of a batch to be long contiguous streams
+constexpr std::size_t compact_batch_lanes{ 1024 };
+
+namespace internal
+{
+	// Row of a compact scheme: `lower`, 1 and `upper` on the diagonals of the matrix, and the weights of the samples from
+	// `first` points away
+	template <typename T>
+	struct _compact_row
+	{
+		T lower, upper;
+		std::ptrdiff_t first;
+		std::vector<T> w;
+	};
+
+	// Rows of the first and the second point and of the interior points; the last points use their mirror images
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	FCP_COMPUTATIONAL_API std::array<_compact_row<T>, 3> _compact_scheme(void)
+	{
+		static_assert(DOrder == 1 or DOrder == 2, "compact differences: only the first and the second derivatives are supported.\n");
+		static_assert(TOrder == 4 or TOrder == 6, "compact differences: only the fourth and the sixth truncation orders are supported.\n");
+		if constexpr (DOrder == 1)
+		{
+			const _compact_row<T> _fourth{ T(1)/4, T(1)/4, -1, { T(-3)/4, T(0), T(3)/4 } };
+			return { _compact_row<T>{ T(0), T(2), 0, { T(-5)/2, T(2), T(1)/2 } }, _fourth,
+							 TOrder == 4 ? _fourth : _compact_row<T>{ T(1)/3, T(1)/3, -2, { T(-1)/36, T(-7)/9, T(0), T(7)/9, T(1)/36 } } };
+		}
+		else
+		{
+			const _compact_row<T> _fourth{ T(1)/10, T(1)/10, -1, { T(6)/5, T(-12)/5, T(6)/5 } };
+			return { _compact_row<T>{ T(0), T(11), 0, { T(13), T(-27), T(15), T(-1) } }, _fourth,
+							 TOrder == 4 ? _fourth : _compact_row<T>{ T(2)/11, T(2)/11, -2, { T(3)/44, T(12)/11, T(-51)/22, T(12)/11, T(3)/44 } } };
+		}
+	}
+
+	// Factorized system of a compact scheme over `n` points, the weights including the spacing
+	template <typename T>
+	struct _compact_system
+	{
+		std::size_t n;
+		std::vector<T> lower, cp, inv;
+		std::array<_compact_row<T>, 5> rows;	// first, second, interior, second to last and last points
+
+		const _compact_row<T>& row(const std::size_t& i) const { return rows[i < 2 ? i : i + 2 >= n ? 4 - (n - 1 - i) : 2]; }
+	};
+
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	FCP_COMPUTATIONAL_API _compact_system<T> _make_compact_system(const std::size_t& n, const T& h)
+	{
+		if (n < 5)
+			throw std::domain_error("finite differences: the grid has too few points for the requested stencil.\n");
+		const auto _scheme{ _compact_scheme<T, DOrder, TOrder>() };
+		T _scale{1};
+		for (std::size_t d{0}; d < DOrder; d++)
+			_scale /= h;
+
+		// Mirror image of a row: the derivative is odd (even) under reflection for odd (even) orders
+		auto _mirror = [](_compact_row<T> r)
+		{
+			std::reverse(r.w.begin(), r.w.end());
+			if (DOrder % 2)
+				for (auto& _w : r.w)
+					_w = -_w;
+			r.first = -(r.first + static_cast<std::ptrdiff_t>(r.w.size()) - 1);
+			std::swap(r.lower, r.upper);
+			return r;
+		};
+		_compact_system<T> _res{ n, std::vector<T>(n), std::vector<T>(n), std::vector<T>(n),
+														 { _scheme[0], _scheme[1], _scheme[2], _mirror(_scheme[1]), _mirror(_scheme[0]) } };
+		for (auto& _r : _res.rows)
+			for (auto& _w : _r.w)
+				_w *= _scale;
+
+		std::vector<T> _diag(n, T{1}), _upper(n);
+		for (std::size_t i{0}; i < n; i++)
+		{
+			_res.lower[i] = _res.row(i).lower;
+			_upper[i] = _res.row(i).upper;
+		}
+		fcp::algods::simd::tridiagonal_factor(_res.lower.data(), _diag.data(), _upper.data(), _res.cp.data(), _res.inv.data(), n);
+		return _res;
+	}
+
+	template <typename T>
+	using _compact_isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, fcp::algods::simd::native, fcp::algods::simd::scalar>;
+
+	// Right-hand sides of the `n` points of a contiguous line
+	template <typename T>
+	FCP_COMPUTATIONAL_API void _compact_rhs_line(const _compact_system<T>& sys, const T* f, T* out)
+	{
+		const _compact_row<T>& _r{ sys.rows[2] };
+		const std::size_t _n{ sys.n };
+		fcp::algods::simd::stencil(_compact_isa<T>{}, f + 2 + _r.first, _r.w.data(), _r.w.size(), out + 2, _n - 4);
+		for (const std::size_t& i : { std::size_t{0}, std::size_t{1}, _n - 2, _n - 1 })
+		{
+			const _compact_row<T>& _b{ sys.row(i) };
+			T _res{0};
+			for (std::size_t k{0}; k < _b.w.size(); k++)
+				_res += _b.w[k] * f[static_cast<std::ptrdiff_t>(i) + _b.first + static_cast<std::ptrdiff_t>(k)];
+			out[i] = _res;
+		}
+	}
+
+	// Compact differences of `lines` contiguous lines, `line_stride` apart. The right-hand sides of a batch of lines are
+	// transposed so that their systems are interleaved and solved together
+	template <typename T>
+	FCP_COMPUTATIONAL_API void _compact_contiguous(const _compact_system<T>& sys, const T* f, T* out, const std::size_t& line_stride,
+																								 const std::size_t& lines)
+	{
+		namespace simd = fcp::algods::simd;
+		const std::size_t _n{ sys.n };
+		if (1 == lines)
+		{
+			_compact_rhs_line(sys, f, out);
+			simd::tridiagonal_solve(simd::scalar{}, sys.lower.data(), sys.cp.data(), sys.inv.data(), out, _n, 1, 1);
+			return;
+		}
+
+		std::vector<T, fcp::algods::aligned_allocator<T>> _buf(_n * compact_batch_lines), _line(_n);
+		for (std::size_t l0{0}; l0 < lines; l0 += compact_batch_lines)
+		{
+			const std::size_t _b{ std::min(compact_batch_lines, lines - l0) };
+			for (std::size_t l{0}; l < _b; l++)
+			{
+				_compact_rhs_line(sys, f + (l0 + l) * line_stride, _line.data());
+				for (std::size_t i{0}; i < _n; i++)
+					_buf[i * compact_batch_lines + l] = _line[i];
+			}
+			simd::tridiagonal_solve(_compact_isa<T>{}, sys.lower.data(), sys.cp.data(), sys.inv.data(), _buf.data(), _n, compact_batch_lines, _b);
+			for (std::size_t l{0}; l < _b; l++)
+			{
+				T* _out{ out + (l0 + l) * line_stride };
+				for (std::size_t i{0}; i < _n; i++)
+					_out[i] = _buf[i * compact_batch_lines + l];
+			}
+		}
+	}
+
+	// Compact differences of `lanes` interleaved lines: the `i`-th point of the `l`-th line is at `i * stride + l`. Each batch
+	// of lines has its right-hand sides computed as linear combinations of rows of samples, then its systems solved in place
+	template <typename T>
+	FCP_COMPUTATIONAL_API void _compact_interleaved(const _compact_system<T>& sys, const T* f, T* out, const std::size_t& stride,
+																									const std::size_t& lanes)
+	{
+		namespace simd = fcp::algods::simd;
+		const std::size_t _n{ sys.n };
+		std::vector<const T*> _rows;
+		for (std::size_t l0{0}; l0 < lanes; l0 += compact_batch_lanes)
+		{
+			const std::size_t _b{ std::min(compact_batch_lanes, lanes - l0) };
+			for (std::size_t i{0}; i < _n; i++)
+			{
+				const _compact_row<T>& _r{ sys.row(i) };
+				_rows.clear();
+				for (std::size_t k{0}; k < _r.w.size(); k++)
+					_rows.push_back(f + (static_cast<std::ptrdiff_t>(i) + _r.first + static_cast<std::ptrdiff_t>(k)) * static_cast<std::ptrdiff_t>(stride) + l0);
+				simd::linear_combination(_compact_isa<T>{}, _rows.data(), _r.w.data(), _r.w.size(), out + i * stride + l0, _b);
+			}
+			simd::tridiagonal_solve(_compact_isa<T>{}, sys.lower.data(), sys.cp.data(), sys.inv.data(), out + l0, _n, stride, _b);
+		}
+	}
+}	// namespace internal
+
+/// @brief Compact differentiation of data sampled at the points of a uniform grid
+/// @details The samples are not copied: the object is a view over them, which must outlive it. The tridiagonal matrix of
+/// the scheme is factorized here, once, so the samples may be updated in place and differentiated again at the cost of
+/// a stencil and two sweeps. Only `DiffOrder` 1 and 2 and `TruncationOrder` 4 and 6 are supported; throws
+/// `std::domain_error` if the grid has fewer than 5 points
+template <typename T, class Grid, std::size_t TruncationOrder = 6, std::size_t DiffOrder = 1>
+class CompactDifferentiation
+{
+	// Pre C++20 Concepts
+	static_assert(internal::is_valid_grid<Grid>, "class CompactDifferentiation: invalid Grid class passed.\n");
+	static_assert(std::is_copy_constructible<Grid>::value, "class CompactDifferentiation: Grid class is not copy constructible.\n");
+	static_assert(Grid::is_uniform_v, "class CompactDifferentiation: compact schemes need a uniform grid.\n");
+
+	public:
+		/// @brief Generate a `CompactDifferentiation` object over `samples`, the values at the points of `grid`
+		/// @details Throws `std::invalid_argument` if the number of samples differs from the one of the grid points
+		CompactDifferentiation(const span<const T>& samples, const Grid& grid)
+			: m_samples{samples}, m_grid{grid},
+				m_system{ internal::_make_compact_system<T, DiffOrder, TruncationOrder>(m_grid.end() - m_grid.begin(), m_grid[1] - m_grid[0]) }
+		{
+			if (m_samples.size() != m_grid.end() - m_grid.begin())
+				throw std::invalid_argument("class CompactDifferentiation: the number of samples differs from the number of grid points.\n");
+		}
+
+		/// @brief Write the differentials at all grid points into `out`
+		/// @details Throws `std::out_of_range` if the size of `out` differs from the number of samples. `out` must not overlap them
+		FCP_COMPUTATIONAL_API void data(const span<T>& out) const
+		{
+			if (out.size() != m_samples.size())
+				throw std::out_of_range("method CompactDifferentiation::data(): the output size differs from the number of samples.\n");
+			internal::_compact_contiguous(m_system, m_samples.data(), out.data(), m_samples.size(), 1);
+		}
+
+		/// @brief Compute the differentials at all grid points and return them
+		FCP_COMPUTATIONAL_API std::vector<T> data(void) const
+		{
+			std::vector<T> _res(m_samples.size());
+			this->data(_res);
+			return _res;
+		}
+
+		/// @brief Number of samples (and grid points)
+		std::size_t size(void) const { return m_samples.size(); }
+
+	private:
+		span<const T> m_samples;
+		Grid m_grid;
+		internal::_compact_system<T> m_system;
+};
+
+/// @brief `DOrder`-th partial derivative of the field `f` along the axis `Axis` by a compact scheme, written into `out`
+/// @details Along the first axis the lines are contiguous, and batches of `compact_batch_lines` of them are transposed to
+/// solve their systems together; along the other axes consecutive lines are interleaved already, and are solved by
+/// batches of `compact_batch_lanes`. Throws
+/// `std::invalid_argument` if the sizes of the fields differ from the one of the grid, `std::domain_error` if the axis
+/// has fewer than 5 points
+template <std::size_t Axis, std::size_t DOrder = 1, std::size_t TOrder = 6, typename T, std::size_t D>
+FCP_COMPUTATIONAL_API void compact_partial(const StructuredGrid<T, D>& grid, const internal::_nd_in<T>& f, const internal::_nd_out<T>& out)
+{
+	static_assert(Axis < D, "function compact_partial(): the axis exceeds the dimensions of the grid.\n");
+	internal::_check_fields("function compact_partial(): the fields must have one value per grid point.\n", grid, { f.size(), out.size() });
+	const std::size_t _n{ grid.extent(Axis) }, _s{ grid.stride(Axis) };
+	const auto _sys{ internal::_make_compact_system<T, DOrder, TOrder>(_n, grid.spacing(Axis)) };
+	if constexpr (Axis == 0)
+		internal::_compact_contiguous(_sys, f.data(), out.data(), _n, grid.size() / _n);
+	else
+		for (std::size_t o{0}; o < grid.size(); o += _n * _s)
+			internal::_compact_interleaved(_sys, f.data() + o, out.data() + o, _s, _s);
+}
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_COMPACT
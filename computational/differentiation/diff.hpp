@@ -2,12 +2,22 @@
 #define FCPUT_COMPUTATIONAL_DIFFERENTIATION
 
 #include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "computational/common/thread_pool.hpp"
 #include "computational/mesh/grid.hpp"
+#include "computational/differentiation/fornberg.hpp"
+#include "computational/differentiation/cache.hpp"
+#include "algo_ds/simd/stencil.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
 
 #include <type_traits>
 #include <cmath>
 #include <array>
 #include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 START_FCP_NAMESPACE
 START_COMPUTATIONAL_NAMESPACE
@@ -17,9 +27,401 @@ struct central_difference{};
 struct forward_difference{};  
 struct backward_difference{}; 
 
+/// @brief Number of grid points differentiated by each task of the parallel evaluations
+/// @details Chosen so that the samples and the results of a task fit in the L2 cache
+constexpr std::size_t parallel_diff_chunk{ 1 << 14 };
+
+/// @brief Number of grid points of each field differentiated together by the batched evaluations on non-uniform grids
+/// @details Chosen so that the stencil weights of a tile stay in the L1 cache while all the fields go through it
+constexpr std::size_t batch_diff_tile{ 1 << 9 };
+
+namespace internal
+{
+	// Number of stencil points of a method: the fewest giving truncation order `TOrder` (the symmetry of the central
+	// stencils gains an order for even differentiation orders)
+	template <typename Method, std::size_t DOrder, std::size_t TOrder>
+	constexpr std::size_t _stencil_size = std::is_same_v<Method, central_difference> ? 2 * ((DOrder + 1) / 2) - 1 + TOrder : DOrder + TOrder;
+
+	// Stencil points of a method, in grid spacings from the differentiated point
+	template <typename Method, std::size_t DOrder, std::size_t TOrder>
+	constexpr std::array<int, _stencil_size<Method, DOrder, TOrder>> _stencil_offsets(void)
+	{
+		constexpr int _N{ static_cast<int>(_stencil_size<Method, DOrder, TOrder>) };
+		constexpr int _first{ std::is_same_v<Method, central_difference> ? -(_N / 2) : std::is_same_v<Method, forward_difference> ? 0 : 1 - _N };
+		std::array<int, _N> _res{};
+		for (int k{0}; k < _N; k++)
+			_res[k] = _first + k;
+		return _res;
+	}
+
+	// Coefficients of the central, forward and backward differences on uniform grids, indexed by differentiation order and
+	// truncation order (the exponent of the grid spacing in the error term), generated at compile time (see fornberg.hpp)
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	constexpr auto _cd_lut = finite_difference_weights<T, DOrder>(_stencil_offsets<central_difference, DOrder, TOrder>());
+
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	constexpr auto _fd_lut = finite_difference_weights<T, DOrder>(_stencil_offsets<forward_difference, DOrder, TOrder>());
+
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	constexpr auto _bd_lut = finite_difference_weights<T, DOrder>(_stencil_offsets<backward_difference, DOrder, TOrder>());
+
+	// Coefficients of a method and position of the first stencil point relative to the differentiated one
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder>
+	struct _stencil;
+
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	struct _stencil<T, central_difference, DOrder, TOrder>
+	{
+		constexpr static auto coeff = _cd_lut<T, DOrder, TOrder>;
+		constexpr static std::ptrdiff_t first = -static_cast<std::ptrdiff_t>(coeff.size() / 2);
+	};
+
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	struct _stencil<T, forward_difference, DOrder, TOrder>
+	{
+		constexpr static auto coeff = _fd_lut<T, DOrder, TOrder>;
+		constexpr static std::ptrdiff_t first = 0;
+	};
+
+	template <typename T, std::size_t DOrder, std::size_t TOrder>
+	struct _stencil<T, backward_difference, DOrder, TOrder>
+	{
+		constexpr static auto coeff = _bd_lut<T, DOrder, TOrder>;
+		constexpr static std::ptrdiff_t first = 1 - static_cast<std::ptrdiff_t>(coeff.size());
+	};
+
+	// Stencil of a method, and the one-sided ones used near the first and the last grid points
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder>
+	struct _stencils
+	{
+		using interior = _stencil<T, Method, DOrder, TOrder>;
+		using left = _stencil<T, forward_difference, DOrder, TOrder>;
+		using right = _stencil<T, backward_difference, DOrder, TOrder>;
+
+		// Farthest grid point used by any of the stencils, in either direction
+		constexpr static std::size_t reach = std::max({ interior::coeff.size(), left::coeff.size(), right::coeff.size() });
+
+		constexpr static void check(void)
+		{
+			static_assert(TOrder > 0, "finite differences: truncation order must be a positive number.\n");
+			static_assert(DOrder > 0, "finite differences: differential order must be a positive number.\n");
+			static_assert(not std::is_same_v<Method, central_difference> or TOrder % 2 == 0,
+										"finite differences: truncation order for central difference approximation must be even.\n");
+		}
+	};
+
+	// Factor of the coefficients on a uniform grid: 1/h^DOrder
+	template <std::size_t DOrder, typename T, class Grid>
+	FCP_COMPUTATIONAL_API T _spacing_factor(const Grid& grid)
+	{
+		const T _h{ grid[1] - grid[0] };
+		T _hd{1};
+		for (std::size_t d{0}; d < DOrder; d++)
+			_hd *= _h;
+		return T{1} / _hd;
+	}
+
+	// First grid point of the stencil `S` at the `i`-th of `n` grid points; throws if the stencil doesn't fit in the grid
+	template <typename S>
+	FCP_COMPUTATIONAL_API std::size_t _stencil_start(const std::size_t& i, const std::size_t& n)
+	{
+		const std::ptrdiff_t _j{ static_cast<std::ptrdiff_t>(i) + S::first };
+		if (_j < 0 or static_cast<std::size_t>(_j) + S::coeff.size() > n)
+			throw std::domain_error("finite differences: the grid has too few points for the requested stencil.\n");
+		return static_cast<std::size_t>(_j);
+	}
+
+	// Apply the stencil `S` at the `i`-th of `n` grid points, `sample(j)` being the function at the `j`-th one
+	template <typename S, typename T, typename Sample>
+	FCP_COMPUTATIONAL_API T _stencil_dot(const std::size_t& i, const std::size_t& n, const T& scale, const Sample& sample)
+	{
+		const std::size_t _j{ _stencil_start<S>(i, n) };
+		T _res{0};
+		for (std::size_t k{0}; k < S::coeff.size(); k++)
+			_res += S::coeff[k] * scale * sample(_j + k);
+		return _res;
+	}
+
+	// Call `f` with (a default-constructed object of) the stencil used at the `i`-th of `n` grid points: the method's one
+	// if it fits in the grid, a one-sided one otherwise
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, typename F>
+	FCP_COMPUTATIONAL_API auto _select_stencil(const std::size_t& i, const std::size_t& n, const F& f)
+	{
+		using _S = _stencils<T, Method, DOrder, TOrder>;
+		const std::ptrdiff_t _j{ static_cast<std::ptrdiff_t>(i) + _S::interior::first };
+		if (_j < 0)
+			return f(typename _S::left{});
+		else if (static_cast<std::size_t>(_j) + _S::interior::coeff.size() > n)
+			return f(typename _S::right{});
+		else
+			return f(typename _S::interior{});
+	}
+
+	// Differential at the `i`-th grid point with the method's stencil if it fits in the grid, a one-sided one otherwise
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, typename Sample>
+	FCP_COMPUTATIONAL_API T _finite_diff_at(const std::size_t& i, const std::size_t& n, const T& scale, const Sample& sample)
+	{
+		return _select_stencil<T, Method, DOrder, TOrder>(i, n, [&](auto s) { return _stencil_dot<decltype(s)>(i, n, scale, sample); });
+	}
+
+	// Points of [from, to) where the stencil `S` fits in a grid of `n` points: [first, second)
+	template <typename S>
+	FCP_COMPUTATIONAL_API std::pair<std::size_t, std::size_t> _interior_range(const std::size_t& n, const std::size_t& from, const std::size_t& to)
+	{
+		const std::ptrdiff_t _last{ static_cast<std::ptrdiff_t>(n) - static_cast<std::ptrdiff_t>(S::coeff.size()) - S::first };
+		return { std::max(from, static_cast<std::size_t>(-S::first)), _last < 0 ? 0 : std::min(to, static_cast<std::size_t>(_last) + 1) };
+	}
+
+	// Differentials at the grid points [from, to) of `n`, written to `out`. `samples[j]` is the function at the
+	// grid point `first + j` and must cover the `reach` points around the range (clipped to the grid)
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder>
+	FCP_COMPUTATIONAL_API void _finite_diff_range(const T* samples, const std::size_t& first, const std::size_t& n, const T& scale,
+																								const std::size_t& from, const std::size_t& to, T* out)
+	{
+		namespace simd = fcp::algods::simd;
+		using _I = typename _stencils<T, Method, DOrder, TOrder>::interior;
+		constexpr std::size_t _N{ _I::coeff.size() };
+
+		// Points where the method's stencil fits in the grid: [_lo, _hi)
+		const auto [_lo, _hi] = _interior_range<_I>(n, from, to);
+		if (_lo < _hi)
+		{
+			std::array<T, _N> _coeff;
+			for (std::size_t k{0}; k < _N; k++)
+				_coeff[k] = _I::coeff[k] * scale;
+			using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, simd::native, simd::scalar>;
+			simd::stencil(_isa{}, samples + (_lo - first) + _I::first, _coeff.data(), _N, out + (_lo - from), _hi - _lo);
+		}
+
+		// Boundary points
+		auto _sample = [&](const std::size_t& j) { return samples[j - first]; };
+		for (std::size_t i{from}; i < std::min(_lo, to); i++)
+			out[i - from] = _finite_diff_at<T, Method, DOrder, TOrder>(i, n, scale, _sample);
+		for (std::size_t i{std::max(_lo, _hi)}; i < to; i++)
+			out[i - from] = _finite_diff_at<T, Method, DOrder, TOrder>(i, n, scale, _sample);
+	}
+
+	// Stencil weights of the grid points [from, to) of a non-uniform grid, computed once per point and reused by every
+	// evaluation. The stencil of the `i`-th point starts at the grid point `start[i - from]`, and the weight of its `k`-th
+	// point is `weights[k * (to - from) + i - from]`: one row per stencil point (zero past the end of a shorter stencil),
+	// so that the weights of consecutive grid points are contiguous like their samples
+	template <typename T>
+	struct _weight_table
+	{
+		std::size_t from{0}, to{0};
+		std::vector<T, fcp::algods::aligned_allocator<T>> weights;
+		std::vector<std::size_t> start;
+	};
+
+	// Weights of the same stencils as on a uniform grid (see `_select_stencil()`), from Fornberg's algorithm on the
+	// actual grid points; they already include the spacings
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, class Grid>
+	FCP_COMPUTATIONAL_API _weight_table<T> _make_weight_table(const Grid& grid, const std::size_t& from, const std::size_t& to)
+	{
+		using _S = _stencils<T, Method, DOrder, TOrder>;
+		_S::check();
+		const std::size_t _n{ grid.end() }, _m{ to - from };
+		_weight_table<T> _res{ from, to, std::vector<T, fcp::algods::aligned_allocator<T>>(_S::reach * _m), std::vector<std::size_t>(_m) };
+		for (std::size_t i{from}; i < to; i++)
+			_res.start[i - from] = _select_stencil<T, Method, DOrder, TOrder>(i, _n, [&](auto s)
+			{
+				using _s_t = decltype(s);
+				const std::size_t _j{ _stencil_start<_s_t>(i, _n) };
+				std::array<T, _s_t::coeff.size()> _x;
+				for (std::size_t k{0}; k < _x.size(); k++)
+					_x[k] = grid[_j + k] - grid[i];
+				const auto _w{ finite_difference_weights<DOrder>(_x, T{0}) };
+				for (std::size_t k{0}; k < _w.size(); k++)
+					_res.weights[k * _m + i - from] = _w[k];
+				return _j;
+			});
+		return _res;
+	}
+
+	// Differential at the `i`-th of `n` grid points from a weight table: gather and dot product
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, typename Sample>
+	FCP_COMPUTATIONAL_API T _weighted_diff_at(const _weight_table<T>& table, const std::size_t& i, const std::size_t& n, const Sample& sample)
+	{
+		const std::size_t _m{ table.to - table.from }, _j{ table.start[i - table.from] };
+		const std::size_t _N{ _select_stencil<T, Method, DOrder, TOrder>(i, n, [](auto s) { return decltype(s)::coeff.size(); }) };
+		const T* _w{ table.weights.data() + (i - table.from) };
+		T _res{0};
+		for (std::size_t k{0}; k < _N; k++)
+			_res += _w[k * _m] * sample(_j + k);
+		return _res;
+	}
+
+	// `_finite_diff_range()` on a non-uniform grid, with the weights of `table` (covering [from, to)). The samples under
+	// the method's stencil are contiguous, so the interior points are vectorized like on a uniform grid, loading a
+	// register of weights per stencil point
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder>
+	FCP_COMPUTATIONAL_API void _weighted_diff_range(const _weight_table<T>& table, const T* samples, const std::size_t& first, const std::size_t& n,
+																									const std::size_t& from, const std::size_t& to, T* out)
+	{
+		namespace simd = fcp::algods::simd;
+		using _I = typename _stencils<T, Method, DOrder, TOrder>::interior;
+
+		const auto [_lo, _hi] = _interior_range<_I>(n, from, to);
+		if (_lo < _hi)
+		{
+			using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, simd::native, simd::scalar>;
+			simd::variable_stencil(_isa{}, samples + (_lo - first) + _I::first, table.weights.data() + (_lo - table.from), table.to - table.from,
+														 _I::coeff.size(), out + (_lo - from), _hi - _lo);
+		}
+
+		// Boundary points
+		auto _sample = [&](const std::size_t& j) { return samples[j - first]; };
+		for (std::size_t i{from}; i < std::min(_lo, to); i++)
+			out[i - from] = _weighted_diff_at<T, Method, DOrder, TOrder>(table, i, n, _sample);
+		for (std::size_t i{std::max(_lo, _hi)}; i < to; i++)
+			out[i - from] = _weighted_diff_at<T, Method, DOrder, TOrder>(table, i, n, _sample);
+	}
+
+	// Differential at the `i`-th grid point on any grid. On non-uniform grids `table` holds the weights of the whole grid
+	// if they were cached for these orders, otherwise it is null and the weights of the point are computed
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, class Grid, typename Sample>
+	FCP_COMPUTATIONAL_API T _grid_diff_at(const Grid& grid, const _weight_table<T>* table, const std::size_t& i, const Sample& sample)
+	{
+		if constexpr (Grid::is_uniform_v)
+			return _finite_diff_at<T, Method, DOrder, TOrder>(i, grid.end(), _spacing_factor<DOrder, T>(grid), sample);
+		else if (table)
+			return _weighted_diff_at<T, Method, DOrder, TOrder>(*table, i, grid.end(), sample);
+		else
+			return _weighted_diff_at<T, Method, DOrder, TOrder>(_make_weight_table<T, Method, DOrder, TOrder>(grid, i, i + 1), i, grid.end(), sample);
+	}
+
+	// Differentials at the grid points [from, to) on any grid (see `_finite_diff_range()` and `_grid_diff_at()`)
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, class Grid>
+	FCP_COMPUTATIONAL_API void _grid_diff_range(const Grid& grid, const _weight_table<T>* table, const T* samples, const std::size_t& first,
+																							const std::size_t& from, const std::size_t& to, T* out)
+	{
+		if constexpr (Grid::is_uniform_v)
+			_finite_diff_range<T, Method, DOrder, TOrder>(samples, first, grid.end(), _spacing_factor<DOrder, T>(grid), from, to, out);
+		else if (table)
+			_weighted_diff_range<T, Method, DOrder, TOrder>(*table, samples, first, grid.end(), from, to, out);
+		else
+			_weighted_diff_range<T, Method, DOrder, TOrder>(_make_weight_table<T, Method, DOrder, TOrder>(grid, from, to), samples, first, grid.end(),
+																											from, to, out);
+	}
+
+	// Weights of the grid points [from, to) on a non-uniform grid: `cached` if not null (it covers the whole grid),
+	// otherwise computed into `storage`. Null on uniform grids, which don't need them
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, class Grid>
+	inline const _weight_table<T>* _range_weights(const Grid& grid, const _weight_table<T>* cached, const std::size_t& from, const std::size_t& to,
+																								_weight_table<T>& storage)
+	{
+		if constexpr (Grid::is_uniform_v)
+			return nullptr;
+		else
+		{
+			if (cached or from == to) return cached;
+			storage = _make_weight_table<T, Method, DOrder, TOrder>(grid, from, to);
+			return &storage;
+		}
+	}
+
+	// Differentials at the grid points [from, to) of `fields` fields, the `f`-th sampled at `samples + f * stride` and
+	// differentiated into `out + f * out_stride`. The stencil is selected (and on non-uniform grids its weights are looked
+	// up) once per point for all the fields: on uniform grids its coefficients stay in registers over all of them, on
+	// non-uniform ones the fields go through tiles of `batch_diff_tile` points whose weights stay in the cache
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder, class Grid>
+	FCP_COMPUTATIONAL_API void _batch_diff_range(const Grid& grid, const _weight_table<T>* table, const T* samples, const std::size_t& stride,
+																							 const std::size_t& fields, const std::size_t& from, const std::size_t& to, T* out,
+																							 const std::size_t& out_stride)
+	{
+		namespace simd = fcp::algods::simd;
+		using _I = typename _stencils<T, Method, DOrder, TOrder>::interior;
+		using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, simd::native, simd::scalar>;
+		constexpr std::size_t _N{ _I::coeff.size() };
+		const std::size_t _n{ grid.end() };
+
+		_weight_table<T> _table;
+		table = _range_weights<T, Method, DOrder, TOrder>(grid, table, from, to, _table);
+		T _scale{1};
+		if constexpr (Grid::is_uniform_v)
+			_scale = _spacing_factor<DOrder, T>(grid);
+
+		const auto [_lo, _hi] = _interior_range<_I>(_n, from, to);
+		if (_lo < _hi)
+		{
+			if constexpr (Grid::is_uniform_v)
+			{
+				std::array<T, _N> _coeff;
+				for (std::size_t k{0}; k < _N; k++)
+					_coeff[k] = _I::coeff[k] * _scale;
+				simd::batched_stencil<_N>(_isa{}, samples + _lo + _I::first, stride, _coeff.data(), out + (_lo - from), out_stride, _hi - _lo, fields);
+			}
+			else
+				for (std::size_t t{_lo}; t < _hi; t += batch_diff_tile)
+				{
+					const std::size_t _m{ std::min(_hi - t, batch_diff_tile) };
+					for (std::size_t f{0}; f < fields; f++)
+						simd::variable_stencil(_isa{}, samples + f * stride + t + _I::first, table->weights.data() + (t - table->from), table->to - table->from,
+																	 _N, out + f * out_stride + (t - from), _m);
+				}
+		}
+
+		// Boundary points
+		auto _point = [&](const std::size_t& i)
+		{
+			_select_stencil<T, Method, DOrder, TOrder>(i, _n, [&](auto s)
+			{
+				using _s_t = decltype(s);
+				std::array<T, _s_t::coeff.size()> _w;
+				std::size_t _j;
+				if constexpr (Grid::is_uniform_v)
+				{
+					_j = _stencil_start<_s_t>(i, _n);
+					for (std::size_t k{0}; k < _w.size(); k++)
+						_w[k] = _s_t::coeff[k] * _scale;
+				}
+				else
+				{
+					_j = table->start[i - table->from];
+					for (std::size_t k{0}; k < _w.size(); k++)
+						_w[k] = table->weights[k * (table->to - table->from) + i - table->from];
+				}
+				for (std::size_t f{0}; f < fields; f++)
+				{
+					T _res{0};
+					for (std::size_t k{0}; k < _w.size(); k++)
+						_res += _w[k] * samples[f * stride + _j + k];
+					out[f * out_stride + i - from] = _res;
+				}
+			});
+		};
+		for (std::size_t i{from}; i < std::min(_lo, to); i++)
+			_point(i);
+		for (std::size_t i{std::max(_lo, _hi)}; i < to; i++)
+			_point(i);
+	}
+
+	// Split [from, to) into chunks of `parallel_diff_chunk` points, strided over `threads` tasks (as many as the hardware
+	// threads if zero) run by the shared thread pool. Each task calls `make_worker()` once and the returned object on each
+	// of its chunks; the first exception thrown by a task is rethrown once all of them are done
+	template <typename MakeWorker>
+	inline void _parallel_chunks(const std::size_t& from, const std::size_t& to, std::size_t threads, const MakeWorker& make_worker)
+	{
+		const std::size_t _chunks{ (to - from + parallel_diff_chunk - 1) / parallel_diff_chunk };
+		if (0 == threads) threads = thread_pool::shared().size() + 1;
+		if (threads > _chunks) threads = _chunks;
+
+		thread_pool::shared().run(threads, [&](const std::size_t& t)
+		{
+			auto _worker = make_worker();
+			for (std::size_t c{t}; c < _chunks; c += threads)
+			{
+				const std::size_t _from{ from + c * parallel_diff_chunk };
+				_worker(_from, std::min(to, _from + parallel_diff_chunk));
+			}
+		});
+	}
+}	// namespace internal
+
 template <typename T, class Functor, class Grid,
 				  typename Method = central_difference, std::size_t TruncationOrder = 2,
-					std::size_t DiffOrder = 1, std::size_t Dimensions = 1>	// TODO
+					std::size_t DiffOrder = 1, std::size_t Dimensions = 1,	// TODO
+					typename SampleCache = no_sample_cache>
 class Differentiate
 {
 	// Pre C++20 Concepts
@@ -33,36 +435,56 @@ class Differentiate
 
 	public:
 		/// @brief Generate a `Differentiate` object
-		/// @detail During generation the `Grid` object will be copy-constructed and the `Functor` object will be default-initialized
-		Differentiate(const Grid& grid): m_grid{grid}, m_functor() {}
-		Differentiate(const Grid&& grid): m_grid{grid}, m_functor() {}
+		/// @detail During generation the `Grid` object will be copy-constructed and the `Functor` object will be default-initialized.
+		/// On a non-uniform grid the stencil weights of every grid point for the default orders are computed here, once
+		Differentiate(const Grid& grid): m_grid{grid}, m_functor(), m_weights{ _default_weights(m_grid) } {}
+		Differentiate(const Grid&& grid): m_grid{grid}, m_functor(), m_weights{ _default_weights(m_grid) } {}
 		Differentiate(const Differentiate&) = delete;
 		Differentiate& operator=(const Differentiate&) = delete;
 		Differentiate& operator=(Differentiate&&) = delete;
 
 		/// @brief Returns differential at `i`-th grid point while providing bounds checking through `Grid::at()` method (only if in debug mode)
-		/// @details The points that may not be computable by the chosen method will be approximated by the other ones. For example, the central method of the second order will use the forward difference approximation for the first point and the backward difference approximation for the last one 
+		/// @details The points that may not be computable by the chosen method will be approximated by the other ones. For example, the central method of the second order will use the forward difference approximation for the first point and the backward difference approximation for the last one.
+		/// The samples of the function go through the `SampleCache` policy (see cache.hpp), which keeps them across calls:
+		/// with a cache other than `no_sample_cache`, `at()` and `operator[]` must not be called by several threads at once
 		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
 		FCP_COMPUTATIONAL_API T at(const std::size_t& i) const 
 		{ 
-			return _finite_diff_single_value<DOrder, TOrder>(i, true, Method());
+			return _finite_diff_single_value<DOrder, TOrder>(i, true);
 		}
 
 		/// @brief Returns differential at `i`-th grid point without any bounds checking
 		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
 		FCP_COMPUTATIONAL_API T operator[](const std::size_t& i) const 
 		{ 
-			return _finite_diff_single_value<DOrder, TOrder>(i, false, Method()); 
+			return _finite_diff_single_value<DOrder, TOrder>(i, false); 
 		}
 		
 		/// @brief Compute array of values in the specified range of grid points
+		/// @details The function is evaluated once per grid point reached by the stencils of the range, into an aligned
+		/// buffer, and the stencil of the method is applied to all the points it fits by vectorized sliding-window dot
+		/// products; only the points near the grid ends, which need one-sided stencils, are computed one by one.
+		/// Throws `std::out_of_range` if the range exceeds the grid
 		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
 		FCP_COMPUTATIONAL_API std::vector<T> at_range(const std::size_t& from, const std::size_t& to) const
 		{
-			std::vector<T> temp;
-			for (std::size_t i{from}; i < to; i++)
-				temp.push_back(this->at<DOrder, TOrder>(i));
-			return temp;
+			using _S = internal::_stencils<T, Method, DOrder, TOrder>;
+			_S::check();
+
+			const std::size_t _n{ m_grid.end() };
+			if (from > to or to > _n)
+				throw std::out_of_range("method Differentiate::at_range(): range out of the grid was requested.\n");
+			std::vector<T> _res(to - from);
+			if (from == to) return _res;
+
+			// Sample the function once
+			const std::size_t _s0{ from > _S::reach ? from - _S::reach : 0 }, _s1{ std::min(_n, to + _S::reach) };
+			std::vector<T, fcp::algods::aligned_allocator<T>> _samples(_s1 - _s0);
+			for (std::size_t j{_s0}; j < _s1; j++)
+				_samples[j - _s0] = m_functor(m_grid[j]);
+
+			internal::_grid_diff_range<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), _samples.data(), _s0, from, to, _res.data());
+			return _res;
 		}
 
 		/// @brief Compute array of values over all grid points and return it
@@ -74,170 +496,298 @@ class Differentiate
 			return this->at_range<DOrder, TOrder>(m_grid.begin(), m_grid.end());
 		}
 
-	private:
-		// Private implementation of differentiation methods
-
-		// Lookup table for pre-calculated values used by the central difference method
-		static constexpr std::array<T, 6> _cd_lut {
-			std::array<T, 4> {	// First differentiation order 
-				std::array<T, 3> { -1/2, 0, 1/2 },	// Second truncation order
-				std::array<T, 5> { 1/12, -2/3, 0, 2/3, -1/12},	// Fourth truncation order
-				std::array<T, 7> { -1/60, 3/20, -3/4, 0, 3/4, -3/20, 1/60},	// Sixth truncation order
-				std::array<T, 9> { 1/280,	-4/105,	1/5,	-4/5,	0,	4/5,	-1/5,	4/105,	-1/280}	// Eighth truncation order
-			},
-			std::array<T, 4> {	// Second differentiation order
-				std::array<T, 3> { 1, -2, 1 },	// Second truncation order
-				std::array<T, 5> { -1/12, 4/3, -5/2, 4/3, -1/12 },	// Fourth truncation order
-				std::array<T, 7> { 1/90, -3/20, 3/2, -49/18, 3/2, -3/20, 1/90 },	// Sixth truncation order
-				std::array<T, 9> { -1/560, 8/315, -1/5, 8/5, -205/72, 8/5, -1/5, 8/315, -1/560 }	// Eighth truncation order
-			},
-			std::array<T, 3> {	// Third differentiation order
-				std::array<T, 5> { -1/2, 1, 0, -1, 1/2 },	// Second truncation order
-				std::array<T, 7> { 1/8, -1, 13/8, 0, -13/8, 1, -1/8 },	// Fourth truncation order
-				std::array<T, 9> { -7/240, 3/10, -169/120, 61/30, 0, -61/30, 169/120, -3/10, 7/240 }	// Sixth truncation order
-			},
-			std::array<T, 3> {	// Fourth differentiation order
-				std::array<T, 5> { 1, -4, 6, -4, 1 },	// Second truncation order		
-				std::array<T, 7> { -1/6, 2, -13/2, 28/3, -13/2, 2, -1/6 },	// Fourth truncation order
-				std::array<T, 9> { 7/240, -2/5, 169/60, -122/15, 91/8, -122/15, 169/60, -2/5, 7/240 }	// Sixth truncation order
-			},
-			std::array<T, 3> {	// Fifth differentiation order
-				std::array<T, 7> { -1/2, 2, -5/2, 0, 5/2, -2, 1/2 },	// Second truncation order
-				std::array<T, 9> { 1/6, -3/2, 13/3, -29/6, 0, 29/6, -13/3, 3/2, -1/6 },	// Fourth truncation order
-				std::array<T, 11> { -13/288, 19/36, -87/32, 13/2, -323/48, 0, 323/48, -13/2, 87/32, -19/36, 13/288 }	// Sixth truncation order
-			},
-			std::array<T, 3> {	// Sixth differentiation order
-				std::array<T, 7> { 1, -6, 15, -20, 15, -6, 1 },	// Second truncation order
-				std::array<T, 9> { -1/4, 3, -13, 29, -75/2, 29, -13, 3, -1/4 },	// Fourth truncation order
-				std::array<T, 11> { 13/240, -19/24, 87/16, -39/2, 323/8, -1023/20, 323/8, -39/2, 87/16, -19/24, 13/240 }	// Sixth truncation order
-			}
-		};
+		/// @brief Multithreaded `at_range()`
+		/// @details The range is split into chunks of `parallel_diff_chunk` points, each sampled with the stencil reach on
+		/// both sides into a buffer owned by its task and differentiated straight into the returned array. The tasks run on
+		/// the threads of `thread_pool::shared()`, started by the first parallel call and reused by the next ones.
+		/// `threads == 0` uses all the hardware threads. The functor is called concurrently, so it must be thread-safe
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API std::vector<T> parallel_at_range(const std::size_t& from, const std::size_t& to, const std::size_t& threads = 0) const
+		{
+			using _S = internal::_stencils<T, Method, DOrder, TOrder>;
+			_S::check();
 
-		// Lookup table for pre-calculated values used by the forward difference method
-		static constexpr std::array<T, 6> _fd_lut {
-			std::array<T, 6> {  // First differentiation order
-    		std::array<T, 2> { -1,1 },	// First truncation order
-    		std::array<T, 3> { -3/2, 2, -1/2 },	// Second truncation order
-    		std::array<T, 4> { -11/6, 3, -3/2, 1/3 },	// Third truncation order
-    		std::array<T, 5> { -25/12, 4, -3, 4/3, -1/4 },	// Fourth truncation order
-    		std::array<T, 6> { -137/60, 5, -5, 10/3, -5/4, 1/5 },	// Fith truncation order
-    		std::array<T, 7> { -49/20, 6, -15/2, 20/3, -15/4, 6/5, -1/6 }	// Sixth truncation order
-			},
-			std::array<T, 6> {  // Second differentiation order
-			  std::array<T, 3> { 1, -2, 1 },	// First truncation order
-			  std::array<T, 4> { 2, -5, 4, -1 },	// Second truncation order
-			  std::array<T, 5> { 35/12, -26/3, 19/2, -14/3, 11/12 },	// Third truncation order
-			  std::array<T, 6> { 4, 15/4, -77/6, 107/6, -13, 61/12, -5/6 },	// Fourth truncation order
-			  std::array<T, 7> {203/45, -87/5, 117/4, -254/9, 33/2, -27/5, 137/180 },	// Fith truncation order
-			  std::array<T, 8> {469/90, -223/10, 879/20, -949/18, 41, -201/10, 1019/180, -7/10 }	// Sixth truncation order
-			},
-			std::array<T, 6> {  // Third differentiation order
-			  std::array<T, 4> { -1, 3, -3, 1 }, 	// First truncation order
-			  std::array<T, 5> { -5/2, 9, -12, 7, -3/2 },	// Second truncation order
-			  std::array<T, 6> { -17/4, 71/4, -59/2, 49/2, -41/4, 7/4 },	// Third truncation order
-			  std::array<T, 7> { -49/8, 29, -461/8, 62, -307/8, 13, -15/8 },	// Fourth truncation order
-			  std::array<T, 8> { -967/120, 638/15, -3929/40, 389/3, -2545/24, 268/5, -1849/120, 29/15 },	// Fith truncation order
-			  std::array<T, 9> { -801/80, 349/6, -18353/120, 2391/10, -1457/6, 4891/30, -561/8, 527/30, -469/240 }	// Sixth truncation order
-			},
-			std::array<T, 6> {  // Fourth differentiation order
-			  std::array<T, 5> { 1, -4, 6, -4, 1 },	// First truncation order
-			  std::array<T, 6> { 3, -14, 26, -24, 11, -2 },	// Second truncation order
-			  std::array<T, 7> { 35/6, -31, 137/2, -242/3, 107/2, -19, 17/6 },	// Third truncation order
-			  std::array<T, 8> { 28/3, -111/2, 142, -1219/6, 176, -185/2, 82/3, -7/2 },	// Fourth truncation order
-			  std::array<T, 9> { 1069/80, -1316/15, 15289/60, -2144/5, 10993/24, -4772/15, 2803/20, -536/15, 967/240 }	// Fifth truncation order
-			}
-		};
+			const std::size_t _n{ m_grid.end() };
+			if (from > to or to > _n)
+				throw std::out_of_range("method Differentiate::parallel_at_range(): range out of the grid was requested.\n");
+			std::vector<T> _res(to - from);
 
-		// Lookup table for pre-calculated values used by the backward difference method
-		static constexpr std::array<T, 6> _bd_lut {
-			std::array<T, 3> { // First differentiation order
-		    std::array<T, 2> { -1, 1 },    // First truncation order
-		    std::array<T, 3> { 1/2, -2, 3/2 }, // Second truncation order
-		    std::array<T, 4> { -1/3, 3/2, -3, 11/6 }   // Third truncation order
-			},
-			std::array<T, 2> {  // Second differentiation order
-		    std::array<T, 3> { 1, -2, 1 },  // First truncation order
-		    std::array<T, 4> { -1, 4, -5, 2 }   // Second truncation order
-			},
-			std::array<T, 3> {  // Third differentiation order
-		    std::array<T, 4> { -1, 3, -3, 1 },  // First truncation order
-		    std::array<T, 5> { 3/2, -7, 12, -9, 5/2 }    // Second truncation order
-			},
-			std::array<T, 4> {  // Fourth differentiation order
-		    std::array<T, 5> { 1, -4, 6, -4, 1 },   // First truncation order
-		    std::array<T, 6> { -2, 11, -24, 26, -14, 3 }    // Second truncation order
-			}
-		};
+			// Weights for orders other than the cached ones are computed here, once for all the chunks
+			internal::_weight_table<T> _table;
+			const internal::_weight_table<T>* _w{ internal::_range_weights<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), from, to, _table) };
+			internal::_parallel_chunks(from, to, threads, [&]()
+			{
+				std::vector<T, fcp::algods::aligned_allocator<T>> _samples(parallel_diff_chunk + 2 * _S::reach);
+				return [&, _samples = std::move(_samples)](const std::size_t& c0, const std::size_t& c1) mutable
+				{
+					const std::size_t _s0{ c0 > _S::reach ? c0 - _S::reach : 0 }, _s1{ std::min(_n, c1 + _S::reach) };
+					for (std::size_t j{_s0}; j < _s1; j++)
+						_samples[j - _s0] = m_functor(m_grid[j]);
+					internal::_grid_diff_range<T, Method, DOrder, TOrder>(m_grid, _w, _samples.data(), _s0, c0, c1, _res.data() + (c0 - from));
+				};
+			});
+			return _res;
+		}
 
-		// TODO: vectorize the following internal methods ...
+		/// @brief Multithreaded `data()`
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API std::vector<T> parallel_data(const std::size_t& threads = 0) const
+		{
+			return this->parallel_at_range<DOrder, TOrder>(m_grid.begin(), m_grid.end(), threads);
+		}
 
+	private:
 		// Method for finding finite difference derivative
 		template <std::size_t DOrder, std::size_t TOrder>
-		FCP_COMPUTATIONAL_API T _finite_diff_single_value(const std::size_t& i, const bool& bounds_check, central_difference) const
+		FCP_COMPUTATIONAL_API T _finite_diff_single_value(const std::size_t& i, const bool& bounds_check) const
 		{
-			static_assert(TOrder > 0, "class Differentiate: truncation order must be a positive number.\n");
-			static_assert(DOrder > 0, "class Differentiate: differential order must be a positive number.\n");
-			static_assert(TOrder % 2 == 0, "class Differentiate: truncation order for central difference approximation must be even.\n");
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			if (bounds_check) m_grid.at(i);
+			auto _sample = [this](const std::size_t& j) { return m_cache.get(j, [this](const std::size_t& k) { return m_functor(m_grid[k]); }); };
+			return internal::_grid_diff_at<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), i, _sample);
+		}
 
-			constexpr auto coeff = _cd_lut[DOrder][TOrder];	
-			T _res;	
-			constexpr bool _use_precalc_val = DOrder <= 6 and ( DOrder <= 2 ? (TOrder <= 8) : (TOrder >= 6) );
-			if constexpr ( _use_precalc_val and Grid::is_uniform_v )
-			{
-				// Central difference coefficients are symmetric with respect to the index 0
-				constexpr std::size_t _first_i{ 0 - ( coeff.size() - 1 ) / 2 };
-				const T _h{ m_grid[1] - m_grid[0] };
-				for (std::size_t i{0}; i < coeff.size(); i++)
-					_res += coeff[i] * m_functor(0 + (_first_i + i) * _h);
-				return _res / std::pow(_h, TOrder);
-			} else {
-				// TODO else solve linear system
-			}
+		// Stencil weights of all the grid points for the default orders, on non-uniform grids
+		static internal::_weight_table<T> _default_weights(const Grid& grid)
+		{
+			if constexpr (Grid::is_uniform_v)
+				return {};
+			else
+				return internal::_make_weight_table<T, Method, DiffOrder, TruncationOrder>(grid, grid.begin(), grid.end());
 		}
 
+		// Cached weights for the requested orders, if any
 		template <std::size_t DOrder, std::size_t TOrder>
-		FCP_COMPUTATIONAL_API T _finite_diff_single_value(const std::size_t& i, const bool& bounds_check, forward_difference) const
-		{
-			static_assert(TOrder > 0, "class Differentiate: truncation order must be a positive number.\n");
-			static_assert(DOrder > 0, "class Differentiate: differential order must be a positive number.\n");
-			
-			constexpr auto coeff = _fd_lut[DOrder][TOrder];	
-			T _res;
-			constexpr bool _use_precalc_val = DOrder <= 4 and ( DOrder <= 3 ? (TOrder <= 6) : (TOrder <= 5) );
-			if constexpr ( _use_precalc_val and Grid::is_uniform_v )
+		const internal::_weight_table<T>* _weights(void) const
+		{
+			return DOrder == DiffOrder and TOrder == TruncationOrder and not Grid::is_uniform_v ? &m_weights : nullptr;
+		}
+
+		Grid m_grid;
+		Functor m_functor;
+		internal::_weight_table<T> m_weights;
+		mutable typename SampleCache::template storage<T> m_cache;
+};
+
+/// @brief Differentiation of data sampled at the points of a grid
+/// @details The samples are not copied: the object is a view over them, which must outlive it, and the derivatives are
+/// written into arrays provided by the caller. It uses the same stencils (and the same boundary handling) as
+/// `Differentiate`, without any function call or allocation
+template <typename T, class Grid,
+				  typename Method = central_difference, std::size_t TruncationOrder = 2,
+					std::size_t DiffOrder = 1>
+class StorageDifferentiation
+{
+	// Pre C++20 Concepts
+	static_assert(internal::is_valid_grid<Grid>, "class StorageDifferentiation: invalid Grid class passed.\n");
+	static_assert(std::is_copy_constructible<Grid>::value, "class StorageDifferentiation: Grid class is not copy constructible.\n");
+	static_assert(std::is_same_v<Method, central_difference> or
+								std::is_same_v<Method, backward_difference> or
+								std::is_same_v<Method, forward_difference>,
+								"class StorageDifferentiation: unsupported approximation method requested.\n");
+
+	public:
+		/// @brief Generate a `StorageDifferentiation` object over `samples`, the values at the points of `grid`
+		/// @details Throws `std::invalid_argument` if the number of samples differs from the one of the grid points.
+		/// On a non-uniform grid the stencil weights of every grid point for the default orders are computed here, once,
+		/// so the samples may be updated in place (e.g. at each time step) without recomputing them
+		StorageDifferentiation(const span<const T>& samples, const Grid& grid): m_samples{samples}, m_grid{grid}
+		{
+			if (m_samples.size() != m_grid.end() - m_grid.begin())
+				throw std::invalid_argument("class StorageDifferentiation: the number of samples differs from the number of grid points.\n");
+			if constexpr (not Grid::is_uniform_v)
+				m_weights = internal::_make_weight_table<T, Method, DiffOrder, TruncationOrder>(m_grid, m_grid.begin(), m_grid.end());
+		}
+
+		/// @brief Returns differential at `i`-th grid point performing bounds checking first
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API T at(const std::size_t& i) const
+		{
+			if (i >= m_samples.size())
+				throw std::out_of_range("method StorageDifferentiation::at(): index out of range was requested.\n");
+			return this->operator[]<DOrder, TOrder>(i);
+		}
+
+		/// @brief Returns differential at `i`-th grid point without any bounds checking
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API T operator[](const std::size_t& i) const
+		{
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			auto _sample = [this](const std::size_t& j) { return m_samples[j]; };
+			return internal::_grid_diff_at<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), i, _sample);
+		}
+
+		/// @brief Write the differentials at the grid points [from, to) into `out`
+		/// @details Throws `std::out_of_range` if the range exceeds the grid or doesn't match the size of `out`.
+		/// `out` must not overlap the samples
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void at_range(const std::size_t& from, const std::size_t& to, const span<T>& out) const
+		{
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			if (from > to or to > m_samples.size() or out.size() != to - from)
+				throw std::out_of_range("method StorageDifferentiation::at_range(): range out of the grid was requested.\n");
+			if (from == to) return;
+			internal::_grid_diff_range<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), m_samples.data(), 0, from, to, out.data());
+		}
+
+		/// @brief Write the differentials at all grid points into `out`
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void data(const span<T>& out) const
+		{
+			this->at_range<DOrder, TOrder>(0, m_samples.size(), out);
+		}
+
+		/// @brief Multithreaded `at_range()`: chunks of `parallel_diff_chunk` points are differentiated concurrently into `out`
+		/// @details `threads == 0` uses all the hardware threads
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void parallel_at_range(const std::size_t& from, const std::size_t& to, const span<T>& out, const std::size_t& threads = 0) const
+		{
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			if (from > to or to > m_samples.size() or out.size() != to - from)
+				throw std::out_of_range("method StorageDifferentiation::parallel_at_range(): range out of the grid was requested.\n");
+			internal::_weight_table<T> _table;
+			const internal::_weight_table<T>* _w{ internal::_range_weights<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), from, to, _table) };
+			internal::_parallel_chunks(from, to, threads, [&]()
 			{
-				const T _h{ m_grid[1] - m_grid[0] };
-				for (std::size_t i{0}; i < coeff.size(); i++)
-					_res += coeff[i] * m_functor(i*_h);
-				return _res / std::pow(_h, TOrder);	
-			} else {
-				// TODO else solve linear system
-			}
+				return [&](const std::size_t& c0, const std::size_t& c1)
+				{
+					internal::_grid_diff_range<T, Method, DOrder, TOrder>(m_grid, _w, m_samples.data(), 0, c0, c1, out.data() + (c0 - from));
+				};
+			});
+		}
+
+		/// @brief Multithreaded `data()`
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void parallel_data(const span<T>& out, const std::size_t& threads = 0) const
+		{
+			this->parallel_at_range<DOrder, TOrder>(0, m_samples.size(), out, threads);
 		}
 
+		/// @brief Number of samples (and grid points)
+		std::size_t size(void) const { return m_samples.size(); }
+
+	private:
+		// Cached weights for the requested orders, if any
 		template <std::size_t DOrder, std::size_t TOrder>
-		FCP_COMPUTATIONAL_API T _finite_diff_single_value(const std::size_t& i, const bool& bounds_check, backward_difference) const
-		{
-			static_assert(TOrder > 0, "class Differentiate: truncation order must be a positive number.\n");
-			static_assert(DOrder > 0, "class Differentiate: differential order must be a positive number.\n");
-				
-			constexpr auto coeff = _bd_lut[DOrder][TOrder];
-			T _res;
-			constexpr bool _use_precalc_val = DOrder >= 4 and ( DOrder == 1 ? (TOrder <= 3) : (TOrder <= 2) ); 
-			if constexpr ( _use_precalc_val and Grid::is_uniform_v )
+		const internal::_weight_table<T>* _weights(void) const
+		{
+			return DOrder == DiffOrder and TOrder == TruncationOrder and not Grid::is_uniform_v ? &m_weights : nullptr;
+		}
+
+		span<const T> m_samples;
+		Grid m_grid;
+		internal::_weight_table<T> m_weights;
+};
+
+/// @brief Differentiation of many fields sampled at the points of the same grid, in one sweep
+/// @details The `fields` fields are stored one after the other (structure of arrays): the value of the `f`-th at the
+/// `i`-th grid point is `samples[f * n + i]`, `n` being the number of grid points, and the derivatives are written with
+/// the same layout. Like `StorageDifferentiation` the object is a view over the samples, but the stencil of each point
+/// is selected once for all the fields, and its weights stay in registers (or in the cache, on non-uniform grids) while
+/// all of them are differentiated
+template <typename T, class Grid,
+				  typename Method = central_difference, std::size_t TruncationOrder = 2,
+					std::size_t DiffOrder = 1>
+class BatchDifferentiation
+{
+	// Pre C++20 Concepts
+	static_assert(internal::is_valid_grid<Grid>, "class BatchDifferentiation: invalid Grid class passed.\n");
+	static_assert(std::is_copy_constructible<Grid>::value, "class BatchDifferentiation: Grid class is not copy constructible.\n");
+	static_assert(std::is_same_v<Method, central_difference> or
+								std::is_same_v<Method, backward_difference> or
+								std::is_same_v<Method, forward_difference>,
+								"class BatchDifferentiation: unsupported approximation method requested.\n");
+
+	public:
+		/// @brief Generate a `BatchDifferentiation` object over `samples`, the values of `fields` fields at the points of `grid`
+		/// @details Throws `std::invalid_argument` if the number of samples differs from `fields` times the number of grid points.
+		/// On a non-uniform grid the stencil weights of every grid point for the default orders are computed here, once
+		BatchDifferentiation(const span<const T>& samples, const std::size_t& fields, const Grid& grid): m_samples{samples}, m_fields{fields}, m_grid{grid}
+		{
+			if (m_samples.size() != m_fields * (m_grid.end() - m_grid.begin()))
+				throw std::invalid_argument("class BatchDifferentiation: the number of samples differs from the number of fields times the number of grid points.\n");
+			if constexpr (not Grid::is_uniform_v)
+				m_weights = internal::_make_weight_table<T, Method, DiffOrder, TruncationOrder>(m_grid, m_grid.begin(), m_grid.end());
+		}
+
+		/// @brief Returns differential of the `field`-th field at `i`-th grid point performing bounds checking first
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API T at(const std::size_t& field, const std::size_t& i) const
+		{
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			if (field >= m_fields or i >= this->size())
+				throw std::out_of_range("method BatchDifferentiation::at(): index out of range was requested.\n");
+			const T* _field{ m_samples.data() + field * this->size() };
+			auto _sample = [_field](const std::size_t& j) { return _field[j]; };
+			return internal::_grid_diff_at<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), i, _sample);
+		}
+
+		/// @brief Write the differentials of all the fields at the grid points [from, to) into `out`
+		/// @details `out` holds the `to - from` differentials of each field one after the other. Throws `std::out_of_range`
+		/// if the range exceeds the grid or doesn't match the size of `out`. `out` must not overlap the samples
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void at_range(const std::size_t& from, const std::size_t& to, const span<T>& out) const
+		{
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			if (from > to or to > this->size() or out.size() != m_fields * (to - from))
+				throw std::out_of_range("method BatchDifferentiation::at_range(): range out of the grid was requested.\n");
+			if (from == to) return;
+			internal::_batch_diff_range<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), m_samples.data(), this->size(), m_fields, from, to,
+																														 out.data(), to - from);
+		}
+
+		/// @brief Write the differentials of all the fields at all grid points into `out`
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void data(const span<T>& out) const
+		{
+			this->at_range<DOrder, TOrder>(0, this->size(), out);
+		}
+
+		/// @brief Multithreaded `at_range()`: chunks of `parallel_diff_chunk` points of all the fields are differentiated concurrently
+		/// @details `threads == 0` uses all the hardware threads
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void parallel_at_range(const std::size_t& from, const std::size_t& to, const span<T>& out, const std::size_t& threads = 0) const
+		{
+			internal::_stencils<T, Method, DOrder, TOrder>::check();
+			if (from > to or to > this->size() or out.size() != m_fields * (to - from))
+				throw std::out_of_range("method BatchDifferentiation::parallel_at_range(): range out of the grid was requested.\n");
+			internal::_weight_table<T> _table;
+			const internal::_weight_table<T>* _w{ internal::_range_weights<T, Method, DOrder, TOrder>(m_grid, _weights<DOrder, TOrder>(), from, to, _table) };
+			internal::_parallel_chunks(from, to, threads, [&]()
 			{
-				const T _h{ m_grid[1] - m_grid[0] };
-				for (std::size_t i{0}; i < coeff.size(); i++)
-					_res += coeff[i] * m_functor(0 - i*_h);
-				return _res / std::pow(_h, TOrder);
-			} else {
-				// TODO else solve linear system
-			}
+				return [&](const std::size_t& c0, const std::size_t& c1)
+				{
+					internal::_batch_diff_range<T, Method, DOrder, TOrder>(m_grid, _w, m_samples.data(), this->size(), m_fields, c0, c1,
+																																 out.data() + (c0 - from), to - from);
+				};
+			});
+		}
+
+		/// @brief Multithreaded `data()`
+		template <std::size_t DOrder = DiffOrder, std::size_t TOrder = TruncationOrder>
+		FCP_COMPUTATIONAL_API void parallel_data(const span<T>& out, const std::size_t& threads = 0) const
+		{
+			this->parallel_at_range<DOrder, TOrder>(0, this->size(), out, threads);
 		}
 
+		/// @brief Number of fields
+		std::size_t fields(void) const { return m_fields; }
+
+		/// @brief Number of grid points (and samples of each field)
+		std::size_t size(void) const { return m_grid.end() - m_grid.begin(); }
+
+	private:
+		// Cached weights for the requested orders, if any
+		template <std::size_t DOrder, std::size_t TOrder>
+		const internal::_weight_table<T>* _weights(void) const
+		{
+			return DOrder == DiffOrder and TOrder == TruncationOrder and not Grid::is_uniform_v ? &m_weights : nullptr;
+		}
 
+		span<const T> m_samples;
+		std::size_t m_fields;
 		Grid m_grid;
-		Functor m_functor;
+		internal::_weight_table<T> m_weights;
 };
 
 END_COMPUTATIONAL_NAMESPACE
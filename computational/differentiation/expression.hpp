@@ -0,0 +1,290 @@
+#ifndef FCPUT_COMPUTATIONAL_EXPRESSION
+#define FCPUT_COMPUTATIONAL_EXPRESSION
+
+#include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "computational/mesh/grid.hpp"
+#include "computational/differentiation/diff.hpp"
+#include "algo_ds/simd/stencil.hpp"
+
+#include <type_traits>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+/* Lazy expressions of fields sampled on a uniform grid and of their finite differences, e.g.
+ *
+ *   auto f = field(grid, samples);
+ *   assign(out, a * derivative<2>(f) + b * derivative<1>(f) + c * f);
+ *
+ * Building an expression only stores its operands (spans and coefficients, by value); nothing is
+ * computed until `assign()` writes it into an output span, in a single pass without temporaries.
+ * An expression that is a linear combination of the derivatives of a single field is one stencil:
+ * its coefficients are merged, and the points where all the stencils fit are computed by the
+ * vectorized stencil kernel. Other expressions (products of fields, several fields) are evaluated
+ * point by point in one fused loop, with the stencils known at compile time in the interior. The
+ * points near the ends use the same one-sided stencils as `Differentiate`.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+namespace internal
+{
+	struct _expression_tag {};
+
+	template <typename E>
+	constexpr bool _is_expression_v = std::is_base_of_v<_expression_tag, std::decay_t<E>>;
+
+	// Nodes interface:
+	//   `linear`: the node is a linear combination of stencils over the samples `source()` (null if there are several fields)
+	//   [lo, hi]: offsets of the samples read at the points where all the stencils of the node fit
+	//   `at(i)`: value at any point, `interior(i)`: value at a point where all the stencils fit
+	//   `add_weights(w, c)`: adds `c` times the coefficients of a linear node to `w[lo]...w[hi]`
+
+	// Samples of a field
+	template <typename T>
+	class _field_node: public _expression_tag
+	{
+		public:
+			using value_type = T;
+			constexpr static bool linear = true;
+			constexpr static std::ptrdiff_t lo = 0, hi = 0;
+
+			_field_node(const span<const T>& samples, const T& spacing): m_samples{samples}, m_spacing{spacing} {}
+
+			std::size_t size(void) const { return m_samples.size(); }
+			const T* source(void) const { return m_samples.data(); }
+			const T& spacing(void) const { return m_spacing; }
+			T at(const std::size_t& i) const { return m_samples[i]; }
+			T interior(const std::size_t& i) const { return m_samples[i]; }
+			void add_weights(T* w, const T& c) const { w[0] += c; }
+
+		private:
+			span<const T> m_samples;
+			T m_spacing;
+	};
+
+	// Finite difference of a field
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder>
+	class _derivative_node: public _expression_tag
+	{
+		using _I = typename _stencils<T, Method, DOrder, TOrder>::interior;
+
+		public:
+			using value_type = T;
+			constexpr static bool linear = true;
+			constexpr static std::ptrdiff_t lo = _I::first, hi = _I::first + static_cast<std::ptrdiff_t>(_I::coeff.size()) - 1;
+
+			_derivative_node(const _field_node<T>& f): m_field{f}
+			{
+				_stencils<T, Method, DOrder, TOrder>::check();
+				T _hd{1};
+				for (std::size_t d{0}; d < DOrder; d++)
+					_hd *= f.spacing();
+				m_scale = T{1} / _hd;
+			}
+
+			std::size_t size(void) const { return m_field.size(); }
+			const T* source(void) const { return m_field.source(); }
+
+			T at(const std::size_t& i) const
+			{
+				const T* _s{ m_field.source() };
+				return _finite_diff_at<T, Method, DOrder, TOrder>(i, this->size(), m_scale, [_s](const std::size_t& j) { return _s[j]; });
+			}
+
+			T interior(const std::size_t& i) const
+			{
+				const T* _s{ m_field.source() + i + lo };
+				T _res{0};
+				for (std::size_t k{0}; k < _I::coeff.size(); k++)
+					_res += _I::coeff[k] * m_scale * _s[k];
+				return _res;
+			}
+
+			void add_weights(T* w, const T& c) const
+			{
+				for (std::size_t k{0}; k < _I::coeff.size(); k++)
+					w[lo + static_cast<std::ptrdiff_t>(k)] += c * _I::coeff[k] * m_scale;
+			}
+
+		private:
+			_field_node<T> m_field;
+			T m_scale;
+	};
+
+	// Product of a node by a constant
+	template <typename E>
+	class _scaled_node: public _expression_tag
+	{
+		public:
+			using value_type = typename E::value_type;
+			constexpr static bool linear = E::linear;
+			constexpr static std::ptrdiff_t lo = E::lo, hi = E::hi;
+
+			_scaled_node(const value_type& c, const E& e): m_c{c}, m_e{e} {}
+
+			std::size_t size(void) const { return m_e.size(); }
+			const value_type* source(void) const { return m_e.source(); }
+			value_type at(const std::size_t& i) const { return m_c * m_e.at(i); }
+			value_type interior(const std::size_t& i) const { return m_c * m_e.interior(i); }
+			void add_weights(value_type* w, const value_type& c) const { m_e.add_weights(w, c * m_c); }
+
+		private:
+			value_type m_c;
+			E m_e;
+	};
+
+	// Sum (`Sign` = 1) or difference (`Sign` = -1) of two nodes
+	template <typename L, typename R, int Sign>
+	class _sum_node: public _expression_tag
+	{
+		public:
+			using value_type = typename L::value_type;
+			constexpr static bool linear = L::linear and R::linear;
+			constexpr static std::ptrdiff_t lo = std::min(L::lo, R::lo), hi = std::max(L::hi, R::hi);
+
+			_sum_node(const L& l, const R& r): m_l{l}, m_r{r}
+			{
+				if (l.size() != r.size())
+					throw std::invalid_argument("expressions: the fields have different numbers of samples.\n");
+			}
+
+			std::size_t size(void) const { return m_l.size(); }
+			const value_type* source(void) const { return m_l.source() == m_r.source() ? m_l.source() : nullptr; }
+			value_type at(const std::size_t& i) const { return m_l.at(i) + Sign * m_r.at(i); }
+			value_type interior(const std::size_t& i) const { return m_l.interior(i) + Sign * m_r.interior(i); }
+
+			void add_weights(value_type* w, const value_type& c) const
+			{
+				m_l.add_weights(w, c);
+				m_r.add_weights(w, Sign * c);
+			}
+
+		private:
+			L m_l;
+			R m_r;
+	};
+
+	// Pointwise product of two nodes
+	template <typename L, typename R>
+	class _product_node: public _expression_tag
+	{
+		public:
+			using value_type = typename L::value_type;
+			constexpr static bool linear = false;
+			constexpr static std::ptrdiff_t lo = std::min(L::lo, R::lo), hi = std::max(L::hi, R::hi);
+
+			_product_node(const L& l, const R& r): m_l{l}, m_r{r}
+			{
+				if (l.size() != r.size())
+					throw std::invalid_argument("expressions: the fields have different numbers of samples.\n");
+			}
+
+			std::size_t size(void) const { return m_l.size(); }
+			const value_type* source(void) const { return nullptr; }
+			value_type at(const std::size_t& i) const { return m_l.at(i) * m_r.at(i); }
+			value_type interior(const std::size_t& i) const { return m_l.interior(i) * m_r.interior(i); }
+			void add_weights(value_type*, const value_type&) const {}
+
+		private:
+			L m_l;
+			R m_r;
+	};
+
+	template <typename L, typename R>
+	using _enable_binary = std::enable_if_t<_is_expression_v<L> and _is_expression_v<R>>;
+
+	template <typename E>
+	using _enable_unary = std::enable_if_t<_is_expression_v<E>>;
+
+	// Operators, found by argument-dependent lookup on the nodes
+	template <typename L, typename R, typename = _enable_binary<L, R>>
+	FCP_COMPUTATIONAL_API _sum_node<L, R, 1> operator+(const L& l, const R& r) { return { l, r }; }
+
+	template <typename L, typename R, typename = _enable_binary<L, R>>
+	FCP_COMPUTATIONAL_API _sum_node<L, R, -1> operator-(const L& l, const R& r) { return { l, r }; }
+
+	template <typename L, typename R, typename = _enable_binary<L, R>>
+	FCP_COMPUTATIONAL_API _product_node<L, R> operator*(const L& l, const R& r) { return { l, r }; }
+
+	template <typename E, typename = _enable_unary<E>>
+	FCP_COMPUTATIONAL_API _scaled_node<E> operator*(const typename E::value_type& c, const E& e) { return { c, e }; }
+
+	template <typename E, typename = _enable_unary<E>>
+	FCP_COMPUTATIONAL_API _scaled_node<E> operator*(const E& e, const typename E::value_type& c) { return { c, e }; }
+
+	template <typename E, typename = _enable_unary<E>>
+	FCP_COMPUTATIONAL_API _scaled_node<E> operator-(const E& e) { return { typename E::value_type(-1), e }; }
+}	// namespace internal
+
+/// @brief Field sampled at the points of a uniform grid, as an operand of expressions
+/// @details The samples are not copied: they must outlive the expressions using them. Throws `std::invalid_argument` if the
+/// number of samples differs from the one of the grid points
+template <typename T, class Grid>
+FCP_COMPUTATIONAL_API internal::_field_node<T> field(const Grid& grid, const span<const T>& samples)
+{
+	static_assert(internal::is_valid_grid<Grid>, "function field(): invalid Grid class passed.\n");
+	static_assert(Grid::is_uniform_v, "function field(): only uniform grids are supported.\n");
+	if (samples.size() != grid.end() - grid.begin())
+		throw std::invalid_argument("function field(): the number of samples differs from the number of grid points.\n");
+	return internal::_field_node<T>(samples, samples.size() > 1 ? grid[1] - grid[0] : T{1});
+}
+
+template <typename T, typename Allocator, class Grid>
+FCP_COMPUTATIONAL_API internal::_field_node<T> field(const Grid& grid, const std::vector<T, Allocator>& samples)
+{
+	return field(grid, span<const T>(samples));
+}
+
+/// @brief Finite difference of order `DOrder` of a field, with the stencils of `Differentiate`
+template <std::size_t DOrder, std::size_t TOrder = 2, typename Method = central_difference, typename T>
+FCP_COMPUTATIONAL_API internal::_derivative_node<T, Method, DOrder, TOrder> derivative(const internal::_field_node<T>& f)
+{
+	return internal::_derivative_node<T, Method, DOrder, TOrder>(f);
+}
+
+/// @brief Evaluate the expression `e` at all the grid points into `out`
+/// @details Throws `std::invalid_argument` if the size of `out` differs from the number of samples of the fields, and
+/// `std::domain_error` if the grid has too few points for a stencil. `out` must not overlap the samples
+template <typename E, typename = internal::_enable_unary<E>>
+FCP_COMPUTATIONAL_API void assign(const span<typename E::value_type>& out, const E& e)
+{
+	using T = typename E::value_type;
+	const std::size_t _n{ e.size() };
+	if (out.size() != _n)
+		throw std::invalid_argument("function assign(): the size of the output differs from the number of samples.\n");
+
+	// Points where all the stencils fit: [_i0, _i1)
+	const std::size_t _i0{ static_cast<std::size_t>(-E::lo) };
+	const std::size_t _i1{ _n > static_cast<std::size_t>(E::hi) ? _n - static_cast<std::size_t>(E::hi) : 0 };
+	if (_i0 < _i1)
+	{
+		const T* _source{ e.source() };
+		if (E::linear and _source)
+		{
+			// One stencil with the merged coefficients
+			std::array<T, E::hi - E::lo + 1> _w{};
+			e.add_weights(_w.data() - E::lo, T{1});
+			using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, fcp::algods::simd::native, fcp::algods::simd::scalar>;
+			fcp::algods::simd::stencil(_isa{}, _source + _i0 + E::lo, _w.data(), _w.size(), out.data() + _i0, _i1 - _i0);
+		}
+		else
+			for (std::size_t i{_i0}; i < _i1; i++)
+				out[i] = e.interior(i);
+	}
+
+	// Boundary points
+	for (std::size_t i{0}; i < std::min(_i0, _n); i++)
+		out[i] = e.at(i);
+	for (std::size_t i{std::max(_i0, _i1)}; i < _n; i++)
+		out[i] = e.at(i);
+}
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_EXPRESSION
@@ -0,0 +1,129 @@
+#ifndef FCPUT_COMPUTATIONAL_FORNBERG
+#define FCPUT_COMPUTATIONAL_FORNBERG
+
+#include "computational/common/common.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+namespace internal
+{
+	constexpr std::int64_t _gcd(std::int64_t a, std::int64_t b)
+	{
+		if (a < 0) a = -a;
+		if (b < 0) b = -b;
+		while (b != 0)
+		{
+			const std::int64_t _r{ a % b };
+			a = b;
+			b = _r;
+		}
+		return a;
+	}
+
+	// Exact rational number, always reduced and with a positive denominator. In constant expressions an overflow
+	// is undefined behaviour, hence a compilation error instead of a wrong coefficient
+	struct _rational
+	{
+		std::int64_t num, den;
+
+		constexpr _rational(const std::int64_t& n = 0, const std::int64_t& d = 1): num{n}, den{d}
+		{
+			const std::int64_t _g{ _gcd(num, den) };
+			if (_g > 1) { num /= _g; den /= _g; }
+			if (den < 0) { num = -num; den = -den; }
+		}
+
+		template <typename T>
+		constexpr T to(void) const { return static_cast<T>(num) / static_cast<T>(den); }
+	};
+
+	constexpr _rational operator-(const _rational& a) { return _rational(-a.num, a.den); }
+
+	constexpr _rational operator*(const _rational& a, const _rational& b)
+	{
+		// Cross-reduce first, to keep the products small
+		const std::int64_t _g1{ _gcd(a.num, b.den) }, _g2{ _gcd(b.num, a.den) };
+		const std::int64_t _d1{ _g1 > 1 ? _g1 : 1 }, _d2{ _g2 > 1 ? _g2 : 1 };
+		return _rational((a.num / _d1) * (b.num / _d2), (a.den / _d2) * (b.den / _d1));
+	}
+
+	constexpr _rational operator/(const _rational& a, const _rational& b) { return a * _rational(b.den, b.num); }
+
+	constexpr _rational operator+(const _rational& a, const _rational& b)
+	{
+		const std::int64_t _g{ _gcd(a.den, b.den) };
+		return _rational(a.num * (b.den / _g) + b.num * (a.den / _g), (a.den / _g) * b.den);
+	}
+
+	constexpr _rational operator-(const _rational& a, const _rational& b) { return a + (-b); }
+
+	// Fornberg's algorithm: weights of the `M`-th derivative at `x0` over the `N` distinct points `x`, computing the ones of
+	// all the lower orders and of the leading subsets of the points along the way (B. Fornberg, "Generation of finite
+	// difference formulas on arbitrarily spaced grids", Math. Comp. 51, 1988). `Number` is `_rational` or a floating-point type
+	template <std::size_t M, typename Number, std::size_t N>
+	constexpr std::array<Number, N> _fornberg(const std::array<Number, N>& x, const Number& x0)
+	{
+		std::array<std::array<Number, N>, M + 1> _c{};
+		Number _c1{1}, _c4{ x[0] - x0 };
+		_c[0][0] = Number{1};
+		for (std::size_t i{1}; i < N; i++)
+		{
+			const std::size_t _mn{ i < M ? i : M };
+			Number _c2{1}, _c5{ _c4 };
+			_c4 = x[i] - x0;
+			for (std::size_t j{0}; j < i; j++)
+			{
+				const Number _c3{ x[i] - x[j] };
+				_c2 = _c2 * _c3;
+				if (j == i - 1)
+				{
+					for (std::size_t k{_mn}; k > 0; k--)
+						_c[k][i] = _c1 * (Number(static_cast<std::int64_t>(k)) * _c[k - 1][i - 1] - _c5 * _c[k][i - 1]) / _c2;
+					_c[0][i] = -(_c1 * _c5 * _c[0][i - 1]) / _c2;
+				}
+				for (std::size_t k{_mn}; k > 0; k--)
+					_c[k][j] = (_c4 * _c[k][j] - Number(static_cast<std::int64_t>(k)) * _c[k - 1][j]) / _c3;
+				_c[0][j] = _c4 * _c[0][j] / _c3;
+			}
+			_c1 = _c2;
+		}
+		return _c[M];
+	}
+}	// namespace internal
+
+/// @brief Weights of the `DOrder`-th derivative at a grid point over the stencil points `offsets`, in grid spacings
+/// @details The derivative is `sum(w[k] * f(x + offsets[k] * h)) / h^DOrder`. The weights are computed exactly in
+/// rational arithmetic and rounded once to `T`, so that in a constant expression they cost nothing at runtime; stencils
+/// too wide for 64-bit rationals don't compile. The offsets must be distinct and at least `DOrder + 1`
+template <typename T, std::size_t DOrder, std::size_t N>
+constexpr std::array<T, N> finite_difference_weights(const std::array<int, N>& offsets)
+{
+	static_assert(N > DOrder, "function finite_difference_weights(): the stencil needs more points than the differentiation order.\n");
+	std::array<internal::_rational, N> _x{};
+	for (std::size_t k{0}; k < N; k++)
+		_x[k] = internal::_rational(offsets[k]);
+	const auto _w{ internal::_fornberg<DOrder>(_x, internal::_rational(0)) };
+	std::array<T, N> _res{};
+	for (std::size_t k{0}; k < N; k++)
+		_res[k] = _w[k].template to<T>();
+	return _res;
+}
+
+/// @brief Weights of the `DOrder`-th derivative at `x0` over the arbitrarily spaced points `x`
+/// @details The derivative is `sum(w[k] * f(x[k]))`, already divided by the spacings. Computed in floating-point arithmetic
+template <std::size_t DOrder, typename T, std::size_t N>
+constexpr std::array<T, N> finite_difference_weights(const std::array<T, N>& x, const T& x0)
+{
+	static_assert(N > DOrder, "function finite_difference_weights(): the stencil needs more points than the differentiation order.\n");
+	return internal::_fornberg<DOrder>(x, x0);
+}
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_FORNBERG
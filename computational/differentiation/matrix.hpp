@@ -0,0 +1,75 @@
+#ifndef FCPUT_COMPUTATIONAL_DIFFERENTIATION_MATRIX
+#define FCPUT_COMPUTATIONAL_DIFFERENTIATION_MATRIX
+
+#include "computational/common/common.hpp"
+#include "computational/mesh/grid.hpp"
+#include "computational/math_types/banded.hpp"
+#include "computational/differentiation/diff.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
+
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Matrix of the finite differences of `Differentiate` on `grid`: the `i`-th row holds the stencil weights of the
+/// `i`-th grid point, so that the product by the samples of a function is its derivative at all the grid points
+/// @details The rows use the same stencils (one-sided near the ends) and weights as `Differentiate`, stored in a band as wide
+/// as the longest of them; the rows of shorter stencils are padded with zeros, and the bands of the last rows are shifted to
+/// stay within the grid. Throws `std::domain_error` if the grid has fewer points than the stencils
+template <typename T, typename Method = central_difference, std::size_t DOrder = 1, std::size_t TOrder = 2, class Grid>
+FCP_COMPUTATIONAL_API BandedMatrix<T> differentiation_matrix(const Grid& grid)
+{
+	static_assert(internal::is_valid_grid<Grid>, "function differentiation_matrix(): invalid Grid class passed.\n");
+	static_assert(std::is_same_v<Method, central_difference> or
+								std::is_same_v<Method, backward_difference> or
+								std::is_same_v<Method, forward_difference>,
+								"function differentiation_matrix(): unsupported approximation method requested.\n");
+	using _S = internal::_stencils<T, Method, DOrder, TOrder>;
+	_S::check();
+
+	const std::size_t _n{ grid.end() }, _w{ _S::reach };
+	if (_n < _w)
+		throw std::domain_error("finite differences: the grid has too few points for the requested stencil.\n");
+	std::vector<std::size_t> _start(_n);
+	std::vector<T, fcp::algods::aligned_allocator<T>> _values(_w * _n, T{0});
+
+	// Place the weights `w(k)` of the stencil of `size` points starting at the grid point `j` in the band of the `i`-th row
+	auto _place = [&](const std::size_t& i, const std::size_t& j, const std::size_t& size, const auto& w)
+	{
+		_start[i] = std::min(j, _n - _w);
+		for (std::size_t k{0}; k < size; k++)
+			_values[(j - _start[i] + k) * _n + i] = w(k);
+	};
+
+	if constexpr (Grid::is_uniform_v)
+	{
+		const T _scale{ internal::_spacing_factor<DOrder, T>(grid) };
+		for (std::size_t i{0}; i < _n; i++)
+			internal::_select_stencil<T, Method, DOrder, TOrder>(i, _n, [&](auto s)
+			{
+				using _s_t = decltype(s);
+				_place(i, internal::_stencil_start<_s_t>(i, _n), _s_t::coeff.size(), [&](const std::size_t& k) { return _s_t::coeff[k] * _scale; });
+			});
+	}
+	else
+	{
+		const auto _table{ internal::_make_weight_table<T, Method, DOrder, TOrder>(grid, 0, _n) };
+		for (std::size_t i{0}; i < _n; i++)
+		{
+			const std::size_t _size{ internal::_select_stencil<T, Method, DOrder, TOrder>(i, _n, [](auto s) { return decltype(s)::coeff.size(); }) };
+			_place(i, _table.start[i], _size, [&](const std::size_t& k) { return _table.weights[k * _n + i]; });
+		}
+	}
+	return BandedMatrix<T>(_n, _n, _w, std::move(_start), std::move(_values));
+}
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_DIFFERENTIATION_MATRIX
@@ -0,0 +1,414 @@
+#ifndef FCPUT_COMPUTATIONAL_OPERATORS
+#define FCPUT_COMPUTATIONAL_OPERATORS
+
+#include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "computational/mesh/grid.hpp"
+#include "computational/differentiation/diff.hpp"
+#include "algo_ds/simd/stencil.hpp"
+
+#include <type_traits>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <initializer_list>
+#include <tuple>
+
+/* Differential operators over the fields of a structured grid (1-D to 3-D).
+ *
+ * Every operator is a sum of terms, each one the finite difference stencil of an axis applied to an
+ * input field and added to an output field. They are evaluated line by line along the first axis,
+ * which is the unit-stride one: along a line, the stencils of the other axes have the same weights,
+ * so each line of an output is a linear combination of lines of the inputs, computed with SIMD
+ * registers. The lines are visited tile by tile: `nd_tile_width` points along the first axis times
+ * `nd_tile_height` lines along the second, marching along the third, so that the planes under the
+ * stencils stay in the cache and each tile of the inputs is read from memory once for all the
+ * stencil points, all the terms and all the outputs.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Number of points along the first axis of the tiles of the multi-dimensional operators
+constexpr std::size_t nd_tile_width{ 512 };
+
+/// @brief Number of lines along the second axis of the tiles of the multi-dimensional operators
+constexpr std::size_t nd_tile_height{ 16 };
+
+namespace internal
+{
+	// Fields of the operators, in a non-deduced context so that `std::vector`s convert to them
+	template <typename T>
+	using _nd_in = span<const typename std::remove_cv_t<T>>;
+
+	template <typename T>
+	using _nd_out = span<typename std::remove_cv_t<T>>;
+
+	// Stencils of a method along an axis, with the weights scaled by 1/h^DOrder
+	template <typename T>
+	struct _axis_stencil
+	{
+		std::vector<T> interior, left, right;
+		std::ptrdiff_t first;
+	};
+
+	template <typename T, typename Method, std::size_t DOrder, std::size_t TOrder>
+	FCP_COMPUTATIONAL_API _axis_stencil<T> _make_axis_stencil(const T& h, const T& sign = T{1})
+	{
+		using _S = _stencils<T, Method, DOrder, TOrder>;
+		_S::check();
+		T _scale{sign};
+		for (std::size_t d{0}; d < DOrder; d++)
+			_scale /= h;
+		auto _scaled = [&](const auto& coeff)
+		{
+			std::vector<T> _res(coeff.begin(), coeff.end());
+			for (auto& _c : _res)
+				_c *= _scale;
+			return _res;
+		};
+		return { _scaled(_S::interior::coeff), _scaled(_S::left::coeff), _scaled(_S::right::coeff), _S::interior::first };
+	}
+
+	// Weights and first point of the stencil at the position `p` of an axis of `n` points (see `_select_stencil()`)
+	template <typename T>
+	FCP_COMPUTATIONAL_API std::pair<const std::vector<T>*, std::size_t> _axis_stencil_at(const _axis_stencil<T>& s, const std::size_t& p,
+																																											 const std::size_t& n)
+	{
+		const std::ptrdiff_t _p{ static_cast<std::ptrdiff_t>(p) }, _j{ _p + s.first };
+		const std::vector<T>* _w{ &s.interior };
+		std::ptrdiff_t _start{ _j };
+		if (_j < 0)
+		{
+			_w = &s.left;
+			_start = _p;
+		}
+		else if (static_cast<std::size_t>(_j) + s.interior.size() > n)
+		{
+			_w = &s.right;
+			_start = _p + 1 - static_cast<std::ptrdiff_t>(s.right.size());
+		}
+		if (_start < 0 or static_cast<std::size_t>(_start) + _w->size() > n)
+			throw std::domain_error("finite differences: the grid has too few points for the requested stencil.\n");
+		return { _w, static_cast<std::size_t>(_start) };
+	}
+
+	// Term of an operator: `stencil` along `axis` applied to the input field `input`, added to the output field `output`
+	template <typename T>
+	struct _nd_term
+	{
+		std::size_t input, output, axis;
+		_axis_stencil<T> stencil;
+	};
+
+	// Points of an axis of `n` points where the central stencil `s` fits: [first, second)
+	template <typename T>
+	FCP_COMPUTATIONAL_API std::pair<std::size_t, std::size_t> _stencil_fit(const _axis_stencil<T>& s, const std::size_t& n)
+	{
+		const std::ptrdiff_t _last{ static_cast<std::ptrdiff_t>(n) - static_cast<std::ptrdiff_t>(s.interior.size()) - s.first };
+		return { static_cast<std::size_t>(-s.first), _last < 0 ? 0 : static_cast<std::size_t>(_last) + 1 };
+	}
+
+	// Linear combination of the points of the inputs at `offset` from a given point
+	template <typename T>
+	struct _point_combination
+	{
+		std::vector<std::size_t> input;
+		std::vector<std::ptrdiff_t> offset;
+		std::vector<T> weight;
+
+		void add(const std::size_t& i, const std::ptrdiff_t& o, const T& w)
+		{
+			for (std::size_t m{0}; m < input.size(); m++)
+				if (input[m] == i and offset[m] == o)
+				{
+					weight[m] += w;
+					return;
+				}
+			input.push_back(i);
+			offset.push_back(o);
+			weight.push_back(w);
+		}
+	};
+
+	// Evaluation plan of an output, the same for all its lines. Along the first axis, the central stencils fit on the points
+	// [lo, hi); `edge[e]` is the combination of the one-sided stencils at the point `e` (if `e < lo`) or `hi + e - lo` (otherwise),
+	// relative to the first point of the line. The lines of `inner` positions (along the other axes) are those where the other
+	// stencils are the central ones as well: there, all the terms fold into the combinations `inner` (relative to the point)
+	// and `inner_edge`, so that no stencil has to be selected nor merged
+	template <typename T>
+	struct _output_plan
+	{
+		std::size_t lo, hi;
+		std::array<std::pair<std::size_t, std::size_t>, 3> inner_lines;
+		_point_combination<T> x_interior, inner;
+		std::vector<_point_combination<T>> edge, inner_edge;
+	};
+
+	template <typename T>
+	FCP_COMPUTATIONAL_API _output_plan<T> _make_output_plan(const std::vector<_nd_term<T>>& terms, const std::size_t& output,
+																													 const std::array<std::size_t, 3>& n, const std::array<std::size_t, 3>& s)
+	{
+		_output_plan<T> _res{ 0, n[0], { { { 0, n[0] }, { 0, n[1] }, { 0, n[2] } } }, {}, {}, {}, {} };
+		for (const auto& _t : terms)
+			if (_t.output == output)
+			{
+				auto& [_lo, _hi] = _res.inner_lines[_t.axis];
+				const auto [_flo, _fhi] = _stencil_fit(_t.stencil, n[_t.axis]);
+				_lo = std::max(_lo, _flo);
+				_hi = std::min(_hi, _fhi);
+				for (std::size_t m{0}; m < _t.stencil.interior.size(); m++)
+				{
+					const std::ptrdiff_t _o{ (_t.stencil.first + static_cast<std::ptrdiff_t>(m)) * static_cast<std::ptrdiff_t>(s[_t.axis]) };
+					_res.inner.add(_t.input, _o, _t.stencil.interior[m]);
+					if (0 == _t.axis)
+						_res.x_interior.add(_t.input, _o, _t.stencil.interior[m]);
+				}
+			}
+		for (auto& [_lo, _hi] : _res.inner_lines)
+			_hi = std::max(_lo, _hi);
+		std::tie(_res.lo, _res.hi) = _res.inner_lines[0];
+		_res.inner_lines[0] = { 0, 1 };
+
+		for (std::size_t i{0}; i < n[0]; i++)
+		{
+			if (i == _res.lo)
+				i = _res.hi;
+			if (i == n[0])
+				break;
+			_point_combination<T> _e, _ie;
+			for (const auto& _t : terms)
+				if (_t.output == output and 0 == _t.axis)
+				{
+					const auto [_tw, _start] = _axis_stencil_at(_t.stencil, i, n[0]);
+					for (std::size_t m{0}; m < _tw->size(); m++)
+						_e.add(_t.input, static_cast<std::ptrdiff_t>(_start + m), (*_tw)[m]);
+				}
+			_ie = _e;
+			for (const auto& _t : terms)
+				if (_t.output == output and 0 != _t.axis)
+					for (std::size_t m{0}; m < _t.stencil.interior.size(); m++)
+						_ie.add(_t.input, static_cast<std::ptrdiff_t>(i) + (_t.stencil.first + static_cast<std::ptrdiff_t>(m)) * static_cast<std::ptrdiff_t>(s[_t.axis]),
+										_t.stencil.interior[m]);
+			_res.edge.push_back(std::move(_e));
+			_res.inner_edge.push_back(std::move(_ie));
+		}
+		return _res;
+	}
+
+	// Add `w` times the line starting at `p` to a linear combination, merging the terms that read the same line
+	template <typename T>
+	FCP_COMPUTATIONAL_API void _add_line(std::vector<const T*>& lines, std::vector<T>& weights, const T* p, const T& w)
+	{
+		for (std::size_t m{0}; m < lines.size(); m++)
+			if (lines[m] == p)
+			{
+				weights[m] += w;
+				return;
+			}
+		lines.push_back(p);
+		weights.push_back(w);
+	}
+
+	// Evaluate the operator made of `terms` on the fields `in`, writing the `n_out` fields `out`
+	template <typename T, std::size_t D>
+	FCP_COMPUTATIONAL_API void _apply_terms(const StructuredGrid<T, D>& grid, const std::vector<_nd_term<T>>& terms, const T* const* in, T* const* out,
+																					const std::size_t& n_out)
+	{
+		namespace simd = fcp::algods::simd;
+		using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, simd::native, simd::scalar>;
+
+		std::array<std::size_t, 3> _n{ 1, 1, 1 }, _s{ 0, 0, 0 };
+		for (std::size_t a{0}; a < D; a++)
+		{
+			_n[a] = grid.extent(a);
+			_s[a] = grid.stride(a);
+		}
+
+		std::vector<_output_plan<T>> _plans;
+		for (std::size_t o{0}; o < n_out; o++)
+			_plans.push_back(_make_output_plan(terms, o, _n, _s));
+
+		// Lines of the inputs (at the first point of the line) combined by the terms along the other axes, then by all the terms
+		std::vector<const T*> _lines, _ptrs;
+		std::vector<T> _w, _kw;
+
+		for (std::size_t x0{0}; x0 < _n[0]; x0 += nd_tile_width)
+		{
+			const std::size_t x1{ std::min(_n[0], x0 + nd_tile_width) };
+			for (std::size_t y0{0}; y0 < _n[1]; y0 += nd_tile_height)
+				for (std::size_t k{0}; k < _n[2]; k++)
+					for (std::size_t j{y0}; j < std::min(_n[1], y0 + nd_tile_height); j++)
+					{
+						const std::size_t _line{ j * _s[1] + k * _s[2] };
+						const std::array<std::size_t, 3> _pos{ 0, j, k };
+						for (std::size_t o{0}; o < n_out; o++)
+						{
+							const _output_plan<T>& _plan{ _plans[o] };
+							const bool _inner{ _plan.inner_lines[1].first <= j and j < _plan.inner_lines[1].second and _plan.inner_lines[2].first <= k and
+																 k < _plan.inner_lines[2].second };
+							T* _out{ out[o] + _line };
+
+							// Points where all the stencils along the first axis are the central ones
+							const std::size_t _lo{ std::max(x0, _plan.lo) }, _hi{ std::min(x1, _plan.hi) };
+							_lines.clear();
+							_w.clear();
+							if (_inner)
+							{
+								if (_lo < _hi)
+								{
+									_ptrs.clear();
+									for (std::size_t m{0}; m < _plan.inner.input.size(); m++)
+										_ptrs.push_back(in[_plan.inner.input[m]] + _line + _lo + _plan.inner.offset[m]);
+									simd::linear_combination(_isa{}, _ptrs.data(), _plan.inner.weight.data(), _ptrs.size(), _out + _lo, _hi - _lo);
+								}
+							}
+							else
+							{
+								for (const auto& _t : terms)
+									if (_t.output == o and 0 != _t.axis)
+									{
+										const auto [_tw, _start] = _axis_stencil_at(_t.stencil, _pos[_t.axis], _n[_t.axis]);
+										const T* _base{ in[_t.input] + _line - _pos[_t.axis] * _s[_t.axis] };
+										for (std::size_t m{0}; m < _tw->size(); m++)
+											_add_line(_lines, _w, _base + (_start + m) * _s[_t.axis], (*_tw)[m]);
+									}
+								if (_lo < _hi)
+								{
+									_ptrs.clear();
+									_kw.assign(_w.begin(), _w.end());
+									for (const auto& _l : _lines)
+										_ptrs.push_back(_l + _lo);
+									const auto& _c{ _plan.x_interior };
+									for (std::size_t m{0}; m < _c.input.size(); m++)
+										_add_line(_ptrs, _kw, in[_c.input[m]] + _line + _lo + _c.offset[m], _c.weight[m]);
+									simd::linear_combination(_isa{}, _ptrs.data(), _kw.data(), _kw.size(), _out + _lo, _hi - _lo);
+								}
+							}
+
+							// Points near the ends of the first axis, with one-sided stencils along it
+							auto _point = [&](const std::size_t& i, const std::size_t& e)
+							{
+								const _point_combination<T>& _c{ _inner ? _plan.inner_edge[e] : _plan.edge[e] };
+								T _res{0};
+								for (std::size_t m{0}; m < _lines.size(); m++)
+									_res += _w[m] * _lines[m][i];
+								for (std::size_t m{0}; m < _c.input.size(); m++)
+									_res += _c.weight[m] * in[_c.input[m]][_line + _c.offset[m]];
+								_out[i] = _res;
+							};
+							for (std::size_t i{x0}; i < std::min(_plan.lo, x1); i++)
+								_point(i, i);
+							for (std::size_t i{std::max(_plan.hi, x0)}; i < x1; i++)
+								_point(i, _plan.lo + i - _plan.hi);
+						}
+					}
+		}
+	}
+
+	template <typename T, std::size_t D>
+	FCP_COMPUTATIONAL_API void _check_fields(const char* message, const StructuredGrid<T, D>& grid, const std::initializer_list<std::size_t>& sizes)
+	{
+		for (const auto& _n : sizes)
+			if (_n != grid.size())
+				throw std::invalid_argument(message);
+	}
+}	// namespace internal
+
+/// @brief `DOrder`-th partial derivative of the field `f` along the axis `Axis`, written into `out`
+/// @details The fields hold one value per grid point (see `StructuredGrid`) and must not overlap. Throws
+/// `std::invalid_argument` if their sizes differ from the one of the grid
+template <std::size_t Axis, std::size_t DOrder = 1, std::size_t TOrder = 2, typename Method = central_difference, typename T, std::size_t D>
+FCP_COMPUTATIONAL_API void partial(const StructuredGrid<T, D>& grid, const internal::_nd_in<T>& f, const internal::_nd_out<T>& out)
+{
+	static_assert(Axis < D, "function partial(): the axis exceeds the dimensions of the grid.\n");
+	internal::_check_fields("function partial(): the fields must have one value per grid point.\n", grid, { f.size(), out.size() });
+	const std::vector<internal::_nd_term<T>> _terms{ { 0, 0, Axis, internal::_make_axis_stencil<T, Method, DOrder, TOrder>(grid.spacing(Axis)) } };
+	const T* _in[]{ f.data() };
+	T* _out[]{ out.data() };
+	internal::_apply_terms(grid, _terms, _in, _out, 1);
+}
+
+/// @brief Gradient of the field `f`: its partial derivative along the axis `a` is written into `out[a]`
+template <std::size_t TOrder = 2, typename Method = central_difference, typename T, std::size_t D>
+FCP_COMPUTATIONAL_API void gradient(const StructuredGrid<T, D>& grid, const internal::_nd_in<T>& f, const std::array<internal::_nd_out<T>, D>& out)
+{
+	std::vector<internal::_nd_term<T>> _terms;
+	std::array<T*, D> _out;
+	for (std::size_t a{0}; a < D; a++)
+	{
+		internal::_check_fields("function gradient(): the fields must have one value per grid point.\n", grid, { f.size(), out[a].size() });
+		_terms.push_back({ 0, a, a, internal::_make_axis_stencil<T, Method, 1, TOrder>(grid.spacing(a)) });
+		_out[a] = out[a].data();
+	}
+	const T* _in[]{ f.data() };
+	internal::_apply_terms(grid, _terms, _in, _out.data(), D);
+}
+
+/// @brief Divergence of the vector field of components `v`, written into `out`
+template <std::size_t TOrder = 2, typename Method = central_difference, typename T, std::size_t D>
+FCP_COMPUTATIONAL_API void divergence(const StructuredGrid<T, D>& grid, const std::array<internal::_nd_in<T>, D>& v, const internal::_nd_out<T>& out)
+{
+	std::vector<internal::_nd_term<T>> _terms;
+	std::array<const T*, D> _in;
+	for (std::size_t a{0}; a < D; a++)
+	{
+		internal::_check_fields("function divergence(): the fields must have one value per grid point.\n", grid, { v[a].size(), out.size() });
+		_terms.push_back({ a, 0, a, internal::_make_axis_stencil<T, Method, 1, TOrder>(grid.spacing(a)) });
+		_in[a] = v[a].data();
+	}
+	T* _out[]{ out.data() };
+	internal::_apply_terms(grid, _terms, _in.data(), _out, 1);
+}
+
+/// @brief Curl of the three-dimensional vector field of components `v`, written into `out`
+template <std::size_t TOrder = 2, typename Method = central_difference, typename T>
+FCP_COMPUTATIONAL_API void curl(const StructuredGrid<T, 3>& grid, const std::array<internal::_nd_in<T>, 3>& v, const std::array<internal::_nd_out<T>, 3>& out)
+{
+	std::vector<internal::_nd_term<T>> _terms;
+	for (std::size_t c{0}; c < 3; c++)
+	{
+		internal::_check_fields("function curl(): the fields must have one value per grid point.\n", grid, { v[c].size(), out[c].size() });
+		// (curl v)_c = d v_{c+2} / d x_{c+1} - d v_{c+1} / d x_{c+2}
+		const std::size_t _a{ (c + 1) % 3 }, _b{ (c + 2) % 3 };
+		_terms.push_back({ _b, c, _a, internal::_make_axis_stencil<T, Method, 1, TOrder>(grid.spacing(_a)) });
+		_terms.push_back({ _a, c, _b, internal::_make_axis_stencil<T, Method, 1, TOrder>(grid.spacing(_b), T{-1}) });
+	}
+	const T* _in[]{ v[0].data(), v[1].data(), v[2].data() };
+	T* _out[]{ out[0].data(), out[1].data(), out[2].data() };
+	internal::_apply_terms(grid, _terms, _in, _out, 3);
+}
+
+/// @brief Curl of the two-dimensional vector field of components `v` (the scalar d v_1 / d x_0 - d v_0 / d x_1), written into `out`
+template <std::size_t TOrder = 2, typename Method = central_difference, typename T>
+FCP_COMPUTATIONAL_API void curl(const StructuredGrid<T, 2>& grid, const std::array<internal::_nd_in<T>, 2>& v, const internal::_nd_out<T>& out)
+{
+	internal::_check_fields("function curl(): the fields must have one value per grid point.\n", grid, { v[0].size(), v[1].size(), out.size() });
+	const std::vector<internal::_nd_term<T>> _terms{
+		{ 1, 0, 0, internal::_make_axis_stencil<T, Method, 1, TOrder>(grid.spacing(0)) },
+		{ 0, 0, 1, internal::_make_axis_stencil<T, Method, 1, TOrder>(grid.spacing(1), T{-1}) } };
+	const T* _in[]{ v[0].data(), v[1].data() };
+	T* _out[]{ out.data() };
+	internal::_apply_terms(grid, _terms, _in, _out, 1);
+}
+
+/// @brief Laplacian of the field `f`, written into `out`
+template <std::size_t TOrder = 2, typename Method = central_difference, typename T, std::size_t D>
+FCP_COMPUTATIONAL_API void laplacian(const StructuredGrid<T, D>& grid, const internal::_nd_in<T>& f, const internal::_nd_out<T>& out)
+{
+	internal::_check_fields("function laplacian(): the fields must have one value per grid point.\n", grid, { f.size(), out.size() });
+	std::vector<internal::_nd_term<T>> _terms;
+	for (std::size_t a{0}; a < D; a++)
+		_terms.push_back({ 0, 0, a, internal::_make_axis_stencil<T, Method, 2, TOrder>(grid.spacing(a)) });
+	const T* _in[]{ f.data() };
+	T* _out[]{ out.data() };
+	internal::_apply_terms(grid, _terms, _in, _out, 1);
+}
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_OPERATORS
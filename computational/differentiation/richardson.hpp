@@ -0,0 +1,183 @@
+#ifndef FCPUT_COMPUTATIONAL_RICHARDSON
+#define FCPUT_COMPUTATIONAL_RICHARDSON
+
+#include "computational/common/common.hpp"
+#include "computational/differentiation/diff.hpp"
+
+#include <type_traits>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/* Adaptive differentiation of functions by Richardson extrapolation.
+ *
+ * The lowest-order stencil of a method (second order for the central differences, first order for the
+ * one-sided ones) is evaluated with the steps h, h/2, h/4, ..., and each new estimate is combined with
+ * the previous row of the tableau to cancel the next term of the error expansion (in h^2, h^4, ... for
+ * the central stencils and h, h^2, ... for the one-sided ones). The difference between the last two
+ * extrapolations estimates the error; the evaluation stops as soon as it is below the tolerance, or
+ * when the tableau stops improving because rounding dominates (Ridders' criterion), returning the
+ * best estimate found.
+ *
+ * Halving the step maps every sample point of a level onto a point of the next one (the point at `o`
+ * steps of size h is at `2o` steps of size h/2), so the samples are cached by their offset in the
+ * finest step reached, reduced to the coarsest level where they appear: each level only evaluates the
+ * function at the new points, e.g. two for the central first derivative and one for the one-sided one.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Maximum number of step halvings of the Richardson tableau
+constexpr std::size_t richardson_max_levels{ 16 };
+
+/// @brief Result of an adaptive evaluation
+template <typename T>
+struct richardson_result
+{
+	T value;										// best estimate of the derivative
+	T error;										// estimate of its absolute error
+	std::size_t evaluations;		// number of calls of the function
+	std::size_t levels;					// number of steps used
+};
+
+namespace internal
+{
+	// Lowest truncation order of the stencils of a method, and exponent step of its error expansion
+	template <typename Method>
+	constexpr std::size_t _richardson_order = std::is_same_v<Method, central_difference> ? 2 : 1;
+
+	// Samples `f(x + offset * h / 2^level)`, each stored once at its coarsest level
+	template <typename T, std::size_t N>
+	struct _dyadic_samples
+	{
+		struct _entry
+		{
+			std::ptrdiff_t offset;
+			std::size_t level;
+			T value;
+		};
+
+		std::array<_entry, N> entries;
+		std::size_t size{0};
+
+		template <typename F>
+		T operator()(std::ptrdiff_t offset, std::size_t level, const T& x, const T& h, const F& f)
+		{
+			for (; level > 0 and offset % 2 == 0; level--)
+				offset /= 2;
+			for (std::size_t e{0}; e < size; e++)
+				if (entries[e].offset == offset and entries[e].level == level)
+					return entries[e].value;
+			const T _v{ f(x + std::ldexp(static_cast<T>(offset) * h, -static_cast<int>(level))) };
+			entries[size++] = { offset, level, _v };
+			return _v;
+		}
+	};
+}	// namespace internal
+
+/// @brief Adaptive differentiation of a function at any point, with the fewest evaluations for the requested accuracy
+/// @details The derivative is extrapolated from the stencils of `Method` with the steps `step * max(1, |x|)`, halved up to
+/// `levels - 1` times (see above). The `Functor` object is default-initialized, or copied from the one given
+template <typename T, class Functor, typename Method = central_difference, std::size_t DiffOrder = 1>
+class RichardsonDifferentiate
+{
+	// Pre C++20 Concepts
+	static_assert(std::is_floating_point_v<T>, "class RichardsonDifferentiate: only floating point types are supported.\n");
+	static_assert(internal::is_valid_math_function<Functor>, "class RichardsonDifferentiate: invalid Function class passed.\n");
+	static_assert(std::is_same_v<Method, central_difference> or
+								std::is_same_v<Method, backward_difference> or
+								std::is_same_v<Method, forward_difference>,
+								"class RichardsonDifferentiate: unsupported approximation method requested.\n");
+	static_assert(DiffOrder > 0, "class RichardsonDifferentiate: differential order must be a positive number.\n");
+
+	using _S = internal::_stencil<T, Method, DiffOrder, internal::_richardson_order<Method>>;
+
+	public:
+		/// @brief Generate a `RichardsonDifferentiate` object
+		/// @details Stops when the estimated error is below `tolerance * max(1, |derivative|)`. Throws `std::invalid_argument`
+		/// if `step` is not positive, `tolerance` is negative or `levels` is not in [2, richardson_max_levels]
+		RichardsonDifferentiate(const T& tolerance = std::sqrt(std::numeric_limits<T>::epsilon()), const T& step = T(0.1),
+														const std::size_t& levels = richardson_max_levels)
+			: m_functor(), m_tolerance{tolerance}, m_step{step}, m_levels{levels} { _check(); }
+
+		RichardsonDifferentiate(const Functor& functor, const T& tolerance = std::sqrt(std::numeric_limits<T>::epsilon()),
+														const T& step = T(0.1), const std::size_t& levels = richardson_max_levels)
+			: m_functor{functor}, m_tolerance{tolerance}, m_step{step}, m_levels{levels} { _check(); }
+
+		/// @brief Returns the derivative at `x`
+		FCP_COMPUTATIONAL_API T at(const T& x) const { return this->estimate(x).value; }
+
+		/// @brief Returns the derivative at `x`, with the estimate of its error and the work done
+		FCP_COMPUTATIONAL_API richardson_result<T> estimate(const T& x) const
+		{
+			constexpr std::size_t _p{ internal::_richardson_order<Method> };
+			const T _h{ m_step * std::max(T{1}, std::abs(x)) };
+			internal::_dyadic_samples<T, richardson_max_levels * _S::coeff.size()> _samples;
+			auto _f = [this](const T& p) { return m_functor(p); };
+
+			// Two rows of the tableau
+			std::array<T, richardson_max_levels> _prev{}, _row{};
+			richardson_result<T> _res{ T{0}, std::numeric_limits<T>::infinity(), 0, 0 };
+			for (std::size_t l{0}; l < m_levels; l++)
+			{
+				// Stencil with the step h / 2^l
+				T _d{0};
+				for (std::size_t k{0}; k < _S::coeff.size(); k++)
+					if (_S::coeff[k] != T{0})
+						_d += _S::coeff[k] * _samples(_S::first + static_cast<std::ptrdiff_t>(k), l, x, _h, _f);
+				T _hl{ std::ldexp(_h, -static_cast<int>(l)) }, _hd{1};
+				for (std::size_t d{0}; d < DiffOrder; d++)
+					_hd *= _hl;
+				_row[0] = _d / _hd;
+
+				// Extrapolations: the j-th one cancels the error term in h^(j*p)
+				T _factor{1};
+				for (std::size_t j{1}; j <= l; j++)
+				{
+					_factor *= static_cast<T>(1u << _p);
+					_row[j] = _row[j - 1] + (_row[j - 1] - _prev[j - 1]) / (_factor - T{1});
+					const T _err{ std::max(std::abs(_row[j] - _row[j - 1]), std::abs(_row[j] - _prev[j - 1])) };
+					if (_err <= _res.error)
+					{
+						_res.error = _err;
+						_res.value = _row[j];
+					}
+				}
+				_res.levels = l + 1;
+				if (0 == l)
+					_res.value = _row[0];
+				else if (_res.error <= m_tolerance * std::max(T{1}, std::abs(_res.value)))
+					break;
+				// Rounding errors dominate once the diagonal grows again
+				else if (l > 1 and std::abs(_row[l] - _prev[l - 1]) >= 2 * _res.error)
+					break;
+				std::swap(_prev, _row);
+			}
+			_res.evaluations = _samples.size;
+			return _res;
+		}
+
+	private:
+		void _check(void) const
+		{
+			if (not (m_step > T{0}))
+				throw std::invalid_argument("class RichardsonDifferentiate: the step must be positive.\n");
+			if (not (m_tolerance >= T{0}))
+				throw std::invalid_argument("class RichardsonDifferentiate: the tolerance must not be negative.\n");
+			if (m_levels < 2 or m_levels > richardson_max_levels)
+				throw std::invalid_argument("class RichardsonDifferentiate: the number of levels is out of range.\n");
+		}
+
+		Functor m_functor;
+		T m_tolerance, m_step;
+		std::size_t m_levels;
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_RICHARDSON
@@ -0,0 +1,167 @@
+#ifndef FCPUT_COMPUTATIONAL_SPECTRAL
+#define FCPUT_COMPUTATIONAL_SPECTRAL
+
+#include "computational/common/common.hpp"
+#include "computational/mesh/grid.hpp"
+#include "computational/fft/fft.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
+
+#include <type_traits>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+/* Spectral (Fourier) differentiation of periodic functions on uniform grids.
+ *
+ * The `n` points of the grid are taken as one period of the function, of length `n` times the spacing
+ * (so the last point is one spacing before the start of the next period). The samples are transformed
+ * once; the derivative of order `D` multiplies the `k`-th Fourier coefficient by `(i kappa_k)^D`, with
+ * `kappa_k = 2 pi k / L`, and transforms back. For smooth periodic functions the error decays faster
+ * than any power of the spacing, down to rounding, where finite differences only reach their
+ * truncation order. For odd orders the Nyquist coefficient of even sizes is dropped, since its
+ * derivative is not real.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+namespace internal
+{
+	// Multiply the `bins` coefficients of a real spectrum of `n` points over a period `length` by (i kappa_k)^DOrder
+	template <std::size_t DOrder, typename T>
+	inline void _spectral_derivative(const T* re, const T* im, T* out_re, T* out_im, const std::size_t& bins, const std::size_t& n, const T& length)
+	{
+		const T _dk{ _two_pi<T> / length };
+		for (std::size_t k{0}; k < bins; k++)
+		{
+			const T _kappa{ _dk * static_cast<T>(k) };
+			T _f{1};
+			for (std::size_t d{0}; d < DOrder; d++)
+				_f *= _kappa;
+			// i^DOrder
+			switch (DOrder % 4)
+			{
+				case 0: out_re[k] = _f * re[k]; out_im[k] = _f * im[k]; break;
+				case 1: out_re[k] = -_f * im[k]; out_im[k] = _f * re[k]; break;
+				case 2: out_re[k] = -_f * re[k]; out_im[k] = -_f * im[k]; break;
+				default: out_re[k] = _f * im[k]; out_im[k] = -_f * re[k]; break;
+			}
+		}
+		if (DOrder % 2 and n % 2 == 0)
+			out_re[bins - 1] = out_im[bins - 1] = T{0};
+	}
+}	// namespace internal
+
+/// @brief Spectral differentiation of a periodic function over the points of a uniform grid, one period long
+/// @details The size of the grid must have no prime factors other than 2, 3 and 5 (see `fft_plan`). The function is sampled
+/// and transformed once, at construction, together with the plans of the transforms, which all the evaluations reuse. The
+/// evaluations share the work arrays of the plans, so an object must not be used by several threads at once
+template <typename T, class Functor, class Grid, std::size_t DiffOrder = 1>
+class SpectralDifferentiate
+{
+	// Pre C++20 Concepts
+	static_assert(std::is_floating_point_v<T>, "class SpectralDifferentiate: only floating point types are supported.\n");
+	static_assert(internal::is_valid_grid<Grid>, "class SpectralDifferentiate: invalid Grid class passed.\n");
+	static_assert(std::is_copy_constructible<Grid>::value, "class SpectralDifferentiate: Grid class is not copy constructible.\n");
+	static_assert(internal::is_valid_math_function<Functor>, "class SpectralDifferentiate: invalid Function class passed.\n");
+	static_assert(Grid::is_uniform_v, "class SpectralDifferentiate: only uniform grids are supported.\n");
+
+	public:
+		/// @brief Generate a `SpectralDifferentiate` object
+		/// @details The `Grid` object is copy-constructed and the `Functor` object default-initialized. Throws
+		/// `std::invalid_argument` if the size of the grid has prime factors other than 2, 3 and 5
+		SpectralDifferentiate(const Grid& grid)
+			: m_grid{grid}, m_functor(), m_n{ m_grid.end() - m_grid.begin() }, m_plan(m_n),
+				m_length{ m_n > 1 ? (m_grid[1] - m_grid[0]) * static_cast<T>(m_n) : T{1} }, m_re(m_plan.bins()), m_im(m_plan.bins()),
+				m_cos(m_n), m_sin(m_n)
+		{
+			std::vector<T, fcp::algods::aligned_allocator<T>> _samples(m_n);
+			for (std::size_t j{0}; j < m_n; j++)
+				_samples[j] = m_functor(m_grid[j]);
+			m_plan.forward(_samples.data(), m_re.data(), m_im.data());
+
+			// exp(2 pi i j / n), for the evaluations at single points
+			for (std::size_t j{0}; j < m_n; j++)
+			{
+				const auto [_c, _s] = internal::_root<T>(j, m_n);
+				m_cos[j] = _c;
+				m_sin[j] = -_s;
+			}
+		}
+		SpectralDifferentiate(const SpectralDifferentiate&) = delete;
+		SpectralDifferentiate& operator=(const SpectralDifferentiate&) = delete;
+		SpectralDifferentiate& operator=(SpectralDifferentiate&&) = delete;
+
+		/// @brief Returns differential at `i`-th grid point while providing bounds checking through `Grid::at()` method
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API T at(const std::size_t& i) const
+		{
+			m_grid.at(i);
+			return this->operator[]<DOrder>(i);
+		}
+
+		/// @brief Returns differential at `i`-th grid point without any bounds checking
+		/// @details Sums the differentiated Fourier series at the point, in O(n) operations: `data()` is cheaper as soon as more
+		/// than about log(n) points are needed
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API T operator[](const std::size_t& i) const
+		{
+			const std::size_t _bins{ m_plan.bins() };
+			std::vector<T> _re(_bins), _im(_bins);
+			internal::_spectral_derivative<DOrder>(m_re.data(), m_im.data(), _re.data(), _im.data(), _bins, m_n, m_length);
+
+			// Hermitian symmetry: the coefficients k and n - k are conjugate, so the sum is twice the real part of the half one,
+			// except for the mean and the Nyquist coefficient
+			T _sum{ _re[0] };
+			for (std::size_t k{1}; k < _bins; k++)
+			{
+				const std::size_t _j{ (k * i) % m_n };
+				const T _term{ _re[k] * m_cos[_j] - _im[k] * m_sin[_j] };
+				_sum += 2 * k == m_n ? _term : 2 * _term;
+			}
+			return _sum / static_cast<T>(m_n);
+		}
+
+		/// @brief Compute array of values in the specified range of grid points
+		/// @details The derivative is computed over the whole period, as by `data()`, and the range is copied out of it.
+		/// Throws `std::out_of_range` if the range exceeds the grid
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API std::vector<T> at_range(const std::size_t& from, const std::size_t& to) const
+		{
+			if (from > to or to > m_n)
+				throw std::out_of_range("method SpectralDifferentiate::at_range(): range out of the grid was requested.\n");
+			const std::vector<T> _all{ this->data<DOrder>() };
+			return std::vector<T>(_all.begin() + from, _all.begin() + to);
+		}
+
+		/// @brief Compute array of values over all grid points and return it
+		/// @details One spectrum product and one inverse real FFT, using the plan generated at construction
+		template <std::size_t DOrder = DiffOrder>
+		FCP_COMPUTATIONAL_API std::vector<T> data(void) const
+		{
+			const std::size_t _bins{ m_plan.bins() };
+			std::vector<T, fcp::algods::aligned_allocator<T>> _re(_bins), _im(_bins);
+			internal::_spectral_derivative<DOrder>(m_re.data(), m_im.data(), _re.data(), _im.data(), _bins, m_n, m_length);
+			std::vector<T> _res(m_n);
+			m_plan.inverse(_re.data(), _im.data(), _res.data());
+			return _res;
+		}
+
+		/// @brief Length of the period: the number of grid points times the spacing
+		FCP_COMPUTATIONAL_API T period(void) const { return m_length; }
+
+	private:
+		Grid m_grid;
+		Functor m_functor;
+		std::size_t m_n;
+		real_fft_plan<T> m_plan;
+		T m_length;
+		std::vector<T, fcp::algods::aligned_allocator<T>> m_re, m_im;
+		std::vector<T> m_cos, m_sin;
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_SPECTRAL
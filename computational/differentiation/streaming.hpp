@@ -0,0 +1,120 @@
+#ifndef FCPUT_COMPUTATIONAL_STREAMING
+#define FCPUT_COMPUTATIONAL_STREAMING
+
+#include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "computational/differentiation/diff.hpp"
+#include "algo_ds/simd/stencil.hpp"
+
+#include <type_traits>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+/* Online differentiation of uniformly sampled streams.
+ *
+ * Only the past of a stream is known, so the derivative at the newest sample is the backward difference
+ * of the last `N` samples, `N` being the size of the backward stencil (`_bd_lut`) of the requested
+ * orders. These samples are kept in a ring buffer of fixed size, stored twice in a row so that the
+ * window of the stencil is always contiguous: a push writes one sample twice and applies the stencil,
+ * without any modulo, branch on the position or allocation. Blocks of samples are differentiated by the
+ * vectorized stencil directly over the block, the ring only providing the `N - 1` samples preceding it.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+/// @brief Differentiation of a stream of samples taken every `spacing`, one derivative per pushed sample
+/// @details The derivative at a sample is available once the `N - 1` previous ones have been pushed, `N` being the size of the
+/// backward stencil of truncation order `TruncationOrder`; before that `push()` returns a quiet NaN and `ready()` is false
+template <typename T, std::size_t DiffOrder = 1, std::size_t TruncationOrder = 2>
+class StreamingDifferentiation
+{
+	static_assert(std::is_floating_point_v<T>, "class StreamingDifferentiation: only floating point types are supported.\n");
+	static_assert(DiffOrder > 0, "class StreamingDifferentiation: differential order must be a positive number.\n");
+	static_assert(TruncationOrder > 0, "class StreamingDifferentiation: truncation order must be a positive number.\n");
+
+	public:
+		/// @brief Number of samples of the stencil
+		constexpr static std::size_t stencil_size = internal::_stencil_size<backward_difference, DiffOrder, TruncationOrder>;
+
+		/// @brief Generate a `StreamingDifferentiation` object for samples taken every `spacing`
+		/// @details Throws `std::invalid_argument` if `spacing` is not positive
+		explicit StreamingDifferentiation(const T& spacing): m_buffer{}
+		{
+			if (not (spacing > T{0}))
+				throw std::invalid_argument("class StreamingDifferentiation: the spacing must be positive.\n");
+			T _hd{1};
+			for (std::size_t d{0}; d < DiffOrder; d++)
+				_hd *= spacing;
+			for (std::size_t k{0}; k < stencil_size; k++)
+				m_coeff[k] = internal::_bd_lut<T, DiffOrder, TruncationOrder>[k] / _hd;
+		}
+
+		/// @brief Push a sample and return the derivative at it (a quiet NaN until `ready()`)
+		FCP_COMPUTATIONAL_API T push(const T& sample)
+		{
+			m_buffer[m_position] = m_buffer[m_position + stencil_size] = sample;
+			m_position = m_position + 1 == stencil_size ? 0 : m_position + 1;
+			if (m_count < stencil_size) m_count++;
+			if (m_count < stencil_size)
+				return std::numeric_limits<T>::quiet_NaN();
+
+			// Oldest sample first, as the backward stencil
+			const T* _window{ m_buffer.data() + m_position };
+			T _res{0};
+			for (std::size_t k{0}; k < stencil_size; k++)
+				_res += m_coeff[k] * _window[k];
+			return _res;
+		}
+
+		/// @brief Push a block of samples, writing the derivative at each of them into `out`
+		/// @details Same results as pushing the samples one by one. Throws `std::invalid_argument` if the sizes of `samples` and
+		/// `out` differ; `out` must not overlap `samples`
+		FCP_COMPUTATIONAL_API void push(const span<const T>& samples, const span<T>& out)
+		{
+			if (samples.size() != out.size())
+				throw std::invalid_argument("method StreamingDifferentiation::push(): the number of derivatives differs from the number of samples.\n");
+			const std::size_t _n{ samples.size() };
+			if (_n < stencil_size)
+			{
+				for (std::size_t j{0}; j < _n; j++)
+					out[j] = this->push(samples[j]);
+				return;
+			}
+
+			// The first samples need the ring, the following ones only the block
+			for (std::size_t j{0}; j + 1 < stencil_size; j++)
+				out[j] = this->push(samples[j]);
+			using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, fcp::algods::simd::native, fcp::algods::simd::scalar>;
+			fcp::algods::simd::stencil(_isa{}, samples.data(), m_coeff.data(), stencil_size, out.data() + (stencil_size - 1), _n - stencil_size + 1);
+
+			// The ring continues with the last samples of the block
+			for (std::size_t k{0}; k < stencil_size; k++)
+				m_buffer[k] = m_buffer[k + stencil_size] = samples[_n - stencil_size + k];
+			m_position = 0;
+			m_count = stencil_size;
+		}
+
+		/// @brief Whether the last push returned a derivative: `stencil_size` samples have been pushed since construction or `reset()`
+		FCP_COMPUTATIONAL_API bool ready(void) const { return m_count == stencil_size; }
+
+		/// @brief Forget the pushed samples
+		FCP_COMPUTATIONAL_API void reset(void)
+		{
+			m_position = 0;
+			m_count = 0;
+		}
+
+	private:
+		std::array<T, stencil_size> m_coeff;
+		// The last `stencil_size` samples, twice: the window of the stencil is [m_position, m_position + stencil_size)
+		std::array<T, 2 * stencil_size> m_buffer;
+		std::size_t m_position{0}, m_count{0};
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_STREAMING
@@ -0,0 +1,432 @@
+#ifndef FCPUT_COMPUTATIONAL_FFT
+#define FCPUT_COMPUTATIONAL_FFT
+
+#include "computational/common/common.hpp"
+#include "algo_ds/simd/common_simd.hpp"
+#include "algo_ds/simd/sse.hpp"
+#include "algo_ds/simd/avx.hpp"
+#include "algo_ds/simd/avx512.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
+
+#include <type_traits>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+/* Fast Fourier transforms of sizes 2^a 3^b 5^c.
+ *
+ * The complex transforms are self-sorting (Stockham) decimations in frequency: each stage of radix R
+ * reads `R` interleaved sub-sequences of the previous one and writes their butterflies next to each
+ * other, so no bit reversal is needed and every stage goes through contiguous runs of `s` elements,
+ * `s` being the product of the radices of the previous stages. These runs are processed by SIMD
+ * registers as soon as they are wide enough, with one broadcast twiddle per butterfly. The first stage
+ * is vectorized over its butterflies instead, and the stages in between, with runs shorter than a
+ * register, are scalar. Complex data are stored as separate arrays of real and imaginary parts.
+ *
+ * A plan computes the factorization, the twiddles and the work arrays of a size once, for all its
+ * transforms; it is not thread-safe, as the transforms use its work arrays. The real transforms of an
+ * even size are complex transforms of half the size of the even and odd samples, untangled afterwards.
+ *
+ * Conventions: the forward transform is X[k] = sum_j x[j] exp(-2 pi i j k / n), the inverse one is
+ * normalized by 1/n, so that it undoes the forward one.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+namespace internal
+{
+	template <typename T>
+	using _fft_isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, fcp::algods::simd::native, fcp::algods::simd::scalar>;
+
+	// Complex register
+	template <typename P>
+	struct _cx
+	{
+		typename P::type re, im;
+	};
+
+	template <typename P>
+	inline _cx<P> _cadd(const _cx<P>& a, const _cx<P>& b) { return { P::add(a.re, b.re), P::add(a.im, b.im) }; }
+
+	template <typename P>
+	inline _cx<P> _csub(const _cx<P>& a, const _cx<P>& b) { return { P::sub(a.re, b.re), P::sub(a.im, b.im) }; }
+
+	template <typename P>
+	inline _cx<P> _cmul(const _cx<P>& a, const _cx<P>& b)
+	{
+		return { P::sub(P::mul(a.re, b.re), P::mul(a.im, b.im)), P::fmadd(a.re, b.im, P::mul(a.im, b.re)) };
+	}
+
+	template <typename P>
+	inline _cx<P> _cscale(const _cx<P>& a, const typename P::type& c) { return { P::mul(a.re, c), P::mul(a.im, c) }; }
+
+	// Product by -i
+	template <typename P>
+	inline _cx<P> _cmul_mi(const _cx<P>& a) { return { a.im, P::sub(P::zero(), a.re) }; }
+
+	// In-place DFT of `R` points, exp(-2 pi i / R) being the root of unity
+	template <typename P, std::size_t R>
+	struct _butterfly;
+
+	template <typename P>
+	struct _butterfly<P, 2>
+	{
+		static inline void apply(_cx<P>* a)
+		{
+			const _cx<P> _a0{ a[0] };
+			a[0] = _cadd(_a0, a[1]);
+			a[1] = _csub(_a0, a[1]);
+		}
+	};
+
+	template <typename P>
+	struct _butterfly<P, 3>
+	{
+		static inline void apply(_cx<P>* a)
+		{
+			using _T = typename P::scalar_type;
+			const _cx<P> _t1{ _cadd(a[1], a[2]) };
+			const _cx<P> _t2{ _csub(a[0], _cscale(_t1, P::set1(_T(0.5L)))) };
+			const _cx<P> _d{ _cmul_mi(_cscale(_csub(a[1], a[2]), P::set1(_T(0.866025403784438646763723170752936183L)))) };
+			a[0] = _cadd(a[0], _t1);
+			a[1] = _cadd(_t2, _d);
+			a[2] = _csub(_t2, _d);
+		}
+	};
+
+	template <typename P>
+	struct _butterfly<P, 4>
+	{
+		static inline void apply(_cx<P>* a)
+		{
+			const _cx<P> _s02{ _cadd(a[0], a[2]) }, _d02{ _csub(a[0], a[2]) };
+			const _cx<P> _s13{ _cadd(a[1], a[3]) }, _d13{ _cmul_mi(_csub(a[1], a[3])) };
+			a[0] = _cadd(_s02, _s13);
+			a[1] = _cadd(_d02, _d13);
+			a[2] = _csub(_s02, _s13);
+			a[3] = _csub(_d02, _d13);
+		}
+	};
+
+	template <typename P>
+	struct _butterfly<P, 5>
+	{
+		static inline void apply(_cx<P>* a)
+		{
+			using _T = typename P::scalar_type;
+			const typename P::type _c1{ P::set1(_T(0.309016994374947424102293417182819059L)) }, _c2{ P::set1(_T(-0.809016994374947424102293417182819059L)) };
+			const typename P::type _s1{ P::set1(_T(0.951056516295153572116439333379382143L)) }, _s2{ P::set1(_T(0.587785252292473129168705954639072769L)) };
+			const _cx<P> _b1{ _cadd(a[1], a[4]) }, _b2{ _cadd(a[2], a[3]) }, _d1{ _csub(a[1], a[4]) }, _d2{ _csub(a[2], a[3]) };
+			const _cx<P> _e1{ _cadd(a[0], _cadd(_cscale(_b1, _c1), _cscale(_b2, _c2))) };
+			const _cx<P> _e2{ _cadd(a[0], _cadd(_cscale(_b1, _c2), _cscale(_b2, _c1))) };
+			const _cx<P> _f1{ _cmul_mi(_cadd(_cscale(_d1, _s1), _cscale(_d2, _s2))) };
+			const _cx<P> _f2{ _cmul_mi(_csub(_cscale(_d1, _s2), _cscale(_d2, _s1))) };
+			a[0] = _cadd(a[0], _cadd(_b1, _b2));
+			a[1] = _cadd(_e1, _f1);
+			a[4] = _csub(_e1, _f1);
+			a[2] = _cadd(_e2, _f2);
+			a[3] = _csub(_e2, _f2);
+		}
+	};
+
+	// Elements [q0, q1) of the runs of a stage of radix `R`: y[q + s*(R*p + k)] = w^(p*k) * DFT_R(x[q + s*(p + j*m)])_k
+	template <typename P, std::size_t R, typename T>
+	inline void _fft_stage(const std::size_t& m, const std::size_t& s, const T* xr, const T* xi, T* yr, T* yi, const T* wr, const T* wi,
+												 const std::size_t& q0, const std::size_t& q1)
+	{
+		for (std::size_t p{0}; p < m; p++)
+		{
+			_cx<P> _w[R];
+			for (std::size_t k{1}; k < R; k++)
+				_w[k] = { P::set1(wr[(k - 1) * m + p]), P::set1(wi[(k - 1) * m + p]) };
+			for (std::size_t q{q0}; q < q1; q += P::width)
+			{
+				_cx<P> _a[R];
+				for (std::size_t j{0}; j < R; j++)
+					_a[j] = { P::loadu(xr + q + s * (p + j * m)), P::loadu(xi + q + s * (p + j * m)) };
+				_butterfly<P, R>::apply(_a);
+				P::storeu(yr + q + s * R * p, _a[0].re);
+				P::storeu(yi + q + s * R * p, _a[0].im);
+				for (std::size_t k{1}; k < R; k++)
+				{
+					const _cx<P> _y{ _cmul(_a[k], _w[k]) };
+					P::storeu(yr + q + s * (R * p + k), _y.re);
+					P::storeu(yi + q + s * (R * p + k), _y.im);
+				}
+			}
+		}
+	}
+
+	// Butterflies [p0, p1) of the first stage (runs of a single element), vectorized over the butterflies: the inputs and the
+	// twiddles are contiguous, the outputs are interleaved by `R` and scattered through a buffer
+	template <typename P, std::size_t R, typename T>
+	inline void _fft_first_stage(const std::size_t& m, const T* xr, const T* xi, T* yr, T* yi, const T* wr, const T* wi,
+															 const std::size_t& p0, const std::size_t& p1)
+	{
+		alignas(64) T _br[R * P::width], _bi[R * P::width];
+		for (std::size_t p{p0}; p < p1; p += P::width)
+		{
+			_cx<P> _a[R];
+			for (std::size_t j{0}; j < R; j++)
+				_a[j] = { P::loadu(xr + p + j * m), P::loadu(xi + p + j * m) };
+			_butterfly<P, R>::apply(_a);
+			for (std::size_t k{1}; k < R; k++)
+				_a[k] = _cmul(_a[k], _cx<P>{ P::loadu(wr + (k - 1) * m + p), P::loadu(wi + (k - 1) * m + p) });
+			for (std::size_t k{0}; k < R; k++)
+			{
+				P::storeu(_br + k * P::width, _a[k].re);
+				P::storeu(_bi + k * P::width, _a[k].im);
+			}
+			for (std::size_t l{0}; l < P::width; l++)
+				for (std::size_t k{0}; k < R; k++)
+				{
+					yr[R * (p + l) + k] = _br[k * P::width + l];
+					yi[R * (p + l) + k] = _bi[k * P::width + l];
+				}
+		}
+	}
+
+	// Whole stage: the runs are split between the SIMD registers and the scalar remainder
+	template <typename T, std::size_t R>
+	inline void _fft_stage(const std::size_t& m, const std::size_t& s, const T* xr, const T* xi, T* yr, T* yi, const T* wr, const T* wi)
+	{
+		using _P = fcp::algods::simd::pack<T, _fft_isa<T>>;
+		if (1 == s)
+		{
+			const std::size_t _pend{ m - m % _P::width };
+			_fft_first_stage<_P, R>(m, xr, xi, yr, yi, wr, wi, 0, _pend);
+			_fft_first_stage<fcp::algods::simd::pack<T, fcp::algods::simd::scalar>, R>(m, xr, xi, yr, yi, wr, wi, _pend, m);
+			return;
+		}
+		const std::size_t _vend{ s - s % _P::width };
+		if (_vend > 0)
+			_fft_stage<_P, R>(m, s, xr, xi, yr, yi, wr, wi, 0, _vend);
+		if (_vend < s)
+			_fft_stage<fcp::algods::simd::pack<T, fcp::algods::simd::scalar>, R>(m, s, xr, xi, yr, yi, wr, wi, _vend, s);
+	}
+
+	template <typename T>
+	constexpr T _two_pi{ T(6.283185307179586476925286766559005768L) };
+
+	// exp(-2 pi i j / n), computed in extended precision
+	template <typename T>
+	inline std::pair<T, T> _root(const std::size_t& j, const std::size_t& n)
+	{
+		const long double _a{ _two_pi<long double> * static_cast<long double>(j % n) / static_cast<long double>(n) };
+		return { static_cast<T>(std::cos(_a)), static_cast<T>(-std::sin(_a)) };
+	}
+}	// namespace internal
+
+/// @brief Plan of the complex FFTs of `n` points, `n` having no prime factors other than 2, 3 and 5
+/// @details The real and the imaginary parts are separate arrays, transformed in place. The radix-4 stages are used first,
+/// then the radix-2, 3 and 5 ones
+template <typename T>
+class fft_plan
+{
+	static_assert(std::is_floating_point_v<T>, "class fft_plan: only floating point types are supported.\n");
+
+	public:
+		/// @brief Factorize `n` and compute the twiddles of every stage
+		/// @details Throws `std::invalid_argument` if `n` is zero or has prime factors other than 2, 3 and 5
+		explicit fft_plan(const std::size_t& n): m_n{n}, m_work_re(n), m_work_im(n)
+		{
+			if (0 == n)
+				throw std::invalid_argument("class fft_plan: the size must be positive.\n");
+			std::size_t _rest{n};
+			std::vector<std::size_t> _radices;
+			for (const std::size_t _r : { 4, 2, 3, 5 })
+				for (; _rest % _r == 0; _rest /= _r)
+					_radices.push_back(_r);
+			if (_rest != 1)
+				throw std::invalid_argument("class fft_plan: the size must have no prime factors other than 2, 3 and 5.\n");
+
+			std::size_t _n_s{n}, _s{1};
+			for (const auto& _r : _radices)
+			{
+				const std::size_t _m{ _n_s / _r };
+				m_stages.push_back({ _r, _m, _s, m_wr.size() });
+				for (std::size_t k{1}; k < _r; k++)
+					for (std::size_t p{0}; p < _m; p++)
+					{
+						const auto [_c, _sn] = internal::_root<T>(p * k, _n_s);
+						m_wr.push_back(_c);
+						m_wi.push_back(_sn);
+					}
+				_n_s = _m;
+				_s *= _r;
+			}
+		}
+
+		/// @brief Number of points
+		std::size_t size(void) const { return m_n; }
+
+		/// @brief Forward transform of the `size()` complex values `re[j] + i im[j]`, in place
+		void forward(T* re, T* im) const
+		{
+			T *_xr{re}, *_xi{im}, *_yr{m_work_re.data()}, *_yi{m_work_im.data()};
+			for (const auto& _st : m_stages)
+			{
+				const T *_wr{ m_wr.data() + _st.twiddles }, *_wi{ m_wi.data() + _st.twiddles };
+				switch (_st.radix)
+				{
+					case 2: internal::_fft_stage<T, 2>(_st.m, _st.s, _xr, _xi, _yr, _yi, _wr, _wi); break;
+					case 3: internal::_fft_stage<T, 3>(_st.m, _st.s, _xr, _xi, _yr, _yi, _wr, _wi); break;
+					case 4: internal::_fft_stage<T, 4>(_st.m, _st.s, _xr, _xi, _yr, _yi, _wr, _wi); break;
+					default: internal::_fft_stage<T, 5>(_st.m, _st.s, _xr, _xi, _yr, _yi, _wr, _wi); break;
+				}
+				std::swap(_xr, _yr);
+				std::swap(_xi, _yi);
+			}
+			if (_xr != re)
+				for (std::size_t j{0}; j < m_n; j++)
+				{
+					re[j] = _xr[j];
+					im[j] = _xi[j];
+				}
+		}
+
+		/// @brief Inverse transform (normalized by 1/size()) of the `size()` complex values `re[k] + i im[k]`, in place
+		void inverse(T* re, T* im) const
+		{
+			// ifft(X) = conj(fft(conj(X))) / n
+			for (std::size_t j{0}; j < m_n; j++)
+				im[j] = -im[j];
+			this->forward(re, im);
+			const T _scale{ T{1} / static_cast<T>(m_n) };
+			for (std::size_t j{0}; j < m_n; j++)
+			{
+				re[j] *= _scale;
+				im[j] *= -_scale;
+			}
+		}
+
+	private:
+		struct _stage
+		{
+			std::size_t radix, m, s, twiddles;
+		};
+
+		std::size_t m_n;
+		std::vector<_stage> m_stages;
+		std::vector<T, fcp::algods::aligned_allocator<T>> m_wr, m_wi;
+		mutable std::vector<T, fcp::algods::aligned_allocator<T>> m_work_re, m_work_im;
+};
+
+/// @brief Plan of the FFTs of `n` real points, `n` having no prime factors other than 2, 3 and 5
+/// @details The spectrum of real data is Hermitian, so only its `bins() = n/2 + 1` first values are computed (or used by the
+/// inverse transform). Even sizes use a complex plan of `n/2` points, odd ones a complex plan of `n` points
+template <typename T>
+class real_fft_plan
+{
+	public:
+		/// @brief Generate the plan; throws `std::invalid_argument` if `n` is zero or has prime factors other than 2, 3 and 5
+		explicit real_fft_plan(const std::size_t& n)
+			: m_n{n}, m_complex{ n % 2 ? n : n / 2 }, m_zr(m_complex.size()), m_zi(m_complex.size())
+		{
+			if (0 == n % 2)
+				for (std::size_t k{0}; k <= n / 2; k++)
+				{
+					const auto [_c, _s] = internal::_root<T>(k, n);
+					m_tr.push_back(_c);
+					m_ti.push_back(_s);
+				}
+		}
+
+		/// @brief Number of real points
+		std::size_t size(void) const { return m_n; }
+
+		/// @brief Number of complex values of the spectrum: size()/2 + 1
+		std::size_t bins(void) const { return m_n / 2 + 1; }
+
+		/// @brief Forward transform of the `size()` values `x`, writing the `bins()` first values of the spectrum into `re` and `im`
+		void forward(const T* x, T* re, T* im) const
+		{
+			const std::size_t _h{ m_complex.size() };
+			if (m_n % 2)
+			{
+				for (std::size_t j{0}; j < m_n; j++)
+				{
+					m_zr[j] = x[j];
+					m_zi[j] = T{0};
+				}
+				m_complex.forward(m_zr.data(), m_zi.data());
+				for (std::size_t k{0}; k < this->bins(); k++)
+				{
+					re[k] = m_zr[k];
+					im[k] = m_zi[k];
+				}
+				return;
+			}
+
+			// Transform of the even samples plus i times the odd ones
+			for (std::size_t j{0}; j < _h; j++)
+			{
+				m_zr[j] = x[2 * j];
+				m_zi[j] = x[2 * j + 1];
+			}
+			m_complex.forward(m_zr.data(), m_zi.data());
+
+			// X[k] = E[k] + exp(-2 pi i k / n) O[k], with E[k] = (Z[k] + conj(Z[h-k])) / 2 and O[k] = -i (Z[k] - conj(Z[h-k])) / 2
+			for (std::size_t k{0}; k <= _h; k++)
+			{
+				const std::size_t _k{ k % _h }, _c{ (_h - k) % _h };
+				const T _er{ (m_zr[_k] + m_zr[_c]) / 2 }, _ei{ (m_zi[_k] - m_zi[_c]) / 2 };
+				const T _or{ (m_zi[_k] + m_zi[_c]) / 2 }, _oi{ (m_zr[_c] - m_zr[_k]) / 2 };
+				re[k] = _er + m_tr[k] * _or - m_ti[k] * _oi;
+				im[k] = _ei + m_tr[k] * _oi + m_ti[k] * _or;
+			}
+		}
+
+		/// @brief Inverse transform (normalized by 1/size()) of the `bins()` first values of a spectrum, writing the `size()` values `x`
+		void inverse(const T* re, const T* im, T* x) const
+		{
+			const std::size_t _h{ m_complex.size() };
+			if (m_n % 2)
+			{
+				for (std::size_t k{0}; k < this->bins(); k++)
+				{
+					m_zr[k] = re[k];
+					m_zi[k] = im[k];
+					if (k > 0)
+					{
+						m_zr[m_n - k] = re[k];
+						m_zi[m_n - k] = -im[k];
+					}
+				}
+				m_complex.inverse(m_zr.data(), m_zi.data());
+				for (std::size_t j{0}; j < m_n; j++)
+					x[j] = m_zr[j];
+				return;
+			}
+
+			// Z[k] = E[k] + i O[k], with E[k] = (X[k] + conj(X[h-k])) / 2 and O[k] = exp(2 pi i k / n) (X[k] - conj(X[h-k])) / 2
+			for (std::size_t k{0}; k < _h; k++)
+			{
+				const T _er{ (re[k] + re[_h - k]) / 2 }, _ei{ (im[k] - im[_h - k]) / 2 };
+				const T _dr{ (re[k] - re[_h - k]) / 2 }, _di{ (im[k] + im[_h - k]) / 2 };
+				const T _or{ m_tr[k] * _dr + m_ti[k] * _di }, _oi{ m_tr[k] * _di - m_ti[k] * _dr };
+				m_zr[k] = _er - _oi;
+				m_zi[k] = _ei + _or;
+			}
+			m_complex.inverse(m_zr.data(), m_zi.data());
+			for (std::size_t j{0}; j < _h; j++)
+			{
+				x[2 * j] = m_zr[j];
+				x[2 * j + 1] = m_zi[j];
+			}
+		}
+
+	private:
+		std::size_t m_n;
+		fft_plan<T> m_complex;
+		std::vector<T, fcp::algods::aligned_allocator<T>> m_tr, m_ti;
+		mutable std::vector<T, fcp::algods::aligned_allocator<T>> m_zr, m_zi;
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_FFT
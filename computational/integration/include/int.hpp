@@ -2,8 +2,10 @@
 #define FCPUT_COMPUTATIONAL_INTEGRATION
 
 
-#include "../../utility/utility.hpp"
+#include "computational/common/common.hpp"
+#include "algo_ds/simd/scan.hpp"
 
+#include <cstddef>
 #include <vector>
 
 START_FCP_NAMESPACE
@@ -26,6 +28,35 @@ class Integrate
 		std::vector<T> data(void);
 };
 
+/// @brief Running integral of `n` samples taken with uniform spacing `h`
+/// @details `out[i]` is the integral from the first to the `i`-th sample, computed with a single
+/// prefix sum over the samples. Only the rectangular (left endpoint) and trapezoidal rules are
+/// available, since the other ones need more than one new sample per interval.
+/// `out` may coincide with `samples`
+template <int_method Method = int_method::TRAPEZOIDAL, typename T>
+FCP_COMPUTATIONAL_API void cumulative_integral(const T* samples, const std::size_t& n, const T& h, T* out)
+{
+	static_assert(Method == int_method::RECTANGULAR or Method == int_method::TRAPEZOIDAL,
+								"function cumulative_integral: only the rectangular and trapezoidal rules are supported.\n");
+	namespace simd = fcp::algods::simd;
+
+	if (0 == n) return;
+	if constexpr (Method == int_method::RECTANGULAR)
+	{
+		simd::exclusive_scan(samples, out, n);
+		for (std::size_t i{0}; i < n; i++)
+			out[i] *= h;
+	} else {
+		// With S_i = f_0 + ... + f_i: h * (f_0/2 + f_1 + ... + f_{i-1} + f_i/2) = h/2 * (S_i + S_{i-1} - f_0),
+		// which only needs the scanned values, so the samples may already have been overwritten
+		const T _f0{ samples[0] };
+		simd::inclusive_scan(samples, out, n);
+		for (std::size_t i{n - 1}; i > 0; i--)
+			out[i] = h / 2 * (out[i] + out[i - 1] - _f0);
+		out[0] = T{0};
+	}
+}
+
 END_COMPUTATIONAL_NAMESPACE
 END_FCP_NAMESPACE
 
@@ -0,0 +1,192 @@
+#ifndef FCPUT_COMPUTATIONAL_BANDED
+#define FCPUT_COMPUTATIONAL_BANDED
+
+#include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "algo_ds/simd/stencil.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
+
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/* Sparse matrices whose nonzeros lie, on each row, within `width` consecutive columns.
+ *
+ * The band of the `i`-th row starts at the column `start[i]`, and its `k`-th element is stored at
+ * `values[k * rows + i]`: one array per position in the band, so that the elements of consecutive rows
+ * are contiguous. On the runs of rows whose bands shift by one column per row (e.g. the interior of a
+ * stencil operator), the columns read by consecutive rows are contiguous too, so the product by a
+ * vector is a variable stencil (see algo_ds/simd/stencil.hpp), computed in SIMD registers without any
+ * gather. The runs are found once, at construction.
+ *
+ * The transpose of such a matrix is of the same kind; it is assembled at construction as well, so that
+ * the products by the transpose, needed by adjoint and least-squares methods, are as fast as the direct
+ * ones instead of scattering.
+ */
+
+START_FCP_NAMESPACE
+START_COMPUTATIONAL_NAMESPACE
+
+namespace internal
+{
+	// Storage of a banded matrix (see above), with the runs [first, second) of rows whose bands shift by one column per row
+	template <typename T>
+	struct _band
+	{
+		std::size_t rows{0}, cols{0}, width{0};
+		std::vector<std::size_t> start;
+		std::vector<T, fcp::algods::aligned_allocator<T>> values;
+		std::vector<std::pair<std::size_t, std::size_t>> runs;
+	};
+
+	template <typename T>
+	inline void _find_runs(_band<T>& b)
+	{
+		b.runs.clear();
+		for (std::size_t i{0}; i < b.rows;)
+		{
+			std::size_t _j{i + 1};
+			while (_j < b.rows and b.start[_j] == b.start[_j - 1] + 1)
+				_j++;
+			b.runs.emplace_back(i, _j);
+			i = _j;
+		}
+	}
+
+	// Transpose of a band: the band of a column spans all the rows whose bands contain it
+	template <typename T>
+	inline _band<T> _transpose(const _band<T>& b)
+	{
+		_band<T> _res;
+		_res.rows = b.cols;
+		_res.cols = b.rows;
+		std::vector<std::size_t> _lo(b.cols, b.rows), _hi(b.cols, 0);
+		for (std::size_t i{0}; i < b.rows; i++)
+			for (std::size_t k{0}; k < b.width; k++)
+			{
+				const std::size_t _c{ b.start[i] + k };
+				_lo[_c] = std::min(_lo[_c], i);
+				_hi[_c] = std::max(_hi[_c], i + 1);
+			}
+		for (std::size_t j{0}; j < b.cols; j++)
+			_res.width = std::max(_res.width, _lo[j] < _hi[j] ? _hi[j] - _lo[j] : std::size_t{0});
+		_res.start.resize(b.cols);
+		for (std::size_t j{0}; j < b.cols; j++)
+			_res.start[j] = std::min(_lo[j] < _hi[j] ? _lo[j] : std::size_t{0}, b.rows - _res.width);
+		_res.values.assign(_res.width * _res.rows, T{0});
+		for (std::size_t i{0}; i < b.rows; i++)
+			for (std::size_t k{0}; k < b.width; k++)
+			{
+				const std::size_t _c{ b.start[i] + k };
+				_res.values[(i - _res.start[_c]) * _res.rows + _c] = b.values[k * b.rows + i];
+			}
+		_find_runs(_res);
+		return _res;
+	}
+
+	// y = B x
+	template <typename T>
+	inline void _band_multiply(const _band<T>& b, const T* x, T* y)
+	{
+		using _isa = std::conditional_t<std::is_same_v<T, float> or std::is_same_v<T, double>, fcp::algods::simd::native, fcp::algods::simd::scalar>;
+		if (0 == b.width)
+		{
+			std::fill(y, y + b.rows, T{0});
+			return;
+		}
+		for (const auto& [_lo, _hi] : b.runs)
+			fcp::algods::simd::variable_stencil(_isa{}, x + b.start[_lo], b.values.data() + _lo, b.rows, b.width, y + _lo, _hi - _lo);
+	}
+}	// namespace internal
+
+/// @brief Sparse matrix with the nonzeros of each row within a band of `width` consecutive columns
+/// @details The matrix is immutable once assembled; `multiply()` and `transpose_multiply()` allocate nothing, so the same
+/// object may be applied any number of times, concurrently, e.g. inside an iterative solver
+template <typename T>
+class BandedMatrix
+{
+	static_assert(std::is_floating_point_v<T>, "class BandedMatrix: only floating point types are supported.\n");
+
+	public:
+		using value_type = T;
+
+		/// @brief Empty matrix
+		BandedMatrix(void) = default;
+
+		/// @brief Assemble the `rows` x `cols` matrix whose `i`-th row holds `values[k * rows + i]` at the column `start[i] + k`,
+		/// for `k` in [0, width)
+		/// @details Throws `std::invalid_argument` if the sizes of `start` and `values` don't match the dimensions or if a band
+		/// exceeds the columns
+		BandedMatrix(const std::size_t& rows, const std::size_t& cols, const std::size_t& width, std::vector<std::size_t> start,
+								 std::vector<T, fcp::algods::aligned_allocator<T>> values)
+		{
+			if (start.size() != rows or values.size() != rows * width)
+				throw std::invalid_argument("class BandedMatrix: the band arrays don't match the dimensions.\n");
+			for (const auto& _s : start)
+				if (_s + width > cols)
+					throw std::invalid_argument("class BandedMatrix: a band exceeds the columns of the matrix.\n");
+			m_band.rows = rows;
+			m_band.cols = cols;
+			m_band.width = width;
+			m_band.start = std::move(start);
+			m_band.values = std::move(values);
+			internal::_find_runs(m_band);
+			m_transpose = internal::_transpose(m_band);
+		}
+
+		/// @brief Number of rows
+		std::size_t rows(void) const { return m_band.rows; }
+
+		/// @brief Number of columns
+		std::size_t cols(void) const { return m_band.cols; }
+
+		/// @brief Number of columns of the band of each row
+		std::size_t width(void) const { return m_band.width; }
+
+		/// @brief First column of the band of the `i`-th row
+		std::size_t band_start(const std::size_t& i) const { return m_band.start[i]; }
+
+		/// @brief Returns the element of row `i` and column `j` (zero outside the band) performing bounds checking first
+		T at(const std::size_t& i, const std::size_t& j) const
+		{
+			if (i >= this->rows() or j >= this->cols())
+				throw std::out_of_range("method BandedMatrix::at(): index out of range was requested.\n");
+			return this->operator()(i, j);
+		}
+
+		/// @brief Returns the element of row `i` and column `j` (zero outside the band)
+		T operator()(const std::size_t& i, const std::size_t& j) const
+		{
+			const std::size_t _s{ m_band.start[i] };
+			return j >= _s and j < _s + m_band.width ? m_band.values[(j - _s) * m_band.rows + i] : T{0};
+		}
+
+		/// @brief Matrix-vector product: `y = A x`
+		/// @details Throws `std::invalid_argument` if the sizes of `x` and `y` don't match the matrix; `y` must not overlap `x`
+		void multiply(const span<const T>& x, const span<T>& y) const
+		{
+			if (x.size() != this->cols() or y.size() != this->rows())
+				throw std::invalid_argument("method BandedMatrix::multiply(): the sizes of the vectors don't match the matrix.\n");
+			internal::_band_multiply(m_band, x.data(), y.data());
+		}
+
+		/// @brief Product by the transpose: `y = A^T x`
+		/// @details Throws `std::invalid_argument` if the sizes of `x` and `y` don't match the matrix; `y` must not overlap `x`
+		void transpose_multiply(const span<const T>& x, const span<T>& y) const
+		{
+			if (x.size() != this->rows() or y.size() != this->cols())
+				throw std::invalid_argument("method BandedMatrix::transpose_multiply(): the sizes of the vectors don't match the matrix.\n");
+			internal::_band_multiply(m_transpose, x.data(), y.data());
+		}
+
+	private:
+		internal::_band<T> m_band, m_transpose;
+};
+
+END_COMPUTATIONAL_NAMESPACE
+END_FCP_NAMESPACE
+
+#endif	// FCPUT_COMPUTATIONAL_BANDED
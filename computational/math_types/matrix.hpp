@@ -2,9 +2,13 @@
 #define FCPUT_COMPUTATIONAL_MATRIX
 
 #include "computational/common/common.hpp"
+#include "computational/math_types/vec.hpp"
+#include "algo_ds/simd/mat4.hpp"
 
 #include <type_traits>
 #include <array>
+#include <cstddef>
+#include <stdexcept>
 
 START_FCP_NAMESPACE
 START_COMPUTATIONAL_NAMESPACE
@@ -20,12 +24,175 @@ class Matrix
 		using _col_major = std::array<std::array<T, N>, M>;
 		constexpr static bool _col_was_chosen = std::is_same_v<Ordering, column_major>;
 		using _inner_mat = typename std::conditional<_col_was_chosen, _col_major, _row_major>::type;
+
+	public:
+		// Compile-Time Properties
+		using value_type = T;
+		using ordering = Ordering;
+		constexpr static std::size_t rows_v = N;
+		constexpr static std::size_t cols_v = M;
+
+		// Constructors & Destructor
+
+		/// @brief Zero matrix
+		Matrix(void): m_mat{} {}
+
+		/// @brief Identity matrix
+		static Matrix identity(void)
+		{
+			static_assert(N == M, "method Matrix::identity(): the matrix must be square.\n");
+			Matrix _res;
+			for (std::size_t i{0}; i < N; i++)
+				_res(i, i) = T{1};
+			return _res;
+		}
+
+		// Element Access
+
+		/// @brief Returns the element of row `i` and column `j`
+		T& operator()(const std::size_t& i, const std::size_t& j)
+		{
+			if constexpr (_col_was_chosen) return m_mat[j][i]; else return m_mat[i][j];
+		}
+
+		const T& operator()(const std::size_t& i, const std::size_t& j) const
+		{
+			if constexpr (_col_was_chosen) return m_mat[j][i]; else return m_mat[i][j];
+		}
+
+		/// @brief Contiguous storage of the N*M elements, in the order given by `Ordering`
+		T* data(void) { return m_mat[0].data(); }
+		const T* data(void) const { return m_mat[0].data(); }
+
+	private:
 		_inner_mat m_mat;
+
+		static_assert(sizeof(_inner_mat) == N * M * sizeof(T), "class Matrix: the storage is not contiguous.\n");
 };
 
-template <typename T> using mat4x4 = Matrix<T, 4, 4>;
-template <typename T> using mat3x3 = Matrix<T, 3, 3>;
-template <typename T> using mat2x2 = Matrix<T, 2, 2>;
+template <typename T, typename Ordering = column_major> using mat4x4 = Matrix<T, 4, 4, Ordering>;
+template <typename T, typename Ordering = column_major> using mat3x3 = Matrix<T, 3, 3, Ordering>;
+template <typename T, typename Ordering = column_major> using mat2x2 = Matrix<T, 2, 2, Ordering>;
+
+namespace internal
+{
+	// 4x4 `float`/`double` matrices go through the SIMD kernels of algo_ds/simd/mat4.hpp
+	template <typename T, std::size_t N, std::size_t M>
+	constexpr bool _is_simd_mat4 = N == 4 and M == 4 and (std::is_same_v<T, float> or std::is_same_v<T, double>);
+
+	// Copy of `m` in column-major order, as needed by the matrix-vector kernels
+	template <typename T, typename Ordering>
+	inline mat4x4<T, column_major> _to_column_major(const mat4x4<T, Ordering>& m)
+	{
+		mat4x4<T, column_major> _res;
+		if constexpr (std::is_same_v<Ordering, column_major>)
+			_res = m;
+		else
+			fcp::algods::simd::mat4_transpose(m.data(), _res.data());
+		return _res;
+	}
+}	// namespace internal
+
+/// @brief Matrix product
+template <typename T, std::size_t N, std::size_t K, std::size_t M, typename Ordering>
+FCP_COMPUTATIONAL_API Matrix<T, N, M, Ordering> operator*(const Matrix<T, N, K, Ordering>& a, const Matrix<T, K, M, Ordering>& b)
+{
+	Matrix<T, N, M, Ordering> _res;
+	if constexpr (internal::_is_simd_mat4<T, N, M> and K == 4)
+	{
+		// The storage of a row-major matrix is the one of its transpose: (AB)^T = B^T A^T
+		if constexpr (std::is_same_v<Ordering, column_major>)
+			fcp::algods::simd::mat4_mul(a.data(), b.data(), _res.data());
+		else
+			fcp::algods::simd::mat4_mul(b.data(), a.data(), _res.data());
+	}
+	else
+	{
+		for (std::size_t i{0}; i < N; i++)
+			for (std::size_t j{0}; j < M; j++)
+			{
+				T _s{0};
+				for (std::size_t k{0}; k < K; k++)
+					_s += a(i, k) * b(k, j);
+				_res(i, j) = _s;
+			}
+	}
+	return _res;
+}
+
+/// @brief Matrix-vector product
+template <typename T, std::size_t N, std::size_t M, typename Ordering>
+FCP_COMPUTATIONAL_API Vector<T, N> operator*(const Matrix<T, N, M, Ordering>& m, const Vector<T, M>& v)
+{
+	Vector<T, N> _res;
+	if constexpr (internal::_is_simd_mat4<T, N, M>)
+	{
+		if constexpr (std::is_same_v<Ordering, column_major>)
+			fcp::algods::simd::mat4_transform(m.data(), v.data(), _res.data());
+		else
+			fcp::algods::simd::mat4_transform(internal::_to_column_major(m).data(), v.data(), _res.data());
+	}
+	else
+	{
+		for (std::size_t i{0}; i < N; i++)
+		{
+			T _s{0};
+			for (std::size_t j{0}; j < M; j++)
+				_s += m(i, j) * v[j];
+			_res[i] = _s;
+		}
+	}
+	return _res;
+}
+
+/// @brief Transpose of a matrix
+template <typename T, std::size_t N, std::size_t M, typename Ordering>
+FCP_COMPUTATIONAL_API Matrix<T, M, N, Ordering> transpose(const Matrix<T, N, M, Ordering>& m)
+{
+	Matrix<T, M, N, Ordering> _res;
+	if constexpr (internal::_is_simd_mat4<T, N, M>)
+		fcp::algods::simd::mat4_transpose(m.data(), _res.data());
+	else
+		for (std::size_t i{0}; i < N; i++)
+			for (std::size_t j{0}; j < M; j++)
+				_res(j, i) = m(i, j);
+	return _res;
+}
+
+/// @brief Inverse of a 4x4 matrix
+/// @details Throws `std::domain_error` if the matrix is singular
+template <typename T, typename Ordering>
+FCP_COMPUTATIONAL_API mat4x4<T, Ordering> inverse(const mat4x4<T, Ordering>& m)
+{
+	static_assert(std::is_floating_point_v<T>, "function inverse(): the matrix elements must be floating-point numbers.\n");
+	mat4x4<T, Ordering> _res;
+	if (T{0} == fcp::algods::simd::mat4_inverse(m.data(), _res.data()))
+		throw std::domain_error("function inverse(): the matrix is singular.\n");
+	return _res;
+}
+
+/// @brief Transform `n` four-dimensional vectors: `out[i] = m * in[i]`
+/// @details `in` and `out` may coincide, and are not dereferenced if `n` is zero
+template <typename T, typename Ordering>
+FCP_COMPUTATIONAL_API void transform(const mat4x4<T, Ordering>& m, const Vec4<T>* in, Vec4<T>* out, const std::size_t& n)
+{
+	static_assert(sizeof(Vec4<T>) == 4 * sizeof(T), "function transform(): Vec4 arrays are not contiguous.\n");
+	if (0 == n) return;
+	if constexpr (internal::_is_simd_mat4<T, 4, 4>)
+		fcp::algods::simd::mat4_transform(internal::_to_column_major(m).data(), in[0].data(), out[0].data(), n);
+	else
+		for (std::size_t i{0}; i < n; i++)
+			out[i] = m * in[i];
+}
+
+/// @brief Transform `n` points (w = 1) stored as one array per component, without perspective division
+/// @details `in` and `out` may coincide
+template <typename T, typename Ordering>
+FCP_COMPUTATIONAL_API void transform_points(const mat4x4<T, Ordering>& m, const fcp::algods::simd::soa_vec3<const T>& in,
+																						const fcp::algods::simd::soa_vec3<T>& out, const std::size_t& n)
+{
+	fcp::algods::simd::mat4_transform_points(internal::_to_column_major(m).data(), in, out, n);
+}
 
 END_COMPUTATIONAL_NAMESPACE
 END_FCP_NAMESPACE
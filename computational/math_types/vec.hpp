@@ -1,7 +1,7 @@
 #ifndef FCPUT_COMPUTATIONAL_VEC
 #define FCPUT_COMPUTATIONAL_VEC
 
-#include "common/common.hpp"
+#include "computational/common/common.hpp"
 
 #include <type_traits>
 #include <array>
@@ -29,6 +29,14 @@ class Vector
 			this->m_data = o.m_data;
 		}
 
+		// Element Access
+		T& operator[](const std::size_t& i) { return m_data[i]; }
+		const T& operator[](const std::size_t& i) const { return m_data[i]; }
+
+		/// @brief Contiguous storage of the N components
+		T* data(void) { return m_data.data(); }
+		const T* data(void) const { return m_data.data(); }
+
 		// Logic & Arithmetic Operators
 
 	private:
@@ -48,6 +56,7 @@ std::ostream& operator<<(std::ostream& out, const Vector<T, N>& v)
 	for (std::size_t i{0}; i < Vector<T, N>::size_v; i++)
 		out << v[i] << ' ';
 	out << ')' << std::endl;
+	return out;
 }
 
 END_COMPUTATIONAL_NAMESPACE
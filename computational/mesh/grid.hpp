@@ -2,12 +2,17 @@
 #define FCPUT_COMPUTATIONAL_GRID
 
 #include "computational/common/common.hpp"
+#include "computational/common/span.hpp"
+#include "algo_ds/allocators/aligned_allocator.hpp"
 
 #include <cstddef>
 #include <type_traits>
 #include <stdexcept>
 #include <iostream>
 #include <vector>
+#include <array>
+#include <utility>
+#include <iterator>
 
 START_FCP_NAMESPACE
 START_COMPUTATIONAL_NAMESPACE
@@ -27,9 +32,71 @@ namespace internal
 								decltype(&T::data)
 		>
 	> = true;
+
+	// Random-access iterator over the points of a grid, computed by `Grid::operator[]`: the points are values, not references,
+	// so that the grids computing them are iterable like the ones storing them
+	template <class Grid, typename T>
+	class _point_iterator
+	{
+		public:
+			// A proxy iterator: every random-access operation is constant time, but dereferencing returns the point by value
+			// (`reference` is not `T&`), so it does not meet the LegacyForwardIterator requirements on references. The standard
+			// algorithms that only read the points (`std::accumulate`, `std::lower_bound`, `std::transform`, ...) work as usual
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = T;
+
+			_point_iterator(void) = default;
+			_point_iterator(const Grid* grid, const std::size_t& i): m_grid{grid}, m_i{static_cast<difference_type>(i)} {}
+
+			T operator*(void) const { return (*m_grid)[static_cast<std::size_t>(m_i)]; }
+			T operator[](const difference_type& n) const { return (*m_grid)[static_cast<std::size_t>(m_i + n)]; }
+
+			_point_iterator& operator++(void) { ++m_i; return *this; }
+			_point_iterator& operator--(void) { --m_i; return *this; }
+			_point_iterator operator++(int) { _point_iterator _res{*this}; ++m_i; return _res; }
+			_point_iterator operator--(int) { _point_iterator _res{*this}; --m_i; return _res; }
+			_point_iterator& operator+=(const difference_type& n) { m_i += n; return *this; }
+			_point_iterator& operator-=(const difference_type& n) { m_i -= n; return *this; }
+
+			friend _point_iterator operator+(_point_iterator it, const difference_type& n) { return it += n; }
+			friend _point_iterator operator+(const difference_type& n, _point_iterator it) { return it += n; }
+			friend _point_iterator operator-(_point_iterator it, const difference_type& n) { return it -= n; }
+			friend difference_type operator-(const _point_iterator& a, const _point_iterator& b) { return a.m_i - b.m_i; }
+
+			friend bool operator==(const _point_iterator& a, const _point_iterator& b) { return a.m_i == b.m_i; }
+			friend bool operator!=(const _point_iterator& a, const _point_iterator& b) { return a.m_i != b.m_i; }
+			friend bool operator<(const _point_iterator& a, const _point_iterator& b) { return a.m_i < b.m_i; }
+			friend bool operator>(const _point_iterator& a, const _point_iterator& b) { return a.m_i > b.m_i; }
+			friend bool operator<=(const _point_iterator& a, const _point_iterator& b) { return a.m_i <= b.m_i; }
+			friend bool operator>=(const _point_iterator& a, const _point_iterator& b) { return a.m_i >= b.m_i; }
+
+		private:
+			const Grid* m_grid{nullptr};
+			difference_type m_i{0};
+	};
+
+	// Range of the points of a grid, for range-based loops and standard algorithms
+	template <typename Iterator>
+	class _point_range
+	{
+		public:
+			_point_range(const Iterator& first, const Iterator& last): m_first{first}, m_last{last} {}
+
+			Iterator begin(void) const { return m_first; }
+			Iterator end(void) const { return m_last; }
+			std::size_t size(void) const { return static_cast<std::size_t>(m_last - m_first); }
+
+		private:
+			Iterator m_first, m_last;
+	};
 }	// namespace internal
 
 /// @brief Uniform grid
+/// @details The points are computed at each access, from the ends and the number of points: see `StoredUniformGrid` for the
+/// same points stored in an array
 template <typename T>
 class UniformGrid
 {
@@ -52,7 +119,7 @@ class UniformGrid
 		/// @brief Returns `i`-th grid point performing bounds checking first
 		const T at(const std::size_t& i) const
 		{
-			if (i > m_to) throw std::out_of_range("UniformGrid::at(): Index out of range was requested.\n");
+			if (i >= m_n_points) throw std::out_of_range("UniformGrid::at(): Index out of range was requested.\n");
 			return m_from + i*(m_to - m_from)/m_n_points;
 		}
 		
@@ -62,21 +129,22 @@ class UniformGrid
 			return m_from + i*(m_to - m_from)/m_n_points;
 		}
 
-		const std::size_t begin(void) const
+		std::size_t begin(void) const
 		{
 			return static_cast<std::size_t>(0);
 		}
 
-		const std::size_t end(void) const
+		std::size_t end(void) const
 		{
 			return m_n_points;
 		}
 	
-		std::vector<T> at_range(const T& from, const T& to) const
+		std::vector<T> at_range(const std::size_t& from, const std::size_t& to) const
 		{
-			std::vector<T> temp;	
+			if (from > to or to > m_n_points) throw std::out_of_range("UniformGrid::at_range(): Range out of the grid was requested.\n");
+			std::vector<T> temp(to - from);
 			for (std::size_t i{from}; i < to; i++)
-				temp.push_back(this->at(i));
+				temp[i - from] = this->operator[](i);
 			return temp;
 		}
 	
@@ -85,6 +153,12 @@ class UniformGrid
 			return this->at_range(this->begin(), this->end());
 		}
 
+		/// @brief Random-access range of the points, computed on dereference
+		internal::_point_range<internal::_point_iterator<UniformGrid, T>> points(void) const
+		{
+			return { { this, 0 }, { this, m_n_points } };
+		}
+
 		template <typename U>
 		friend std::ostream& operator<<(std::ostream& out, const UniformGrid<U>& grid);
 
@@ -107,15 +181,206 @@ std::ostream& operator<<(std::ostream& out, const UniformGrid<T>& grid)
 	return out;
 }
 
+/// @brief Uniform grid storing its points
+/// @details The points are the ones of `UniformGrid` (bit for bit), computed once into an aligned array, so that an access is
+/// a load and the points can be handed to SIMD kernels and standard algorithms as a contiguous `span`
+template <typename T>
+class StoredUniformGrid
+{
+	public:
+		constexpr static bool is_uniform_v = true;
+
+		/// @brief Generate the points of `UniformGrid(from, to, number_of_points)`
+		StoredUniformGrid(const T& from, const T& to, const std::size_t& number_of_points)
+			: StoredUniformGrid(UniformGrid<T>(from, to, number_of_points)) {}
+
+		/// @brief Store the points of `grid`
+		explicit StoredUniformGrid(const UniformGrid<T>& grid): m_points(grid.end())
+		{
+			for (std::size_t i{0}; i < m_points.size(); i++)
+				m_points[i] = grid[i];
+		}
+
+		/// @brief Returns `i`-th grid point performing bounds checking first
+		const T at(const std::size_t& i) const
+		{
+			if (i >= m_points.size()) throw std::out_of_range("StoredUniformGrid::at(): Index out of range was requested.\n");
+			return m_points[i];
+		}
+
+		/// @brief Returns `i`-th grid point without performing bounds checking first
+		const T operator[](const std::size_t& i) const
+		{
+			return m_points[i];
+		}
+
+		std::size_t begin(void) const
+		{
+			return static_cast<std::size_t>(0);
+		}
+
+		std::size_t end(void) const
+		{
+			return m_points.size();
+		}
+
+		std::vector<T> at_range(const std::size_t& from, const std::size_t& to) const
+		{
+			if (from > to or to > m_points.size()) throw std::out_of_range("StoredUniformGrid::at_range(): Range out of the grid was requested.\n");
+			return std::vector<T>(m_points.begin() + from, m_points.begin() + to);
+		}
+
+		std::vector<T> data(void) const
+		{
+			return std::vector<T>(m_points.begin(), m_points.end());
+		}
+
+		/// @brief Contiguous view over the points, aligned for the SIMD registers
+		fcp::computational::span<const T> span(void) const { return { m_points.data(), m_points.size() }; }
+
+		/// @brief Random-access range of the points (pointers into the storage)
+		fcp::computational::span<const T> points(void) const { return this->span(); }
+
+		template <typename U>
+		friend std::ostream& operator<<(std::ostream& out, const StoredUniformGrid<U>& grid);
+
+	private:
+		std::vector<T, fcp::algods::aligned_allocator<T>> m_points;
+};
+
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const StoredUniformGrid<T>& grid)
+{
+	out << "StoredUniformGrid template object:\n";
+	out << "Number of points: " << grid.m_points.size() << '\n';
+	for (const auto& _x : grid.m_points)
+		out << _x << ' ';
+	out << std::endl;
+
+	return out;
+}
+
+/// @brief Structured grid: tensor product of one uniform grid per axis
+/// @details The points are numbered with the first axis running fastest, so the fields sampled on it are contiguous
+/// along that axis
+template <typename T, std::size_t Dimensions>
+class StructuredGrid
+{
+	static_assert(Dimensions >= 1 and Dimensions <= 3, "class StructuredGrid: only one to three dimensions are supported.\n");
+
+	public:
+		using value_type = T;
+		constexpr static bool is_uniform_v = true;
+		constexpr static std::size_t dimensions_v = Dimensions;
+
+		/// @brief Generate the grid of the points of `axes`
+		StructuredGrid(const std::array<UniformGrid<T>, Dimensions>& axes): m_axes{axes} {}
+
+		/// @brief Grid along the axis `a`
+		const UniformGrid<T>& axis(const std::size_t& a) const { return m_axes[a]; }
+
+		/// @brief Number of points along the axis `a`
+		std::size_t extent(const std::size_t& a) const { return m_axes[a].end(); }
+
+		/// @brief Distance between the indices of consecutive points along the axis `a`
+		std::size_t stride(const std::size_t& a) const
+		{
+			std::size_t _res{1};
+			for (std::size_t b{0}; b < a; b++)
+				_res *= this->extent(b);
+			return _res;
+		}
+
+		/// @brief Distance between consecutive points along the axis `a`
+		T spacing(const std::size_t& a) const { return m_axes[a][1] - m_axes[a][0]; }
+
+		/// @brief Total number of points
+		std::size_t size(void) const { return this->stride(Dimensions); }
+
+	private:
+		std::array<UniformGrid<T>, Dimensions> m_axes;
+};
+
 /// @brief Grid generated from custom array
-template <std::size_t Dimensions = 1>
+/// @details The points may be arbitrarily spaced (for example clustered near a boundary) but must be strictly increasing
+template <typename T, std::size_t Dimensions = 1>
 class FromArrayGrid
 {
+	static_assert(Dimensions == 1, "class FromArrayGrid: only one-dimensional grids are supported.\n");
+
+	public:
+		constexpr static bool is_uniform_v = false;
+
+		/// @brief Generate a grid over `points`
+		/// @details Throws `std::invalid_argument` if there are less than two points or they are not strictly increasing
+		FromArrayGrid(std::vector<T> points): m_points{std::move(points)}
+		{
+			if (m_points.size() < 2)
+				throw std::invalid_argument("class FromArrayGrid: at least two grid points are required.\n");
+			for (std::size_t i{1}; i < m_points.size(); i++)
+				if (not (m_points[i - 1] < m_points[i]))
+					throw std::invalid_argument("class FromArrayGrid: grid points must be strictly increasing.\n");
+		}
+
+		/// @brief Returns `i`-th grid point performing bounds checking first
+		const T at(const std::size_t& i) const
+		{
+			if (i >= m_points.size()) throw std::out_of_range("FromArrayGrid::at(): Index out of range was requested.\n");
+			return m_points[i];
+		}
+
+		/// @brief Returns `i`-th grid point without performing bounds checking first
+		const T operator[](const std::size_t& i) const
+		{
+			return m_points[i];
+		}
+
+		std::size_t begin(void) const
+		{
+			return static_cast<std::size_t>(0);
+		}
+
+		std::size_t end(void) const
+		{
+			return m_points.size();
+		}
+
+		std::vector<T> at_range(const std::size_t& from, const std::size_t& to) const
+		{
+			if (from > to or to > m_points.size()) throw std::out_of_range("FromArrayGrid::at_range(): Range out of the grid was requested.\n");
+			return std::vector<T>(m_points.begin() + from, m_points.begin() + to);
+		}
+
+		std::vector<T> data(void) const
+		{
+			return m_points;
+		}
+
+		/// @brief Contiguous view over the points
+		fcp::computational::span<const T> span(void) const { return { m_points.data(), m_points.size() }; }
 
+		/// @brief Random-access range of the points (pointers into the storage)
+		fcp::computational::span<const T> points(void) const { return this->span(); }
 
+		template <typename U, std::size_t D>
+		friend std::ostream& operator<<(std::ostream& out, const FromArrayGrid<U, D>& grid);
 
+	private:
+		std::vector<T> m_points;
 };
 
+template <typename T, std::size_t Dimensions>
+std::ostream& operator<<(std::ostream& out, const FromArrayGrid<T, Dimensions>& grid)
+{
+	out << "FromArrayGrid template object:\n";
+	out << "Number of points: " << grid.m_points.size() << '\n';
+	for (const auto& _x : grid.m_points)
+		out << _x << ' ';
+	out << std::endl;
+
+	return out;
+}
+
 END_COMPUTATIONAL_NAMESPACE
 END_FCP_NAMESPACE
 
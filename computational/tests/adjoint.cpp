@@ -0,0 +1,204 @@
+/*
+ * adjoint.cpp -- Reverse-mode automatic differentiation against the exact derivatives
+ *
+ * Gradients of a Rosenbrock-like function on a tape, checkpointed gradients of an unrolled explicit
+ * diffusion against its whole recording for several intervals, Jacobians swept packed in the register
+ * lanes and one row at a time, derivatives with respect to constants, rewinding the tape, operands on
+ * different tapes, powers at zero, and the alignments the arena holding the nodes rejects.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/adjoint.hpp"
+
+namespace fcpc = fcp::computational;
+namespace simd = fcp::algods::simd;
+
+// f(x) = sum((1 - x_i)^2 + 10 (x_{i+1} - x_i^2)^2) + sin(x_0 x_{n-1}), for any number type
+struct Function
+{
+	template <typename N>
+	N operator()(const std::vector<N>& x) const
+	{
+		using std::sin;
+		N res{0};
+		for (std::size_t i{0}; i + 1 < x.size(); i++)
+		{
+			const N a{ 1 - x[i] }, b{ x[i + 1] - x[i] * x[i] };
+			res += a * a + 10 * b * b;
+		}
+		return res + sin(x[0] * x[x.size() - 1]);
+	}
+};
+
+std::vector<double> function_gradient(const std::vector<double>& x)
+{
+	const std::size_t n{ x.size() };
+	std::vector<double> g(n, 0.);
+	for (std::size_t i{0}; i + 1 < n; i++)
+	{
+		const double b{ x[i + 1] - x[i] * x[i] };
+		g[i] += -2 * (1 - x[i]) - 40 * x[i] * b;
+		g[i + 1] += 20 * b;
+	}
+	const double c{ std::cos(x[0] * x[n - 1]) };
+	g[0] += c * x[n - 1];
+	g[n - 1] += c * x[0];
+	return g;
+}
+
+// One explicit step of a nonlinear diffusion, preserving the size of the state
+struct Step
+{
+	template <typename N>
+	std::vector<N> operator()(const std::vector<N>& x) const
+	{
+		using std::sin;
+		std::vector<N> res(x);
+		for (std::size_t i{1}; i + 1 < x.size(); i++)
+			res[i] = x[i] + 0.1 * (x[i - 1] - 2 * x[i] + x[i + 1]) + 0.05 * sin(x[i]);
+		return res;
+	}
+};
+
+struct Objective
+{
+	template <typename N>
+	N operator()(const std::vector<N>& x) const
+	{
+		N res{0};
+		for (const auto& xi : x)
+			res += xi * xi;
+		return res;
+	}
+};
+
+// Step^steps then the objective, recorded on a single tape
+struct Unrolled
+{
+	std::size_t steps;
+
+	template <typename N>
+	N operator()(const std::vector<N>& x) const
+	{
+		std::vector<N> s(x);
+		for (std::size_t k{0}; k < steps; k++)
+			s = Step()(s);
+		return Objective()(s);
+	}
+};
+
+void test_gradient(void)
+{
+	std::vector<double> x(37);
+	for (std::size_t i{0}; i < x.size(); i++)
+		x[i] = std::cos(0.3 * i);
+	const std::vector<double> g{ fcpc::adjoint_gradient(Function(), fcpc::span<const double>(x)) }, exact{ function_gradient(x) };
+	testing::check("adjoint: gradient", testing::max_error(g, [&](const std::size_t& i) { return exact[i]; }), 1e-12);
+
+	// Checkpointed sweeps: the same gradient as the whole recording, whatever the interval
+	const std::size_t steps{ 25 };
+	const std::vector<double> whole{ fcpc::adjoint_gradient(Unrolled{ steps }, fcpc::span<const double>(x)) };
+	for (const std::size_t interval : { 1, 4, 25, 100 })
+	{
+		const std::vector<double> cp{ fcpc::checkpointed_gradient(Step(), Objective(), fcpc::span<const double>(x), steps, interval) };
+		testing::check("adjoint: checkpointed, interval " + std::to_string(interval), testing::max_error(cp, [&](const std::size_t& i) { return whole[i]; }), 1e-12);
+	}
+	testing::check_throws<std::invalid_argument>("adjoint: zero checkpoint interval throws", [&]()
+	{
+		fcpc::checkpointed_gradient(Step(), Objective(), fcpc::span<const double>(x), steps, 0);
+	});
+}
+
+// Rows of a Jacobian swept together in the register lanes, with a partial last group
+void test_jacobian(void)
+{
+	const std::size_t m{ 19 }, n{ 5 };
+	fcpc::tape<double> t;
+	std::vector<fcpc::var<double>> x, y;
+	for (std::size_t j{0}; j < n; j++)
+		x.push_back(t.variable(0.5 + 0.1 * j));
+	for (std::size_t r{0}; r < m; r++)
+		y.push_back(sin(x[r % n]) * x[(r + 1) % n] + static_cast<double>(r) * x[(r + 2) % n]);
+
+	std::vector<double> exact(m * n, 0.);
+	for (std::size_t r{0}; r < m; r++)
+	{
+		const double a{ x[r % n].value() }, b{ x[(r + 1) % n].value() };
+		exact[r * n + r % n] += std::cos(a) * b;
+		exact[r * n + (r + 1) % n] += std::sin(a);
+		exact[r * n + (r + 2) % n] += static_cast<double>(r);
+	}
+	const fcpc::span<const fcpc::var<double>> outputs(y), inputs(x);
+	const std::vector<double> jac{ t.jacobian(outputs, inputs) };
+	testing::check("adjoint: jacobian, packed sweeps", testing::max_error(jac, [&](const std::size_t& k) { return exact[k]; }), 1e-14);
+	const std::vector<double> jac_scalar{ t.jacobian<simd::scalar>(outputs, inputs) };
+	testing::check("adjoint: jacobian, scalar sweeps", testing::max_error(jac_scalar, [&](const std::size_t& k) { return exact[k]; }), 1e-14);
+
+	// Recording again after a rewind reuses the nodes
+	const std::size_t mark{ t.size() };
+	const fcpc::var<double> z{ x[0] * x[1] };
+	const std::vector<double> g{ t.gradient(z, inputs) };
+	t.rewind(mark);
+	testing::check("adjoint: gradient after the jacobian", std::abs(g[0] - x[1].value()) + std::abs(g[1] - x[0].value()), 1e-15);
+	testing::check("adjoint: rewind drops the nodes", t.size() == mark);
+	testing::check_throws<std::out_of_range>("adjoint: rewind past the end throws", [&]() { t.rewind(mark + 1); });
+
+	// The constants, which share node 0, have no derivative
+	const fcpc::var<double> c{ 3. };
+	const fcpc::var<double> u{ c * x[0] + x[1] * 2. };
+	const fcpc::var<double> with_constant[]{ x[0], c, x[1] };
+	const std::vector<double> gc{ t.gradient(u, fcpc::span<const fcpc::var<double>>(with_constant, 3)) };
+	testing::check("adjoint: gradient with respect to a constant", std::abs(gc[0] - 3.) + std::abs(gc[1]) + std::abs(gc[2] - 2.), 1e-15);
+	const std::vector<double> jc{ t.jacobian(fcpc::span<const fcpc::var<double>>(&u, 1), fcpc::span<const fcpc::var<double>>(with_constant, 3)) };
+	testing::check("adjoint: jacobian with respect to a constant", std::abs(jc[0] - 3.) + std::abs(jc[1]) + std::abs(jc[2] - 2.), 1e-15);
+	t.rewind(mark);
+
+	fcpc::tape<double> other;
+	const fcpc::var<double> w{ other.variable(1.) };
+	testing::check_throws<std::invalid_argument>("adjoint: operands on different tapes throw", [&]() { return x[0] + w; });
+}
+
+// Powers, including at zero where x^p computed as x^(p-1) * x would be NaN
+void test_pow(void)
+{
+	for (const double p : { 0., 0.5, 1., 1.5, 2., 3. })
+		for (const double x0 : { 0.7, 0. })
+		{
+			fcpc::tape<double> t;
+			const fcpc::var<double> x{ t.variable(x0) };
+			const fcpc::var<double> y{ pow(x, p) };
+			const double v{ std::pow(x0, p) }, d{ 0 == p ? 0. : p * std::pow(x0, p - 1) };
+			const double g{ t.gradient(y, fcpc::span<const fcpc::var<double>>(&x, 1))[0] };
+			// Infinite derivative of x^0.5 at zero
+			const double err{ std::abs(y.value() - v) + (std::isinf(d) ? (g == d ? 0. : 1.) : std::abs(g - d)) };
+			testing::check("adjoint: pow(x, " + std::to_string(p).substr(0, 4) + ") at " + std::to_string(x0).substr(0, 3), err, 1e-15);
+		}
+}
+
+// Alignments of the arena the nodes live in
+void test_arena(void)
+{
+	fcp::algods::arena a(1024);
+	const auto aligned = [&](const std::size_t& alignment) { return 0 == reinterpret_cast<std::uintptr_t>(a.allocate(3, alignment)) % alignment; };
+	testing::check("adjoint: arena alignments up to 64", aligned(1) and aligned(8) and aligned(64) and aligned(16));
+	testing::check_throws<std::invalid_argument>("adjoint: arena alignment over 64 throws", [&]() { a.allocate(8, 128); });
+	testing::check_throws<std::invalid_argument>("adjoint: arena alignment not a power of two throws", [&]() { a.allocate(8, 24); });
+}
+
+int main(void)
+{
+	test_gradient();
+	test_jacobian();
+	test_pow();
+	test_arena();
+
+	return testing::report();
+}
@@ -0,0 +1,103 @@
+/*
+ * autodiff.cpp -- Forward-mode automatic differentiation against the exact derivatives
+ *
+ * First and second derivatives by hyper-dual numbers at the points of a grid, packed in the register
+ * lanes and lane by lane, in single precision and out of the grid, and powers of several exponents at
+ * zero, where computing them through lower powers would give NaN.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/autodiff.hpp"
+
+namespace fcpc = fcp::computational;
+namespace simd = fcp::algods::simd;
+
+// f(x) = x sin(x) + exp(x) / sqrt(1 + x^2), written once for any number type
+struct Function
+{
+	template <typename N>
+	N operator()(const N& x) const
+	{
+		using std::sin;
+		using std::exp;
+		using std::sqrt;
+		return x * sin(x) + exp(x) / sqrt(1 + x * x);
+	}
+};
+
+double function_d1(const double& x)
+{
+	const double g{ std::exp(x) / std::sqrt(1 + x * x) };
+	return std::sin(x) + x * std::cos(x) + g * (1 - x / (1 + x * x));
+}
+
+double function_d2(const double& x)
+{
+	const double g{ std::exp(x) / std::sqrt(1 + x * x) }, a{ 1 - x / (1 + x * x) };
+	return 2 * std::cos(x) - x * std::sin(x) + g * (a * a - (1 - x * x) / ((1 + x * x) * (1 + x * x)));
+}
+
+// Derivatives at the grid points, vectorized and lane by lane
+void test_grid(void)
+{
+	using Grid = fcpc::UniformGrid<double>;
+	const std::size_t n{ 103 };
+	const Grid grid(-2., 2., n);
+
+	const fcpc::AutoDifferentiate<double, Function, Grid> diff(grid);
+	const std::vector<double> d1{ diff.data() }, d2{ diff.data<2>() };
+	testing::check("autodiff: first derivative", testing::max_error(d1, [&](const std::size_t& i) { return function_d1(grid[i]); }), 1e-13);
+	testing::check("autodiff: second derivative", testing::max_error(d2, [&](const std::size_t& i) { return function_d2(grid[i]); }), 1e-12);
+	testing::check("autodiff: at() equal to the packed data()", testing::max_error(d1, [&](const std::size_t& i) { return diff.at(i); }), 1e-15);
+	testing::check("autodiff: second derivative at()", testing::max_error(d2, [&](const std::size_t& i) { return diff.at<2>(i); }), 1e-14);
+
+	const std::vector<double> part{ diff.at_range(5, 14) };
+	testing::check("autodiff: at_range() equal to data()", testing::max_error(part, [&](const std::size_t& i) { return d1[5 + i]; }), 0.);
+
+	const fcpc::AutoDifferentiate<double, Function, Grid, 1, simd::scalar> lanes(grid);
+	testing::check("autodiff: scalar ISA equal to native", testing::max_error(lanes.data(), [&](const std::size_t& i) { return d1[i]; }), 1e-15);
+
+	const fcpc::UniformGrid<float> grid_f(-2.f, 2.f, n);
+	const std::vector<float> d1_f{ fcpc::AutoDifferentiate<float, Function, fcpc::UniformGrid<float>>(grid_f).data() };
+	testing::check("autodiff: single precision", testing::max_error(d1_f, [&](const std::size_t& i) { return function_d1(grid_f[i]); }), 1e-5);
+
+	testing::check_throws<std::out_of_range>("autodiff: at() out of the grid throws", [&]() { diff.at(n); });
+	testing::check_throws<std::out_of_range>("autodiff: range out of the grid throws", [&]() { diff.at_range(0, n + 1); });
+}
+
+// Powers, including at zero where the derivatives of x^p computed through x^(p-2) would be NaN
+void test_pow(void)
+{
+	for (const double p : { 0., 1., 1.5, 2., 3., -0.5 })
+	{
+		const std::string name{ "autodiff: pow(x, " + std::to_string(p).substr(0, 4) + ")" };
+		for (const double x : { 0.7, 0. })
+		{
+			if (p < 0 and 0 == x) continue;
+			const fcpc::hyper_dual<double> y{ pow(fcpc::hyper_dual<double>(x, 1., 1., 0.), p) };
+			const fcpc::dual<double> z{ pow(fcpc::dual<double>(x, 1.), p) };
+			const double v{ std::pow(x, p) };
+			const double d1{ 0 == p ? 0. : p * std::pow(x, p - 1) };
+			const double d2{ 0 == p or 1 == p ? 0. : p * (p - 1) * std::pow(x, p - 2) };
+			double err{ std::max({ std::abs(y.v - v), std::abs(y.d1 - d1), std::abs(z.v - v), std::abs(z.d - d1) }) };
+			// Infinite second derivative of x^1.5 at zero
+			err = std::max(err, std::isinf(d2) ? (y.d12 == d2 ? 0. : 1.) : std::abs(y.d12 - d2));
+			testing::check(name + " at " + std::to_string(x).substr(0, 3), err, 1e-14);
+		}
+	}
+}
+
+int main(void)
+{
+	test_grid();
+	test_pow();
+
+	return testing::report();
+}
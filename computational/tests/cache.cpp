@@ -0,0 +1,125 @@
+/*
+ * cache.cpp -- Sample caches of the differentiation at single grid points against the uncached evaluations
+ *
+ * The cached evaluations at single grid points return the values of the uncached ones, over sweeps and
+ * clustered random points, for fewer calls of the function; the LRU cache hits and evicts as a model
+ * list, and the direct-mapped one samples each point of a sliding window once.
+ */
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <random>
+#include <cmath>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/diff.hpp"
+
+namespace fcpc = fcp::computational;
+
+using Grid = fcpc::UniformGrid<double>;
+
+// Number of evaluations of the function, by all the objects
+std::size_t calls{0};
+
+struct Function
+{
+	double operator()(const double& x) const
+	{
+		calls++;
+		return std::sin(x) * std::exp(x);
+	}
+};
+
+// The cached differentiation returns the same values as the uncached one, over a sweep or random points, for fewer evaluations
+template <class Cache>
+void check_cache(const std::string& name, const bool& random, const bool& fewer)
+{
+	const std::size_t n{ 2000 };
+	const Grid grid(0., 1., n);
+	const fcpc::Differentiate<double, Function, Grid, fcpc::central_difference, 4, 1, 1, Cache> cached(grid);
+	const fcpc::Differentiate<double, Function, Grid, fcpc::central_difference, 4> reference(grid);
+	std::mt19937 rng(5);
+	std::size_t cached_calls{0}, reference_calls{0};
+	bool equal{ true };
+	for (std::size_t t{0}; t < n; t++)
+	{
+		// Clusters of nearby points for the random accesses, as the stencils of a few regions of interest
+		const std::size_t i{ random ? (rng() % 200) * 10 + rng() % 3 : t };
+		std::size_t start{ calls };
+		const double r1{ reference.at(i) }, r2{ reference.at<2, 4>(i) };
+		equal = equal and reference[i] == r1;
+		reference_calls += calls - start;
+		start = calls;
+		equal = equal and cached.at(i) == r1 and cached[i] == r1 and cached.template at<2, 4>(i) == r2;
+		cached_calls += calls - start;
+	}
+	const std::string access{ random ? ", random points" : ", sweep" };
+	testing::check("cache: " + name + access + ", equal to no cache", equal);
+	testing::check("cache: " + name + access + (fewer ? ", fewer evaluations" : ", as many evaluations"),
+								 fewer ? 2 * cached_calls < reference_calls : cached_calls == reference_calls);
+}
+
+// Hits and misses of the LRU cache against a model list, for `keys` distinct keys accessed at random
+template <std::size_t Capacity>
+void check_lru(const std::size_t& keys, const std::size_t& accesses)
+{
+	typename fcpc::lru_sample_cache<Capacity>::template storage<double> cache;
+	std::list<std::size_t> model;
+	std::unordered_map<std::size_t, std::list<std::size_t>::iterator> position;
+	std::mt19937 rng(Capacity);
+	bool equal{ true };
+	std::size_t misses{0};
+	for (std::size_t a{0}; a < accesses; a++)
+	{
+		const std::size_t k{ (rng() % keys) * 977 };
+		bool miss{ false };
+		const double v{ cache.get(k, [&](const std::size_t& j) { miss = true; return 2. * j; }) };
+
+		const auto it{ position.find(k) };
+		const bool model_miss{ position.end() == it };
+		if (not model_miss)
+			model.erase(it->second);
+		else if (model.size() == Capacity)
+		{
+			position.erase(model.back());
+			model.pop_back();
+		}
+		model.push_front(k);
+		position[k] = model.begin();
+
+		equal = equal and v == 2. * k and miss == model_miss;
+		misses += miss;
+	}
+	testing::check("cache: LRU of " + std::to_string(Capacity) + " samples, " + std::to_string(keys) + " keys, evictions", equal and misses > keys);
+}
+
+int main(void)
+{
+	check_cache<fcpc::no_sample_cache>("none", false, false);
+	check_cache<fcpc::direct_mapped_sample_cache<>>("direct-mapped", false, true);
+	check_cache<fcpc::lru_sample_cache<>>("LRU", false, true);
+	check_cache<fcpc::direct_mapped_sample_cache<>>("direct-mapped", true, true);
+	check_cache<fcpc::lru_sample_cache<>>("LRU", true, true);
+
+	check_lru<1>(3, 10000);
+	check_lru<7>(12, 100000);
+	check_lru<64>(100, 200000);
+	check_lru<1000>(1500, 500000);
+
+	// Sliding window over the grid: each point is sampled once
+	fcpc::direct_mapped_sample_cache<16>::storage<double> window;
+	std::size_t misses{0};
+	for (std::size_t i{0}; i < 100; i++)
+		for (std::size_t k{0}; k < 5; k++)
+			window.get(i + k, [&](const std::size_t& j) { misses++; return static_cast<double>(j); });
+	testing::check("cache: direct-mapped sliding window", misses == 104);
+	window.clear();
+	window.get(0, [&](const std::size_t&) { misses++; return 0.; });
+	testing::check("cache: direct-mapped clear", misses == 105);
+
+	return testing::report();
+}
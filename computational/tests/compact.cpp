@@ -0,0 +1,138 @@
+/*
+ * compact.cpp -- Compact (Pade) finite differences against the exact derivatives and the explicit stencils
+ *
+ * Exactness on cubics, the convergence order of the interior from the error ratio of two spacings,
+ * an interior error below the explicit stencil of the same order, the size checks, and the partial
+ * derivatives along each axis of a three-dimensional field against its lines one by one.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/compact.hpp"
+
+namespace fcpc = fcp::computational;
+
+using Grid = fcpc::UniformGrid<double>;
+
+// The error of the boundary closures reaches the interior through the system, decaying by about a factor 4 per point:
+// the middle third of the points is out of its reach
+std::size_t margin(const std::size_t& n) { return n / 3; }
+
+// Largest error at the interior points of a derivative of sin(3x) over `n` points of [0, 1)
+template <std::size_t TOrder, std::size_t DOrder>
+double compact_interior_error(const std::size_t& n)
+{
+	const Grid grid(0., 1., n);
+	std::vector<double> samples(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = std::sin(3 * grid[i]);
+	const std::vector<double> out{ fcpc::CompactDifferentiation<double, Grid, TOrder, DOrder>(fcpc::span<const double>(samples), grid).data() };
+	double err{0};
+	for (std::size_t i{margin(n)}; i + margin(n) < n; i++)
+		err = std::max(err, std::abs(out[i] - (1 == DOrder ? 3 * std::cos(3 * grid[i]) : -9 * std::sin(3 * grid[i]))));
+	return err;
+}
+
+// Halving the spacing divides the interior error by 2^TOrder, from `n` points: enough for the closures to be out of reach,
+// few enough for the truncation error to stay above the rounding one
+template <std::size_t TOrder, std::size_t DOrder>
+void check_convergence(const std::string& name, const std::size_t& n)
+{
+	const double order{ std::log2(compact_interior_error<TOrder, DOrder>(n) / compact_interior_error<TOrder, DOrder>(2 * n)) };
+	testing::check("compact: convergence, " + name, std::abs(order - TOrder), 0.5);
+}
+
+void test_line(void)
+{
+	const std::size_t n{ 64 };
+	const Grid grid(-1., 1., n);
+
+	// Third-order closures: exact on cubics everywhere
+	std::vector<double> cubic(n);
+	for (std::size_t i{0}; i < n; i++)
+		cubic[i] = grid[i] * grid[i] * grid[i] - 2 * grid[i];
+	const std::vector<double> d1{ fcpc::CompactDifferentiation<double, Grid>(fcpc::span<const double>(cubic), grid).data() };
+	testing::check("compact: first derivative of a cubic", testing::max_error(d1, [&](const std::size_t& i) { return 3 * grid[i] * grid[i] - 2; }), 1e-11);
+	const std::vector<double> d1_4{ fcpc::CompactDifferentiation<double, Grid, 4>(fcpc::span<const double>(cubic), grid).data() };
+	testing::check("compact: fourth order, first derivative of a cubic", testing::max_error(d1_4, [&](const std::size_t& i) { return 3 * grid[i] * grid[i] - 2; }), 1e-11);
+
+	check_convergence<6, 1>("sixth order, first derivative", 48);
+	check_convergence<4, 1>("fourth order, first derivative", 32);
+	check_convergence<6, 2>("sixth order, second derivative", 32);
+	check_convergence<4, 2>("fourth order, second derivative", 32);
+
+	// More accurate than the explicit stencil of the same order
+	std::vector<double> samples(n), explicit_d(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = std::sin(3 * grid[i]);
+	const std::vector<double> compact_d{ fcpc::CompactDifferentiation<double, Grid>(fcpc::span<const double>(samples), grid).data() };
+	fcpc::StorageDifferentiation<double, Grid, fcpc::central_difference, 6>(fcpc::span<const double>(samples), grid).data(fcpc::span<double>(explicit_d));
+	double err_compact{0}, err_explicit{0};
+	for (std::size_t i{margin(n)}; i + margin(n) < n; i++)
+	{
+		err_compact = std::max(err_compact, std::abs(compact_d[i] - 3 * std::cos(3 * grid[i])));
+		err_explicit = std::max(err_explicit, std::abs(explicit_d[i] - 3 * std::cos(3 * grid[i])));
+	}
+	testing::check("compact: interior error below the explicit sixth order", err_compact < err_explicit);
+
+	testing::check_throws<std::invalid_argument>("compact: samples not matching the grid throw", [&]()
+	{
+		fcpc::CompactDifferentiation<double, Grid>(fcpc::span<const double>(samples.data(), n - 1), grid);
+	});
+	testing::check_throws<std::out_of_range>("compact: output of a wrong size throws", [&]()
+	{
+		fcpc::CompactDifferentiation<double, Grid>(fcpc::span<const double>(samples), grid).data(fcpc::span<double>(explicit_d.data(), n - 1));
+	});
+	testing::check_throws<std::domain_error>("compact: too few points throw", [&]()
+	{
+		fcpc::CompactDifferentiation<double, Grid>(fcpc::span<const double>(samples.data(), 4), Grid(0., 1., 4));
+	});
+}
+
+// Every line of a field along each axis, solved in batches: the same values as the lines one by one
+template <std::size_t Axis>
+double partial_error(const fcpc::StructuredGrid<double, 3>& grid, const std::vector<double>& f)
+{
+	std::vector<double> out(grid.size());
+	fcpc::compact_partial<Axis>(grid, f, out);
+	const std::size_t n{ grid.extent(Axis) }, stride{ grid.stride(Axis) };
+	std::vector<double> line(n), d_line(n);
+	double err{0};
+	for (std::size_t p{0}; p < grid.size(); p++)
+	{
+		// First point of each line
+		if ((p / stride) % n != 0) continue;
+		for (std::size_t k{0}; k < n; k++)
+			line[k] = f[p + k * stride];
+		fcpc::CompactDifferentiation<double, Grid>(fcpc::span<const double>(line), grid.axis(Axis)).data(fcpc::span<double>(d_line));
+		for (std::size_t k{0}; k < n; k++)
+			err = std::max(err, std::abs(out[p + k * stride] - d_line[k]));
+	}
+	return err;
+}
+
+void test_partial(void)
+{
+	// Partial batches of lines along every axis
+	const fcpc::StructuredGrid<double, 3> grid({ Grid(0., 1., 45), Grid(-1., 1., fcpc::compact_batch_lines + 9), Grid(0., 2., 7) });
+	std::vector<double> f(grid.size());
+	for (std::size_t p{0}; p < f.size(); p++)
+		f[p] = std::sin(0.001 * p) + std::cos(0.37 * p);
+	testing::check("compact: partial along the first axis, batches", partial_error<0>(grid, f), 1e-11);
+	testing::check("compact: partial along the second axis, interleaved", partial_error<1>(grid, f), 1e-11);
+	testing::check("compact: partial along the third axis, interleaved", partial_error<2>(grid, f), 1e-11);
+}
+
+int main(void)
+{
+	test_line();
+	test_partial();
+
+	return testing::report();
+}
@@ -0,0 +1,318 @@
+/*
+ * diff.cpp -- Finite differences of diff.hpp against the exact derivatives and against each other
+ *
+ *   - storage: StorageDifferentiation over stored samples against the exact derivatives and Differentiate
+ *   - parallel: multithreaded evaluations, bit for bit equal to the serial ones for any number of threads, and the pool
+ *     running them
+ *   - fornberg: compile-time weights against tabulated ones, and the convergence order of each truncation order
+ *   - non-uniform: cached and uncached weights of FromArrayGrid, and uniform arrays against UniformGrid
+ *   - batch: BatchDifferentiation of many fields against the fields one at a time
+ */
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/diff.hpp"
+
+namespace fcpc = fcp::computational;
+
+// f(x) = sin(3x), with its derivatives
+struct Sine
+{
+	double operator()(const double& x) const { return std::sin(3 * x); }
+};
+
+double sine_d1(const double& x) { return 3 * std::cos(3 * x); }
+double sine_d2(const double& x) { return -9 * std::sin(3 * x); }
+
+// Fails past the middle of the unit interval
+struct Failing
+{
+	double operator()(const double& x) const
+	{
+		if (x > 0.5) throw std::runtime_error("Failing: out of the domain.\n");
+		return x;
+	}
+};
+
+// Differentiation of pre-sampled data, with the same stencils as `Differentiate`
+void test_storage(void)
+{
+	using Grid = fcpc::UniformGrid<double>;
+	const std::size_t n{ 201 };
+	const Grid grid(0., 1., n);
+	std::vector<double> samples(n), out(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = Sine()(grid[i]);
+
+	const fcpc::StorageDifferentiation<double, Grid> storage(fcpc::span<const double>(samples), grid);
+	storage.data(fcpc::span<double>(out));
+	testing::check("storage: first derivative, second order", testing::max_error(out, [&](const std::size_t& i) { return sine_d1(grid[i]); }), 1e-3);
+
+	// Same samples, same stencils: the same values as the functor-based evaluation
+	const fcpc::Differentiate<double, Sine, Grid> diff(grid);
+	const std::vector<double> from_functor{ diff.data() };
+	testing::check("storage: equal to Differentiate::data()", testing::max_error(out, [&](const std::size_t& i) { return from_functor[i]; }), 1e-14);
+	testing::check("storage: at() equal to data()", testing::max_error(out, [&](const std::size_t& i) { return storage.at(i); }), 1e-14);
+
+	std::vector<double> part(10);
+	storage.at_range(95, 105, fcpc::span<double>(part));
+	testing::check("storage: at_range() equal to data()", testing::max_error(part, [&](const std::size_t& i) { return out[95 + i]; }), 1e-14);
+
+	storage.data<1, 4>(fcpc::span<double>(out));
+	testing::check("storage: first derivative, fourth order", testing::max_error(out, [&](const std::size_t& i) { return sine_d1(grid[i]); }), 1e-6);
+	storage.data<2, 2>(fcpc::span<double>(out));
+	testing::check("storage: second derivative, second order", testing::max_error(out, [&](const std::size_t& i) { return sine_d2(grid[i]); }), 1e-2);
+
+	// Single precision
+	std::vector<float> samples_f(n), out_f(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples_f[i] = static_cast<float>(samples[i]);
+	const fcpc::UniformGrid<float> grid_f(0.f, 1.f, n);
+	fcpc::StorageDifferentiation<float, fcpc::UniformGrid<float>>(fcpc::span<const float>(samples_f), grid_f).data(fcpc::span<float>(out_f));
+	testing::check("storage: single precision", testing::max_error(out_f, [&](const std::size_t& i) { return sine_d1(grid[i]); }), 1e-2);
+
+	testing::check_throws<std::invalid_argument>("storage: samples not matching the grid throw", [&]()
+	{
+		fcpc::StorageDifferentiation<double, Grid>(fcpc::span<const double>(samples.data(), n - 1), grid);
+	});
+	testing::check_throws<std::out_of_range>("storage: at() out of the grid throws", [&]() { storage.at(n); });
+	testing::check_throws<std::out_of_range>("storage: at_range() with a wrong output size throws", [&]()
+	{
+		storage.at_range(0, 11, fcpc::span<double>(part));
+	});
+}
+
+// Multithreaded evaluations, over several chunks and a partial last one
+void test_parallel(void)
+{
+	using Grid = fcpc::UniformGrid<double>;
+	const std::size_t n{ 3 * fcpc::parallel_diff_chunk + 123 };
+	const Grid grid(0., 1., n);
+	const fcpc::Differentiate<double, Sine, Grid> diff(grid);
+	const std::vector<double> serial{ diff.data() };
+	for (const std::size_t threads : { 1, 3, 0 })
+	{
+		const std::vector<double> parallel{ diff.parallel_data(threads) };
+		testing::check("parallel: Differentiate, " + std::to_string(threads) + " thread(s), equal to serial",
+									 parallel.size() == n ? testing::max_error(parallel, [&](const std::size_t& i) { return serial[i]; }) : 1., 0.);
+	}
+	const std::size_t from{ fcpc::parallel_diff_chunk - 7 }, to{ 2 * fcpc::parallel_diff_chunk + 9 };
+	const std::vector<double> range{ diff.parallel_at_range(from, to, 2) };
+	testing::check("parallel: Differentiate range across chunks", testing::max_error(range, [&](const std::size_t& i) { return serial[from + i]; }), 0.);
+
+	std::vector<double> samples(n), out(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = Sine()(grid[i]);
+	const fcpc::StorageDifferentiation<double, Grid> storage(fcpc::span<const double>(samples), grid);
+	storage.parallel_data(fcpc::span<double>(out), 4);
+	testing::check("parallel: StorageDifferentiation equal to serial", testing::max_error(out, [&](const std::size_t& i) { return serial[i]; }), 0.);
+
+	testing::check_throws<std::out_of_range>("parallel: range out of the grid throws", [&]() { diff.parallel_at_range(0, n + 1); });
+	const fcpc::Differentiate<double, Failing, Grid> failing(grid);
+	testing::check_throws<std::runtime_error>("parallel: exception of a worker rethrown", [&]() { failing.parallel_data(4); });
+
+	// The threads are started once and reused, also after an exception
+	const std::size_t workers{ fcpc::thread_pool::shared().size() };
+	const std::vector<double> again{ diff.parallel_data(4) };
+	testing::check("parallel: pool reused by the next calls", workers >= 3 and workers == fcpc::thread_pool::shared().size()
+								 and 0. == testing::max_error(again, [&](const std::size_t& i) { return serial[i]; }));
+
+	// Non-uniform grid, orders without cached weights: computed once for the whole range
+	std::vector<double> points(n);
+	for (std::size_t i{0}; i < n; i++)
+		points[i] = std::pow(static_cast<double>(i) / (n - 1), 1.25);
+	const fcpc::FromArrayGrid<double> non_uniform(points);
+	const fcpc::Differentiate<double, Sine, fcpc::FromArrayGrid<double>> diff_nu(non_uniform);
+	const std::vector<double> serial_nu{ diff_nu.data<2, 4>() };
+	for (const std::size_t threads : { 1, 3 })
+	{
+		const std::vector<double> parallel{ diff_nu.parallel_data<2, 4>(threads) };
+		testing::check("parallel: non-uniform, uncached weights, " + std::to_string(threads) + " thread(s)",
+									 testing::max_error(parallel, [&](const std::size_t& i) { return serial_nu[i]; }), 0.);
+	}
+	const std::vector<double> range_nu{ diff_nu.parallel_at_range<2, 4>(from, to, 2) };
+	testing::check("parallel: non-uniform, uncached weights, range", testing::max_error(range_nu, [&](const std::size_t& i) { return serial_nu[from + i]; }), 0.);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = Sine()(points[i]);
+	fcpc::StorageDifferentiation<double, fcpc::FromArrayGrid<double>>(fcpc::span<const double>(samples), non_uniform).parallel_data<2, 4>(fcpc::span<double>(out), 3);
+	testing::check("parallel: non-uniform storage, uncached weights", testing::max_error(out, [&](const std::size_t& i) { return serial_nu[i]; }), 0.);
+
+	// Every task of the pool runs exactly once, on as many threads as requested
+	fcpc::thread_pool pool;
+	std::vector<int> runs(1000);
+	pool.run(runs.size(), [&](const std::size_t& t) { runs[t]++; });
+	testing::check("parallel: thread_pool runs every task once", pool.size() == runs.size() - 1
+								 and std::all_of(runs.begin(), runs.end(), [](const int& r) { return 1 == r; }));
+	testing::check_throws<std::runtime_error>("parallel: thread_pool rethrows the exception of a task", [&]()
+	{
+		pool.run(8, [](const std::size_t& t) { if (5 == t) throw std::runtime_error("task 5.\n"); });
+	});
+}
+
+// Largest error of the first derivative of sin(3x) on `n` points with the stencils of truncation order `TOrder`
+template <std::size_t TOrder>
+double storage_error(const std::size_t& n)
+{
+	using Grid = fcpc::UniformGrid<double>;
+	const Grid grid(0., 1., n);
+	std::vector<double> samples(n), out(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = Sine()(grid[i]);
+	fcpc::StorageDifferentiation<double, Grid, fcpc::central_difference, TOrder>(fcpc::span<const double>(samples), grid).data(fcpc::span<double>(out));
+	return testing::max_error(out, [&](const std::size_t& i) { return sine_d1(grid[i]); });
+}
+
+template <std::size_t TOrder>
+void check_convergence(void)
+{
+	// Halving the spacing divides the error by 2^TOrder
+	const double order{ std::log2(storage_error<TOrder>(50) / storage_error<TOrder>(100)) };
+	testing::check("fornberg: convergence order of the truncation order " + std::to_string(TOrder), std::abs(order - TOrder), 0.5);
+}
+
+// Weights generated at compile time
+void test_fornberg(void)
+{
+	constexpr auto d1{ fcpc::finite_difference_weights<double, 1>(std::array<int, 3>{ -1, 0, 1 }) };
+	static_assert(d1[0] == -0.5 and d1[1] == 0. and d1[2] == 0.5, "central first derivative weights");
+	constexpr auto d2{ fcpc::finite_difference_weights<double, 2>(std::array<int, 5>{ -2, -1, 0, 1, 2 }) };
+	const std::array<double, 5> d2_exact{ -1. / 12, 4. / 3, -5. / 2, 4. / 3, -1. / 12 };
+	testing::check("fornberg: central second derivative, fourth order", testing::max_error(d2, [&](const std::size_t& k) { return d2_exact[k]; }), 1e-16);
+	constexpr auto f1{ fcpc::finite_difference_weights<double, 1>(std::array<int, 3>{ 0, 1, 2 }) };
+	const std::array<double, 3> f1_exact{ -1.5, 2., -0.5 };
+	testing::check("fornberg: forward first derivative, second order", testing::max_error(f1, [&](const std::size_t& k) { return f1_exact[k]; }), 1e-16);
+
+	// Arbitrary points: exact on the polynomials of degree below the number of points
+	const std::array<double, 4> x{ -0.3, 0.1, 0.25, 0.7 };
+	const double x0{ 0.05 };
+	const auto w{ fcpc::finite_difference_weights<1>(x, x0) };
+	double err{0};
+	for (int m{0}; m < 4; m++)
+	{
+		double d{0};
+		for (std::size_t k{0}; k < 4; k++)
+			d += w[k] * std::pow(x[k], m);
+		err = std::max(err, std::abs(d - (m > 0 ? m * std::pow(x0, m - 1) : 0.)));
+	}
+	testing::check("fornberg: arbitrary points, exact on cubics", err, 1e-13);
+
+	check_convergence<2>();
+	check_convergence<4>();
+	check_convergence<6>();
+}
+
+// Arbitrarily spaced grids, with the weights of each point cached at construction
+void test_non_uniform(void)
+{
+	using Grid = fcpc::FromArrayGrid<double>;
+	const std::size_t n{ 401 };
+	const double pi{ std::acos(-1.) };
+	// Points clustered near both ends
+	std::vector<double> points(n);
+	for (std::size_t i{0}; i < n; i++)
+		points[i] = (1 - std::cos(pi * i / (n - 1))) / 2;
+	const Grid grid(points);
+
+	const fcpc::Differentiate<double, Sine, Grid> diff(grid);
+	const std::vector<double> from_functor{ diff.data() };
+	testing::check("non-uniform: first derivative, second order", testing::max_error(from_functor, [&](const std::size_t& i) { return sine_d1(points[i]); }), 1e-3);
+	testing::check("non-uniform: at() equal to data()", testing::max_error(from_functor, [&](const std::size_t& i) { return diff.at(i); }), 1e-13);
+	// Orders other than the default ones: weights computed at each call
+	const std::vector<double> second{ diff.data<2, 2>() };
+	testing::check("non-uniform: second derivative, uncached weights", testing::max_error(second, [&](const std::size_t& i) { return sine_d2(points[i]); }), 1e-2);
+	testing::check("non-uniform: uncached at() equal to data()", testing::max_error(second, [&](const std::size_t& i) { return diff.at<2, 2>(i); }), 1e-9);
+
+	std::vector<double> samples(n), out(n);
+	for (std::size_t i{0}; i < n; i++)
+		samples[i] = Sine()(points[i]);
+	fcpc::StorageDifferentiation<double, Grid>(fcpc::span<const double>(samples), grid).data(fcpc::span<double>(out));
+	testing::check("non-uniform: storage equal to Differentiate", testing::max_error(out, [&](const std::size_t& i) { return from_functor[i]; }), 1e-13);
+
+	// Uniformly spaced points: the same derivatives as the uniform grid
+	const fcpc::UniformGrid<double> uniform(0., 1., n);
+	std::vector<double> uniform_points(n);
+	for (std::size_t i{0}; i < n; i++)
+		uniform_points[i] = uniform[i];
+	const std::vector<double> on_array{ fcpc::Differentiate<double, Sine, Grid>(Grid(uniform_points)).data() };
+	const std::vector<double> on_uniform{ fcpc::Differentiate<double, Sine, fcpc::UniformGrid<double>>(uniform).data() };
+	testing::check("non-uniform: uniform spacing equal to UniformGrid", testing::max_error(on_array, [&](const std::size_t& i) { return on_uniform[i]; }), 1e-9);
+
+	testing::check_throws<std::invalid_argument>("non-uniform: points not increasing throw", []() { Grid(std::vector<double>{ 0., 0.5, 0.5, 1. }); });
+	testing::check_throws<std::invalid_argument>("non-uniform: single point throws", []() { Grid(std::vector<double>{ 0. }); });
+}
+
+// Largest difference between the fields differentiated together by `BatchDifferentiation` and one by one
+template <class Grid>
+double batch_error(const Grid& grid, const std::size_t& fields)
+{
+	const std::size_t n{ grid.end() };
+	std::vector<double> samples(fields * n), out(fields * n), single(n), parallel(fields * n);
+	for (std::size_t f{0}; f < fields; f++)
+		for (std::size_t i{0}; i < n; i++)
+			samples[f * n + i] = std::sin((f + 1) * grid[i]) + 0.1 * f;
+
+	const fcpc::BatchDifferentiation<double, Grid> batch(fcpc::span<const double>(samples), fields, grid);
+	batch.data(fcpc::span<double>(out));
+	batch.parallel_data(fcpc::span<double>(parallel), 3);
+	double err{0};
+	for (std::size_t f{0}; f < fields; f++)
+	{
+		fcpc::StorageDifferentiation<double, Grid>(fcpc::span<const double>(samples.data() + f * n, n), grid).data(fcpc::span<double>(single));
+		err = std::max(err, testing::max_error(single, [&](const std::size_t& i) { return out[f * n + i]; }));
+		err = std::max(err, testing::max_error(single, [&](const std::size_t& i) { return batch.at(f, i); }));
+		err = std::max(err, testing::max_error(single, [&](const std::size_t& i) { return parallel[f * n + i]; }));
+	}
+	return err;
+}
+
+// Many fields on the same grid, in one sweep
+void test_batch(void)
+{
+	const fcpc::UniformGrid<double> uniform(0., 2., 157);
+	testing::check("batch: uniform grid, equal to one field at a time", batch_error(uniform, 5), 1e-14);
+
+	// Several tiles of weights, and a partial one
+	std::vector<double> points(2 * fcpc::batch_diff_tile + 31);
+	for (std::size_t i{0}; i < points.size(); i++)
+		points[i] = std::pow(static_cast<double>(i) / points.size(), 1.5);
+	const fcpc::FromArrayGrid<double> non_uniform(points);
+	testing::check("batch: non-uniform grid, equal to one field at a time", batch_error(non_uniform, 7), 1e-13);
+
+	// Subrange: `to - from` values per field
+	const std::size_t n{ uniform.end() }, fields{ 3 }, from{ 10 }, to{ 20 };
+	std::vector<double> samples(fields * n), all(fields * n), part(fields * (to - from));
+	for (std::size_t p{0}; p < samples.size(); p++)
+		samples[p] = std::cos(0.01 * p);
+	const fcpc::BatchDifferentiation<double, fcpc::UniformGrid<double>> batch(fcpc::span<const double>(samples), fields, uniform);
+	batch.data(fcpc::span<double>(all));
+	batch.at_range(from, to, fcpc::span<double>(part));
+	testing::check("batch: at_range() layout", testing::max_error(part, [&](const std::size_t& p)
+	{
+		return all[(p / (to - from)) * n + from + p % (to - from)];
+	}), 0.);
+
+	testing::check_throws<std::invalid_argument>("batch: samples not matching the fields throw", [&]()
+	{
+		fcpc::BatchDifferentiation<double, fcpc::UniformGrid<double>>(fcpc::span<const double>(samples.data(), fields * n - 1), fields, uniform);
+	});
+	testing::check_throws<std::out_of_range>("batch: at() of a missing field throws", [&]() { batch.at(fields, 0); });
+}
+
+int main(void)
+{
+	test_storage();
+	test_parallel();
+	test_fornberg();
+	test_non_uniform();
+	test_batch();
+
+	return testing::report();
+}
@@ -0,0 +1,108 @@
+/*
+ * expression.cpp -- Fused expressions of fields and derivatives against their terms evaluated separately
+ *
+ * Every operator on plain fields, linear and nonlinear combinations of derivatives, and one-sided
+ * derivatives, built outside of the library namespace so that the operators are found by
+ * argument-dependent lookup only; samples, outputs and fields of mismatched sizes.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/expression.hpp"
+
+namespace fcpc = fcp::computational;
+
+using Grid = fcpc::UniformGrid<double>;
+
+// Derivative of order `DOrder` of the samples `f`, by the stored differentiation
+template <std::size_t DOrder, std::size_t TOrder, typename Method = fcpc::central_difference>
+std::vector<double> stored(const Grid& grid, const std::vector<double>& f)
+{
+	std::vector<double> res(f.size());
+	fcpc::StorageDifferentiation<double, Grid, Method, TOrder, DOrder>(fcpc::span<const double>(f), grid).data(fcpc::span<double>(res));
+	return res;
+}
+
+void test_operators(void)
+{
+	const std::size_t n{ 1000 };
+	const Grid grid(0., 2., n);
+	std::vector<double> s(n), t(n), out(n);
+	for (std::size_t i{0}; i < n; i++)
+	{
+		s[i] = std::sin(3 * grid[i]) + grid[i] * grid[i] * grid[i];
+		t[i] = std::cos(grid[i]);
+	}
+	const auto f{ fcpc::field(grid, s) };
+	const auto g{ fcpc::field(grid, t) };
+
+	// Every operator on plain fields (the products may be contracted into fused multiply-adds)
+	fcpc::assign(fcpc::span<double>(out), f + g);
+	testing::check("expression: f + g", testing::max_error(out, [&](const std::size_t& i) { return s[i] + t[i]; }), 0);
+	fcpc::assign(fcpc::span<double>(out), f - g);
+	testing::check("expression: f - g", testing::max_error(out, [&](const std::size_t& i) { return s[i] - t[i]; }), 0);
+	fcpc::assign(fcpc::span<double>(out), f * g);
+	testing::check("expression: f * g", testing::max_error(out, [&](const std::size_t& i) { return s[i] * t[i]; }), 1e-14);
+	fcpc::assign(fcpc::span<double>(out), 2.5 * f);
+	testing::check("expression: c * f", testing::max_error(out, [&](const std::size_t& i) { return 2.5 * s[i]; }), 1e-14);
+	fcpc::assign(fcpc::span<double>(out), f * 2.5);
+	testing::check("expression: f * c", testing::max_error(out, [&](const std::size_t& i) { return 2.5 * s[i]; }), 1e-14);
+	fcpc::assign(fcpc::span<double>(out), -f);
+	testing::check("expression: -f", testing::max_error(out, [&](const std::size_t& i) { return -s[i]; }), 0);
+	fcpc::assign(fcpc::span<double>(out), f * f + 2. * f - -g + g * 3. - f);
+	testing::check("expression: every operator at once", testing::max_error(out, [&](const std::size_t& i)
+	{
+		return s[i] * s[i] + 2 * s[i] + t[i] + 3 * t[i] - s[i];
+	}), 1e-12);
+
+	// Linear and nonlinear combinations of derivatives
+	const std::vector<double> d1{ stored<1, 4>(grid, s) }, d2{ stored<2, 4>(grid, s) }, g2{ stored<2, 4>(grid, t) };
+	fcpc::assign(fcpc::span<double>(out), 0.5 * fcpc::derivative<2, 4>(f) - 2. * fcpc::derivative<1, 4>(f) + 3. * f);
+	testing::check("expression: linear combination of derivatives", testing::max_error(out, [&](const std::size_t& i)
+	{
+		return 0.5 * d2[i] - 2 * d1[i] + 3 * s[i];
+	}), 1e-9);
+	fcpc::assign(fcpc::span<double>(out), f * fcpc::derivative<1, 4>(f) - g * 2. + -fcpc::derivative<2, 4>(g));
+	testing::check("expression: product of a field and a derivative", testing::max_error(out, [&](const std::size_t& i)
+	{
+		return s[i] * d1[i] - 2 * t[i] - g2[i];
+	}), 1e-9);
+
+	const std::vector<double> fd{ stored<1, 2, fcpc::forward_difference>(grid, s) }, bd{ stored<1, 2, fcpc::backward_difference>(grid, s) };
+	fcpc::assign(fcpc::span<double>(out), fcpc::derivative<1, 2, fcpc::forward_difference>(f) - fcpc::derivative<1, 2, fcpc::backward_difference>(f));
+	testing::check("expression: one-sided derivatives", testing::max_error(out, [&](const std::size_t& i) { return fd[i] - bd[i]; }), 1e-10);
+}
+
+void test_errors(void)
+{
+	const Grid grid(0., 1., 100);
+	std::vector<double> s(100), small(99), out(5);
+	const auto f{ fcpc::field(grid, s) };
+	testing::check_throws<std::invalid_argument>("expression: samples not matching the grid throw", [&]() { fcpc::field(grid, small); });
+	testing::check_throws<std::invalid_argument>("expression: output of a wrong size throws", [&]() { fcpc::assign(fcpc::span<double>(out), f + f); });
+
+	const Grid other(0., 1., 99);
+	const auto h{ fcpc::field(other, small) };
+	testing::check_throws<std::invalid_argument>("expression: fields of different sizes throw", [&]() { return f + h; });
+
+	const Grid tiny(0., 1., 3);
+	std::vector<double> v(3), o(3);
+	testing::check_throws<std::domain_error>("expression: too few points for the stencil throw", [&]()
+	{
+		fcpc::assign(fcpc::span<double>(o), fcpc::derivative<1, 6>(fcpc::field(tiny, v)));
+	});
+}
+
+int main(void)
+{
+	test_operators();
+	test_errors();
+
+	return testing::report();
+}
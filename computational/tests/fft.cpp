@@ -0,0 +1,98 @@
+/*
+ * fft.cpp -- Mixed-radix FFTs against a direct DFT in extended precision
+ *
+ * Complex and real transforms of random data for sizes made of every radix alone and mixed, in double
+ * and single precision, their inverse round trips, and the sizes that can't be planned.
+ */
+
+#include <iostream>
+#include <vector>
+#include <complex>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/fft/fft.hpp"
+
+namespace fcpc = fcp::computational;
+
+// Direct DFT of `x`, in long double
+std::vector<std::complex<long double>> dft(const std::vector<std::complex<long double>>& x)
+{
+	const std::size_t n{ x.size() };
+	const long double pi{ std::acos(-1.L) };
+	std::vector<std::complex<long double>> res(n);
+	for (std::size_t k{0}; k < n; k++)
+		for (std::size_t j{0}; j < n; j++)
+		{
+			const long double a{ -2 * pi * static_cast<long double>((j * k) % n) / n };
+			res[k] += x[j] * std::complex<long double>(std::cos(a), std::sin(a));
+		}
+	return res;
+}
+
+// Complex and real transforms of `n` random points, and their round trips, relative to the magnitude of the spectrum
+template <typename T>
+void check_size(const std::size_t& n, const double& tolerance)
+{
+	const std::string name{ std::string("fft: ") + (sizeof(T) == sizeof(float) ? "float" : "double") + ", n = " + std::to_string(n) };
+	std::mt19937 rng(n);
+	std::uniform_real_distribution<T> dist(-1, 1);
+
+	std::vector<T> re(n), im(n);
+	std::vector<std::complex<long double>> x(n);
+	for (std::size_t j{0}; j < n; j++)
+	{
+		re[j] = dist(rng);
+		im[j] = dist(rng);
+		x[j] = { re[j], im[j] };
+	}
+	const auto exact{ dft(x) };
+	double scale{1};
+	for (const auto& _e : exact)
+		scale = std::max(scale, static_cast<double>(std::abs(_e)));
+
+	const fcpc::fft_plan<T> plan(n);
+	plan.forward(re.data(), im.data());
+	double err{0};
+	for (std::size_t k{0}; k < n; k++)
+		err = std::max(err, static_cast<double>(std::abs(exact[k] - std::complex<long double>(re[k], im[k]))));
+	plan.inverse(re.data(), im.data());
+	double round_trip{0};
+	for (std::size_t j{0}; j < n; j++)
+		round_trip = std::max(round_trip, static_cast<double>(std::abs(x[j] - std::complex<long double>(re[j], im[j]))));
+	testing::check(name + ", complex", err / scale, tolerance);
+	testing::check(name + ", complex round trip", round_trip, tolerance);
+
+	// Real input: the first bins of the spectrum of the real parts
+	const fcpc::real_fft_plan<T> real(n);
+	std::vector<T> xr(n), back(n), rr(real.bins()), ri(real.bins());
+	std::vector<std::complex<long double>> xc(n);
+	for (std::size_t j{0}; j < n; j++)
+		xc[j] = xr[j] = dist(rng);
+	const auto exact_real{ dft(xc) };
+	real.forward(xr.data(), rr.data(), ri.data());
+	err = 0;
+	for (std::size_t k{0}; k < real.bins(); k++)
+		err = std::max(err, static_cast<double>(std::abs(exact_real[k] - std::complex<long double>(rr[k], ri[k]))));
+	real.inverse(rr.data(), ri.data(), back.data());
+	testing::check(name + ", real", err / scale, tolerance);
+	testing::check(name + ", real round trip", testing::max_error(back, [&](const std::size_t& j) { return xr[j]; }), tolerance);
+}
+
+int main(void)
+{
+	// Every radix alone and mixed, odd and even real sizes
+	for (const std::size_t n : { 1, 2, 3, 4, 5, 6, 8, 9, 12, 15, 16, 25, 30, 60, 64, 100, 120, 243, 625, 1000, 1024 })
+		check_size<double>(n, 1e-14);
+	for (const std::size_t n : { 1, 3, 12, 64, 1000, 1024 })
+		check_size<float>(n, 1e-5);
+
+	testing::check_throws<std::invalid_argument>("fft: size with a prime factor 7 throws", []() { fcpc::fft_plan<double>(14); });
+	testing::check_throws<std::invalid_argument>("fft: zero size throws", []() { fcpc::real_fft_plan<double>(0); });
+
+	return testing::report();
+}
@@ -0,0 +1,112 @@
+/*
+ * grid.cpp -- Computed and stored grid points, and their ranges with the standard algorithms
+ *
+ * The points of StoredUniformGrid bit for bit equal to the ones of UniformGrid, the bounds checks of
+ * both, the ranges of points of every grid with the standard algorithms, and the checks of the points
+ * given to FromArrayGrid.
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/diff.hpp"
+
+namespace fcpc = fcp::computational;
+
+struct Sine
+{
+	double operator()(const double& x) const { return std::sin(x); }
+};
+
+void test_uniform(void)
+{
+	const std::size_t n{ 1000 };
+	const fcpc::UniformGrid<double> grid(-1., 3., n);
+	const fcpc::StoredUniformGrid<double> stored(-1., 3., n), copied(grid);
+
+	// The stored points are bitwise the computed ones
+	bool equal{ stored.end() - stored.begin() == n and copied.end() - copied.begin() == n };
+	for (std::size_t i{0}; i < n; i++)
+		equal = equal and grid[i] == stored[i] and copied.at(i) == stored[i];
+	testing::check("grid: stored points equal to the computed ones", equal);
+	testing::check("grid: stored points aligned", reinterpret_cast<std::uintptr_t>(stored.span().data()) % 64 == 0 and stored.span().size() == n);
+
+	const std::vector<double> range{ grid.at_range(3, 6) }, stored_range{ stored.at_range(3, 6) };
+	testing::check("grid: at_range", range.size() == 3 and range == stored_range and range[0] == grid[3]);
+	testing::check_throws<std::out_of_range>("grid: at() past the grid throws", [&]() { grid.at(n); });
+	testing::check_throws<std::out_of_range>("grid: at_range() past the grid throws", [&]() { grid.at_range(5, n + 1); });
+	testing::check_throws<std::out_of_range>("grid: stored at() past the grid throws", [&]() { stored.at(n); });
+	testing::check_throws<std::out_of_range>("grid: stored at_range() past the grid throws", [&]() { stored.at_range(7, 6); });
+
+	// Differentiation over either grid
+	const fcpc::Differentiate<double, Sine, fcpc::UniformGrid<double>> d1(grid);
+	const fcpc::Differentiate<double, Sine, fcpc::StoredUniformGrid<double>> d2(stored);
+	const std::vector<double> r1{ d1.data() }, r2{ d2.data() };
+	testing::check("grid: differentiation over the stored points", testing::max_error(r2, [&](const std::size_t& i) { return r1[i]; }), 0);
+	// Up to the contraction of the stencil into fused multiply-adds, which may differ between the two instantiations
+	testing::check("grid: differentiation at a point", std::abs(d1.at(3) - d2.at(3)), 1e-13);
+}
+
+// Ranges of points with the standard algorithms
+template <class Grid>
+void check_points(const std::string& name, const Grid& grid)
+{
+	const auto points{ grid.points() };
+	const std::size_t n{ grid.end() - grid.begin() };
+	bool equal{ points.size() == n and static_cast<std::size_t>(std::distance(points.begin(), points.end())) == n };
+	for (std::size_t i{0}; i < n; i++)
+		equal = equal and points.begin()[i] == grid[i];
+	testing::check("grid: " + name + " points", equal);
+
+	double sum{0};
+	for (std::size_t i{0}; i < n; i++)
+		sum += grid[i];
+	testing::check("grid: " + name + " points, accumulate", std::abs(std::accumulate(points.begin(), points.end(), 0.) - sum), 1e-9);
+
+	std::vector<double> doubled(n);
+	std::transform(points.begin(), points.end(), doubled.begin(), [](const double& x) { return 2 * x; });
+	testing::check("grid: " + name + " points, transform", testing::max_error(doubled, [&](const std::size_t& i) { return 2 * grid[i]; }), 0);
+
+	const auto first{ std::lower_bound(points.begin(), points.end(), grid[n / 3]) };
+	testing::check("grid: " + name + " points, sorted and searched", std::is_sorted(points.begin(), points.end()) and first - points.begin() == static_cast<std::ptrdiff_t>(n / 3));
+}
+
+void test_points(void)
+{
+	std::vector<double> custom(150);
+	for (std::size_t i{0}; i < custom.size(); i++)
+		custom[i] = std::pow(i / 149., 1.3);
+	const fcpc::FromArrayGrid<double> from_array(custom);
+	testing::check("grid: from array span", from_array.span().size() == custom.size() and from_array.span()[7] == custom[7]);
+
+	check_points("uniform", fcpc::UniformGrid<double>(-1., 3., 1000));
+	check_points("stored", fcpc::StoredUniformGrid<double>(-1., 3., 1000));
+	check_points("from array", from_array);
+	check_points("single point", fcpc::UniformGrid<double>(2., 3., 1));
+
+	testing::check_throws<std::invalid_argument>("grid: from array, points not increasing throw", []()
+	{
+		fcpc::FromArrayGrid<double>(std::vector<double>{ 0., 1., 1. });
+	});
+	testing::check_throws<std::invalid_argument>("grid: from array, a single point throws", []()
+	{
+		fcpc::FromArrayGrid<double>(std::vector<double>{ 0. });
+	});
+}
+
+int main(void)
+{
+	test_uniform();
+	test_points();
+
+	return testing::report();
+}
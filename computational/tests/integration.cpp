@@ -0,0 +1,76 @@
+/*
+ * integration.cpp -- Running integrals against a serial sum of the rules
+ *
+ * Rectangular and trapezoidal rules over random samples from a single one to a few hundred thousand,
+ * exact on the polynomials they integrate exactly, in place, and for empty input.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/integration/include/int.hpp"
+
+namespace fcpc = fcp::computational;
+
+// Running integral of `f` summed interval by interval
+template <fcpc::int_method Method>
+std::vector<double> reference(const std::vector<double>& f, const double& h)
+{
+	std::vector<double> res(f.size());
+	for (std::size_t i{1}; i < f.size(); i++)
+		res[i] = res[i - 1] + (Method == fcpc::int_method::RECTANGULAR ? h * f[i - 1] : h / 2 * (f[i - 1] + f[i]));
+	return res;
+}
+
+template <fcpc::int_method Method>
+void check_random(const std::string& name, const std::size_t& n)
+{
+	std::mt19937 rng(n);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<double> f(n), out(n);
+	for (auto& _x : f)
+		_x = dist(rng);
+	const double h{ 1e-3 };
+	const auto exact{ reference<Method>(f, h) };
+
+	fcpc::cumulative_integral<Method>(f.data(), n, h, out.data());
+	// The scan sums in a different order than the reference, the error grows with the number of terms
+	const double tolerance{ 1e-15 * n };
+	testing::check(name + ", n = " + std::to_string(n), testing::max_error(out, [&](const std::size_t& i) { return exact[i]; }), tolerance);
+	fcpc::cumulative_integral<Method>(f.data(), n, h, f.data());
+	testing::check(name + ", n = " + std::to_string(n) + ", in place", testing::max_error(f, [&](const std::size_t& i) { return exact[i]; }), tolerance);
+}
+
+int main(void)
+{
+	for (const std::size_t n : { 1, 2, 3, 17, 1000, 4 * 65536 + 77 })
+	{
+		check_random<fcpc::int_method::RECTANGULAR>("rectangular", n);
+		check_random<fcpc::int_method::TRAPEZOIDAL>("trapezoidal", n);
+	}
+
+	// The trapezoidal rule is exact on lines, the rectangular one on constants
+	const std::size_t n{ 1001 };
+	const double h{ 0.01 };
+	std::vector<double> line(n), constant(n, 2.5), out(n);
+	for (std::size_t i{0}; i < n; i++)
+		line[i] = 3 * (i * h) - 1;
+	fcpc::cumulative_integral<fcpc::int_method::TRAPEZOIDAL>(line.data(), n, h, out.data());
+	testing::check("trapezoidal: exact on a line", testing::max_error(out, [&](const std::size_t& i) { const double x{ i * h }; return 1.5 * x * x - x; }), 1e-12);
+	fcpc::cumulative_integral<fcpc::int_method::RECTANGULAR>(constant.data(), n, h, out.data());
+	testing::check("rectangular: exact on a constant", testing::max_error(out, [&](const std::size_t& i) { return 2.5 * (i * h); }), 1e-12);
+
+	// Nothing is written for no samples, and one sample integrates to zero
+	double sample{ 7 }, result{ 42 };
+	fcpc::cumulative_integral(&sample, 0, h, &result);
+	testing::check("empty input leaves the output untouched", 42 == result);
+	fcpc::cumulative_integral(&sample, 1, h, &result);
+	testing::check("single sample integrates to zero", 0 == result);
+
+	return testing::report();
+}
@@ -0,0 +1,152 @@
+/*
+ * mat4.cpp -- 4x4 Matrix operations through the SIMD kernels against the scalar products
+ *
+ * Products, matrix-vector products, batch transforms of vectors and points, transposes and inverses
+ * of random matrices in both orderings, in double and single precision. The row-major results must
+ * also be the ones of the kernels of algo_ds/simd/mat4.hpp on the transposed storage, bit for bit.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/math_types/matrix.hpp"
+
+namespace fcpc = fcp::computational;
+namespace simd = fcp::algods::simd;
+
+template <typename T, typename Ordering>
+fcpc::mat4x4<T, Ordering> random_matrix(std::mt19937& rng)
+{
+	std::uniform_real_distribution<T> dist(-1, 1);
+	fcpc::mat4x4<T, Ordering> m;
+	for (std::size_t i{0}; i < 4; i++)
+		for (std::size_t j{0}; j < 4; j++)
+			m(i, j) = dist(rng) + (i == j ? 4 : 0);
+	return m;
+}
+
+// Largest difference between two matrices, element by element
+template <typename T, typename O1, typename O2>
+double difference(const fcpc::mat4x4<T, O1>& a, const fcpc::mat4x4<T, O2>& b)
+{
+	double err{0};
+	for (std::size_t i{0}; i < 4; i++)
+		for (std::size_t j{0}; j < 4; j++)
+			err = std::max(err, static_cast<double>(std::abs(a(i, j) - b(i, j))));
+	return err;
+}
+
+template <typename T, typename Ordering>
+void check_ordering(const std::string& name, const double& tolerance)
+{
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<T> dist(-1, 1);
+	const auto a{ random_matrix<T, Ordering>(rng) }, b{ random_matrix<T, Ordering>(rng) };
+
+	// Scalar references
+	fcpc::mat4x4<T, Ordering> ab;
+	for (std::size_t i{0}; i < 4; i++)
+		for (std::size_t j{0}; j < 4; j++)
+			for (std::size_t k{0}; k < 4; k++)
+				ab(i, j) += a(i, k) * b(k, j);
+	auto apply = [&](const fcpc::Vec4<T>& v)
+	{
+		fcpc::Vec4<T> res;
+		for (std::size_t i{0}; i < 4; i++)
+		{
+			res[i] = T{0};
+			for (std::size_t j{0}; j < 4; j++)
+				res[i] += a(i, j) * v[j];
+		}
+		return res;
+	};
+
+	const auto product{ a * b };
+	testing::check(name + ": product", difference(product, ab), tolerance);
+	bool transposed{true};
+	const auto at{ fcpc::transpose(a) };
+	for (std::size_t i{0}; i < 4; i++)
+		for (std::size_t j{0}; j < 4; j++)
+			transposed = transposed and at(i, j) == a(j, i);
+	testing::check(name + ": transpose", transposed);
+	testing::check(name + ": inverse", difference(a * fcpc::inverse(a), fcpc::mat4x4<T, Ordering>::identity()), tolerance);
+
+	// The row-major storage is the transpose: the product is the kernel's B^T A^T on the same arrays
+	if constexpr (std::is_same_v<Ordering, fcpc::row_major>)
+	{
+		T expected[16];
+		simd::mat4_mul(simd::native{}, b.data(), a.data(), expected);
+		testing::check(name + ": product is the one of the SIMD kernel", 0 == std::memcmp(expected, product.data(), sizeof(expected)));
+	}
+
+	// Vectors, one by one and in batch, with a remainder for every register width
+	const std::size_t n{ 37 };
+	std::vector<fcpc::Vec4<T>> in(n), out(n);
+	for (auto& _v : in)
+		for (std::size_t k{0}; k < 4; k++)
+			_v[k] = dist(rng);
+	double err{0};
+	for (const auto& _v : in)
+	{
+		const auto _r{ a * _v }, _e{ apply(_v) };
+		for (std::size_t k{0}; k < 4; k++)
+			err = std::max(err, static_cast<double>(std::abs(_r[k] - _e[k])));
+	}
+	testing::check(name + ": matrix-vector product", err, tolerance);
+	fcpc::transform(a, in.data(), out.data(), n);
+	err = 0;
+	for (std::size_t i{0}; i < n; i++)
+	{
+		const auto _e{ apply(in[i]) };
+		for (std::size_t k{0}; k < 4; k++)
+			err = std::max(err, static_cast<double>(std::abs(out[i][k] - _e[k])));
+	}
+	testing::check(name + ": transform", err, tolerance);
+	// The row-major storage of the transpose is the column-major one of the matrix
+	if constexpr (std::is_same_v<Ordering, fcpc::row_major>)
+	{
+		std::vector<fcpc::Vec4<T>> expected(n);
+		simd::mat4_transform(simd::native{}, at.data(), in[0].data(), expected[0].data(), n);
+		testing::check(name + ": transform is the one of the SIMD kernel", 0 == std::memcmp(expected.data(), out.data(), n * sizeof(expected[0])));
+	}
+	fcpc::transform(a, static_cast<const fcpc::Vec4<T>*>(nullptr), static_cast<fcpc::Vec4<T>*>(nullptr), 0);
+	testing::check(name + ": transform of no vectors", true);
+
+	// Points as one array per component, w = 1
+	std::vector<T> x(n), y(n), z(n), px(n), py(n), pz(n);
+	for (std::size_t i{0}; i < n; i++)
+	{
+		x[i] = in[i][0];
+		y[i] = in[i][1];
+		z[i] = in[i][2];
+	}
+	fcpc::transform_points(a, simd::soa_vec3<const T>{ x.data(), y.data(), z.data() }, simd::soa_vec3<T>{ px.data(), py.data(), pz.data() }, n);
+	err = 0;
+	for (std::size_t i{0}; i < n; i++)
+	{
+		const auto _e{ apply(fcpc::Vec4<T>(x[i], y[i], z[i], T{1})) };
+		err = std::max({ err, static_cast<double>(std::abs(px[i] - _e[0])), static_cast<double>(std::abs(py[i] - _e[1])),
+										 static_cast<double>(std::abs(pz[i] - _e[2])) });
+	}
+	testing::check(name + ": transform_points", err, tolerance);
+}
+
+int main(void)
+{
+	check_ordering<double, fcpc::column_major>("double, column-major", 1e-14);
+	check_ordering<double, fcpc::row_major>("double, row-major", 1e-14);
+	check_ordering<float, fcpc::column_major>("float, column-major", 1e-5);
+	check_ordering<float, fcpc::row_major>("float, row-major", 1e-5);
+
+	fcpc::mat4x4<double> singular;
+	testing::check_throws<std::domain_error>("inverse of a singular matrix throws", [&]() { fcpc::inverse(singular); });
+
+	return testing::report();
+}
@@ -0,0 +1,121 @@
+/*
+ * matrix.cpp -- Banded differentiation matrices against the stencils applied directly and against dense products
+ *
+ * The product by the matrix of each method and order equal to the stencils of StorageDifferentiation
+ * on uniform and graded grids, the product by the transpose equal to the dense one, and a rectangular
+ * matrix assembled by hand with its bounds and size checks.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/matrix.hpp"
+
+namespace fcpc = fcp::computational;
+
+// Largest difference between `A^T x` and the product by the dense transpose, for a random `x`
+double transpose_error(const fcpc::BandedMatrix<double>& a)
+{
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<double> x(a.rows()), y(a.cols());
+	for (auto& v : x)
+		v = dist(rng);
+	a.transpose_multiply(x, y);
+	return testing::max_error(y, [&](const std::size_t& j)
+	{
+		double res{0};
+		for (std::size_t i{0}; i < a.rows(); i++)
+			res += a(i, j) * x[i];
+		return res;
+	});
+}
+
+// The product by the matrix of a method and orders equal to the stored differentiation of the same samples
+template <typename Method, std::size_t DOrder, std::size_t TOrder, class Grid>
+void check_matrix(const std::string& name, const Grid& grid)
+{
+	const std::size_t n{ grid.end() - grid.begin() };
+	std::vector<double> f(n), y(n), ref(n);
+	for (std::size_t i{0}; i < n; i++)
+		f[i] = std::sin(3 * grid[i]) + grid[i] * grid[i];
+	const fcpc::BandedMatrix<double> a{ fcpc::differentiation_matrix<double, Method, DOrder, TOrder>(grid) };
+	a.multiply(f, y);
+	fcpc::StorageDifferentiation<double, Grid, Method, TOrder, DOrder>(fcpc::span<const double>(f), grid).data(fcpc::span<double>(ref));
+	testing::check("matrix: " + name + ", A f equal to the stencils", testing::max_error(y, [&](const std::size_t& i) { return ref[i]; }), 1e-8);
+	testing::check("matrix: " + name + ", A^T x equal to the dense transpose", transpose_error(a), 1e-8);
+}
+
+void test_differentiation(void)
+{
+	const fcpc::UniformGrid<double> grid(0., 2., 200);
+	std::vector<double> points(150);
+	for (std::size_t i{0}; i < points.size(); i++)
+		points[i] = 2 * std::pow(i / 149., 1.3);
+	const fcpc::FromArrayGrid<double> graded(points);
+
+	check_matrix<fcpc::central_difference, 1, 2>("uniform, central, first derivative", grid);
+	check_matrix<fcpc::central_difference, 2, 6>("uniform, central, second derivative", grid);
+	check_matrix<fcpc::forward_difference, 1, 3>("uniform, forward", grid);
+	check_matrix<fcpc::backward_difference, 2, 2>("uniform, backward", grid);
+	check_matrix<fcpc::central_difference, 1, 4>("non-uniform, central, first derivative", graded);
+	check_matrix<fcpc::central_difference, 2, 2>("non-uniform, central, second derivative", graded);
+	check_matrix<fcpc::backward_difference, 1, 3>("non-uniform, backward", graded);
+
+	testing::check_throws<std::domain_error>("matrix: too few points throw", []()
+	{
+		fcpc::differentiation_matrix<double, fcpc::central_difference, 1, 6>(fcpc::UniformGrid<double>(0., 1., 3));
+	});
+}
+
+// A rectangular matrix assembled by hand
+void test_banded(void)
+{
+	// 4 x 6, band of 2 columns: row i holds (i + 1, 10 (i + 1)) from the column start[i], the last row ending at the last column
+	const std::vector<std::size_t> start{ 0, 1, 3, 4 };
+	const std::vector<double, fcp::algods::aligned_allocator<double>> values{ 1, 2, 3, 4, 10, 20, 30, 40 };
+	const fcpc::BandedMatrix<double> a(4, 6, 2, start, values);
+	const double dense[4][6]{ { 1, 10, 0, 0, 0, 0 }, { 0, 2, 20, 0, 0, 0 }, { 0, 0, 0, 3, 30, 0 }, { 0, 0, 0, 0, 4, 40 } };
+	bool equal{ true };
+	for (std::size_t i{0}; i < 4; i++)
+		for (std::size_t j{0}; j < 6; j++)
+			equal = equal and a.at(i, j) == dense[i][j];
+	testing::check("banded: elements", equal and a.rows() == 4 and a.cols() == 6 and a.width() == 2);
+
+	const std::vector<double> x{ 1, -1, 2, 0.5, -2, 3 };
+	std::vector<double> y(4);
+	a.multiply(x, y);
+	testing::check("banded: product", testing::max_error(y, [&](const std::size_t& i)
+	{
+		double res{0};
+		for (std::size_t j{0}; j < 6; j++)
+			res += dense[i][j] * x[j];
+		return res;
+	}), 0);
+	testing::check("banded: product by the transpose", transpose_error(a), 0);
+
+	testing::check_throws<std::out_of_range>("banded: at() out of the matrix throws", [&]() { a.at(4, 0); });
+	testing::check_throws<std::invalid_argument>("banded: vectors not matching the matrix throw", [&]() { a.multiply(y, y); });
+	testing::check_throws<std::invalid_argument>("banded: band arrays not matching throw", [&]()
+	{
+		fcpc::BandedMatrix<double>(4, 6, 3, start, values);
+	});
+	testing::check_throws<std::invalid_argument>("banded: band past the last column throws", [&]()
+	{
+		fcpc::BandedMatrix<double>(4, 5, 2, start, values);
+	});
+}
+
+int main(void)
+{
+	test_differentiation();
+	test_banded();
+
+	return testing::report();
+}
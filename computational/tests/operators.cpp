@@ -0,0 +1,130 @@
+/*
+ * operators.cpp -- Differential operators on structured grids against the exact ones
+ *
+ * The second-order stencils (one-sided ones included) are exact on quadratic fields, and the ones of
+ * the second derivative on cubic fields, so gradient, laplacian, divergence and curl are compared with
+ * the exact values up to rounding; other fields are compared with the one-dimensional differentiation
+ * of each line. The two-dimensional fields span several tiles, with partial ones.
+ */
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/operators.hpp"
+
+namespace fcpc = fcp::computational;
+
+// Samples of `f(x, y, z)` at the points of a three-dimensional grid, the first axis running fastest
+template <typename F>
+std::vector<double> sample(const fcpc::StructuredGrid<double, 3>& grid, const F& f)
+{
+	std::vector<double> res(grid.size());
+	for (std::size_t k{0}; k < grid.extent(2); k++)
+		for (std::size_t j{0}; j < grid.extent(1); j++)
+			for (std::size_t i{0}; i < grid.extent(0); i++)
+				res[i + grid.stride(1) * j + grid.stride(2) * k] = f(grid.axis(0)[i], grid.axis(1)[j], grid.axis(2)[k]);
+	return res;
+}
+
+void test_3d(void)
+{
+	using Grid = fcpc::StructuredGrid<double, 3>;
+	const Grid grid({ fcpc::UniformGrid<double>(-1., 1., 37), fcpc::UniformGrid<double>(0., 2., 21), fcpc::UniformGrid<double>(-0.5, 0.5, 13) });
+	const std::size_t n{ grid.size() };
+
+	const std::vector<double> f{ sample(grid, [](double x, double y, double z) { return x * x + 3 * x * y - y * z + z * z; }) };
+	std::vector<double> gx(n), gy(n), gz(n), out(n);
+	fcpc::gradient(grid, f, { gx, gy, gz });
+	const std::vector<double> ex{ sample(grid, [](double x, double y, double) { return 2 * x + 3 * y; }) };
+	const std::vector<double> ey{ sample(grid, [](double x, double, double z) { return 3 * x - z; }) };
+	const std::vector<double> ez{ sample(grid, [](double, double y, double z) { return -y + 2 * z; }) };
+	double err{ testing::max_error(gx, [&](const std::size_t& p) { return ex[p]; }) };
+	err = std::max(err, testing::max_error(gy, [&](const std::size_t& p) { return ey[p]; }));
+	err = std::max(err, testing::max_error(gz, [&](const std::size_t& p) { return ez[p]; }));
+	testing::check("operators: gradient of a quadratic, 3-D", err, 1e-12);
+
+	fcpc::laplacian(grid, f, out);
+	testing::check("operators: laplacian of a quadratic, 3-D", testing::max_error(out, [](const std::size_t&) { return 4.; }), 1e-10);
+
+	const std::vector<double> cubic{ sample(grid, [](double x, double y, double z) { return x * x * x - x * y * y + z * z * z; }) };
+	fcpc::laplacian(grid, cubic, out);
+	const std::vector<double> lap_cubic{ sample(grid, [](double x, double, double z) { return 4 * x + 6 * z; }) };
+	testing::check("operators: laplacian of a cubic, 3-D", testing::max_error(out, [&](const std::size_t& p) { return lap_cubic[p]; }), 1e-9);
+
+	const std::vector<double> vx{ sample(grid, [](double x, double y, double) { return x * y; }) };
+	const std::vector<double> vy{ sample(grid, [](double, double y, double z) { return y * z; }) };
+	const std::vector<double> vz{ sample(grid, [](double x, double, double z) { return z * x; }) };
+	fcpc::divergence(grid, { vx, vy, vz }, out);
+	const std::vector<double> div{ sample(grid, [](double x, double y, double z) { return x + y + z; }) };
+	testing::check("operators: divergence, 3-D", testing::max_error(out, [&](const std::size_t& p) { return div[p]; }), 1e-12);
+
+	fcpc::curl(grid, { vx, vy, vz }, { gx, gy, gz });
+	const std::vector<double> cx{ sample(grid, [](double, double y, double) { return -y; }) };
+	const std::vector<double> cy{ sample(grid, [](double, double, double z) { return -z; }) };
+	const std::vector<double> cz{ sample(grid, [](double x, double, double) { return -x; }) };
+	err = testing::max_error(gx, [&](const std::size_t& p) { return cx[p]; });
+	err = std::max(err, testing::max_error(gy, [&](const std::size_t& p) { return cy[p]; }));
+	err = std::max(err, testing::max_error(gz, [&](const std::size_t& p) { return cz[p]; }));
+	testing::check("operators: curl, 3-D", err, 1e-12);
+
+	// Partial derivative along the last axis: the one-dimensional differentiation of every line along it
+	const std::vector<double> s{ sample(grid, [](double x, double y, double z) { return std::sin(3 * z + x) * std::cos(y); }) };
+	fcpc::partial<2, 2, 4>(grid, s, out);
+	const std::size_t nz{ grid.extent(2) }, stride{ grid.stride(2) };
+	std::vector<double> line(nz), d_line(nz);
+	err = 0;
+	for (std::size_t p{0}; p < stride; p++)
+	{
+		for (std::size_t k{0}; k < nz; k++)
+			line[k] = s[p + k * stride];
+		fcpc::StorageDifferentiation<double, fcpc::UniformGrid<double>, fcpc::central_difference, 4, 2>(fcpc::span<const double>(line), grid.axis(2))
+			.data(fcpc::span<double>(d_line));
+		for (std::size_t k{0}; k < nz; k++)
+			err = std::max(err, std::abs(out[p + k * stride] - d_line[k]));
+	}
+	testing::check("operators: partial equal to 1-D differentiation of lines", err, 1e-9);
+
+	testing::check_throws<std::invalid_argument>("operators: field not matching the grid throws", [&]()
+	{
+		fcpc::laplacian(grid, fcpc::span<const double>(f.data(), n - 1), out);
+	});
+}
+
+// Several tiles along the first two axes, with partial ones
+void test_2d_tiles(void)
+{
+	using Grid = fcpc::StructuredGrid<double, 2>;
+	const std::size_t nx{ fcpc::nd_tile_width + 77 }, ny{ 2 * fcpc::nd_tile_height + 5 };
+	const Grid grid({ fcpc::UniformGrid<double>(0., 1., nx), fcpc::UniformGrid<double>(-1., 1., ny) });
+	std::vector<double> vx(grid.size()), vy(grid.size()), out(grid.size()), exact(grid.size());
+	for (std::size_t j{0}; j < ny; j++)
+		for (std::size_t i{0}; i < nx; i++)
+		{
+			const double x{ grid.axis(0)[i] }, y{ grid.axis(1)[j] };
+			vx[i + nx * j] = x * y;
+			vy[i + nx * j] = x * x;
+			exact[i + nx * j] = x;
+		}
+	fcpc::curl(grid, { vx, vy }, out);
+	testing::check("operators: curl across tiles, 2-D", testing::max_error(out, [&](const std::size_t& p) { return exact[p]; }), 1e-11);
+	fcpc::divergence(grid, { vx, vy }, out);
+	testing::check("operators: divergence across tiles, 2-D", testing::max_error(out, [&](const std::size_t& p) { return grid.axis(1)[p / nx]; }), 1e-11);
+
+	const Grid narrow({ fcpc::UniformGrid<double>(0., 1., 16), fcpc::UniformGrid<double>(0., 1., 2) });
+	std::vector<double> small(narrow.size()), small_out(narrow.size());
+	testing::check_throws<std::domain_error>("operators: too few points along an axis throw", [&]() { fcpc::laplacian(narrow, small, small_out); });
+}
+
+int main(void)
+{
+	test_3d();
+	test_2d_tiles();
+
+	return testing::report();
+}
@@ -0,0 +1,120 @@
+/*
+ * richardson.cpp -- Adaptive Richardson extrapolation against the exact derivatives
+ *
+ * Accuracy and error estimates of every method for the first two derivatives, at zero and away from
+ * it, in single precision and through a capturing lambda; the number of evaluations, shared by the
+ * levels of the tableau, and the checks of the step, tolerance and number of levels.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/richardson.hpp"
+
+namespace fcpc = fcp::computational;
+
+// exp(x) sin(3x) and its first two derivatives
+struct Function
+{
+	double operator()(const double& x) const { return std::exp(x) * std::sin(3 * x); }
+};
+
+struct FunctionFloat
+{
+	float operator()(const float& x) const { return std::exp(x) * std::sin(3 * x); }
+};
+
+double function_d1(const double& x) { return std::exp(x) * (std::sin(3 * x) + 3 * std::cos(3 * x)); }
+double function_d2(const double& x) { return std::exp(x) * (-8 * std::sin(3 * x) + 6 * std::cos(3 * x)); }
+
+// Counts its calls in a counter shared by its copies
+struct Counting
+{
+	std::size_t* calls;
+
+	double operator()(const double& x) const
+	{
+		++*calls;
+		return std::sin(x);
+	}
+};
+
+// The error against the exact value below the tolerance, and not underestimated by more than a factor 10
+template <typename Method, std::size_t DOrder>
+void check_estimate(const std::string& name, const double& x, const double& exact, const double& tolerance)
+{
+	const auto r{ fcpc::RichardsonDifferentiate<double, Function, Method, DOrder>(tolerance).estimate(x) };
+	const double err{ std::abs(r.value - exact) };
+	testing::check("richardson: " + name, err / std::max(1., std::abs(exact)), tolerance);
+	testing::check("richardson: " + name + ", error estimate", err <= 10 * r.error + 1e-15 and r.levels >= 2);
+}
+
+void test_accuracy(void)
+{
+	check_estimate<fcpc::central_difference, 1>("central, first derivative", 0.7, function_d1(0.7), 1e-8);
+	check_estimate<fcpc::central_difference, 1>("central, first derivative, tight", 0.7, function_d1(0.7), 1e-11);
+	check_estimate<fcpc::forward_difference, 1>("forward, first derivative", 0.7, function_d1(0.7), 1e-8);
+	check_estimate<fcpc::backward_difference, 1>("backward, first derivative", 0.7, function_d1(0.7), 1e-8);
+	check_estimate<fcpc::central_difference, 2>("central, second derivative", 0.7, function_d2(0.7), 1e-7);
+	check_estimate<fcpc::forward_difference, 2>("forward, second derivative", 0.7, function_d2(0.7), 1e-6);
+
+	// At zero the step is not scaled down with |x|
+	check_estimate<fcpc::central_difference, 1>("central, at zero", 0., function_d1(0.), 1e-8);
+	check_estimate<fcpc::central_difference, 2>("central, second derivative at zero", 0., function_d2(0.), 1e-7);
+	// Far from zero it is scaled up
+	check_estimate<fcpc::central_difference, 1>("central, at 4", 4., function_d1(4.), 1e-8);
+
+	const float f{ fcpc::RichardsonDifferentiate<float, FunctionFloat>().at(0.7f) };
+	testing::check("richardson: float", std::abs((f - function_d1(0.7)) / function_d1(0.7)), 1e-3);
+
+	// A lambda capturing state, through the constructor taking the function
+	const auto lambda = [k = 2.](const double& t) { return std::sin(k * t); };
+	const fcpc::RichardsonDifferentiate<double, decltype(lambda)> r(lambda);
+	testing::check("richardson: lambda", std::abs(r.at(1.) - 2 * std::cos(2.)), 1e-8);
+}
+
+void test_evaluations(void)
+{
+	// The samples are shared by the levels: two new points per level for the central first derivative
+	std::size_t calls{0};
+	const fcpc::RichardsonDifferentiate<double, Counting> r(Counting{ &calls }, 1e-10);
+	const auto e{ r.estimate(0.4) };
+	testing::check("richardson: evaluations counted", e.evaluations == calls);
+	testing::check("richardson: two evaluations per level", e.evaluations == 2 * e.levels);
+	testing::check("richardson: accuracy with the counted evaluations", std::abs(e.value - std::cos(0.4)), 1e-10);
+
+	// A looser tolerance stops earlier
+	calls = 0;
+	const auto loose{ fcpc::RichardsonDifferentiate<double, Counting>(Counting{ &calls }, 1e-4).estimate(0.4) };
+	testing::check("richardson: fewer evaluations for a looser tolerance", loose.evaluations < e.evaluations);
+
+	// The number of levels caps the work
+	calls = 0;
+	const auto capped{ fcpc::RichardsonDifferentiate<double, Counting>(Counting{ &calls }, 0., 0.1, 3).estimate(0.4) };
+	testing::check("richardson: levels cap", capped.levels <= 3 and calls <= 6);
+}
+
+void test_errors(void)
+{
+	testing::check_throws<std::invalid_argument>("richardson: zero step throws", []() { fcpc::RichardsonDifferentiate<double, Function>(1e-8, 0.); });
+	testing::check_throws<std::invalid_argument>("richardson: negative tolerance throws", []() { fcpc::RichardsonDifferentiate<double, Function>(-1.); });
+	testing::check_throws<std::invalid_argument>("richardson: a single level throws", []() { fcpc::RichardsonDifferentiate<double, Function>(1e-8, 0.1, 1); });
+	testing::check_throws<std::invalid_argument>("richardson: too many levels throw", []()
+	{
+		fcpc::RichardsonDifferentiate<double, Function>(1e-8, 0.1, fcpc::richardson_max_levels + 1);
+	});
+}
+
+int main(void)
+{
+	test_accuracy();
+	test_evaluations();
+	test_errors();
+
+	return testing::report();
+}
@@ -0,0 +1,93 @@
+/*
+ * spectral.cpp -- Spectral differentiation of periodic functions against the exact derivatives
+ *
+ * First and second derivatives of exp(sin x) to rounding for odd and even sizes, the sums at single
+ * points against the inverse transform, a third derivative in single precision, the bounds checks,
+ * and the single-point and unsupported sizes.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/spectral.hpp"
+
+namespace fcpc = fcp::computational;
+
+using Grid = fcpc::UniformGrid<double>;
+
+const double two_pi{ 2 * std::acos(-1.) };
+
+// exp(sin x), periodic and analytic
+struct Function
+{
+	double operator()(const double& x) const { return std::exp(std::sin(x)); }
+};
+
+struct Sine3
+{
+	float operator()(const float& x) const { return std::sin(3 * x); }
+};
+
+void test_accuracy(void)
+{
+	// Odd and even sizes: exact to rounding from a few tens of points
+	for (const std::size_t n : { 45, 48, 64, 100 })
+	{
+		const Grid grid(0., two_pi, n);
+		const fcpc::SpectralDifferentiate<double, Function, Grid> s(grid);
+		const std::vector<double> d1{ s.data() }, d2{ s.data<2>() };
+		const std::string name{ "spectral: n = " + std::to_string(n) };
+		testing::check(name + ", first derivative", testing::max_error(d1, [&](const std::size_t& i)
+		{
+			return std::cos(grid[i]) * std::exp(std::sin(grid[i]));
+		}), 1e-12);
+		testing::check(name + ", second derivative", testing::max_error(d2, [&](const std::size_t& i)
+		{
+			const double c{ std::cos(grid[i]) }, sn{ std::sin(grid[i]) };
+			return (c * c - sn) * std::exp(sn);
+		}), 1e-11);
+
+		// The sums at single points equal the inverse transform
+		double err{0};
+		for (std::size_t i{0}; i < n; i++)
+			err = std::max(err, std::abs(s[i] - d1[i]) + std::abs(s.at<2>(i) - d2[i]));
+		testing::check(name + ", single points equal to data()", err, 1e-11);
+		testing::check(name + ", period", std::abs(s.period() - two_pi), 1e-14);
+	}
+
+	// Third derivative, in single precision
+	const fcpc::UniformGrid<float> grid(0.f, static_cast<float>(two_pi), 24);
+	const fcpc::SpectralDifferentiate<float, Sine3, fcpc::UniformGrid<float>, 3> s(grid);
+	const std::vector<float> d3{ s.data() };
+	testing::check("spectral: float, third derivative", testing::max_error(d3, [&](const std::size_t& i) { return -27 * std::cos(3 * grid[i]); }), 1e-3);
+	const std::vector<float> range{ s.at_range(3, 7) };
+	testing::check("spectral: at_range equal to data()", range.size() == 4 and testing::max_error(range, [&](const std::size_t& i) { return d3[3 + i]; }) == 0);
+	testing::check_throws<std::out_of_range>("spectral: at() past the grid throws", [&]() { s.at(24); });
+	testing::check_throws<std::out_of_range>("spectral: at_range() past the grid throws", [&]() { s.at_range(5, 25); });
+}
+
+void test_sizes(void)
+{
+	// A single point: the derivative of a constant
+	const Grid one(0., 1., 1);
+	const fcpc::SpectralDifferentiate<double, Function, Grid> s(one);
+	testing::check("spectral: single point", std::abs(s.data()[0]) + std::abs(s[0]), 0);
+
+	testing::check_throws<std::invalid_argument>("spectral: size with a prime factor 7 throws", []()
+	{
+		fcpc::SpectralDifferentiate<double, Function, Grid>(Grid(0., 1., 7));
+	});
+}
+
+int main(void)
+{
+	test_accuracy();
+	test_sizes();
+
+	return testing::report();
+}
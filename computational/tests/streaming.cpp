@@ -0,0 +1,89 @@
+/*
+ * streaming.cpp -- Online differentiation of streams against the backward differences of stored samples
+ *
+ * Samples pushed one by one and in blocks of random sizes give the derivatives of the backward
+ * stencils of StorageDifferentiation, NaN until ready; resetting and the size checks.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "testing.hpp"
+
+#include "computational/differentiation/streaming.hpp"
+
+namespace fcpc = fcp::computational;
+
+// Samples of sin(x) pushed one by one and in blocks of random sizes (empty ones included), against the backward stencil
+// of StorageDifferentiation on the stored samples
+template <typename T, std::size_t DOrder, std::size_t TOrder>
+void check_stream(const std::string& name, const double& tolerance)
+{
+	using Stream = fcpc::StreamingDifferentiation<T, DOrder, TOrder>;
+	using Grid = fcpc::UniformGrid<T>;
+	const std::size_t n{ 3000 }, size{ Stream::stencil_size };
+	const T h{ T(0.01) };
+	const Grid grid(T{0}, h * n, n);
+	std::vector<T> x(n), single(n), block(n), stored(n);
+	for (std::size_t i{0}; i < n; i++)
+		x[i] = std::sin(grid[i]);
+
+	Stream a(h), b(h);
+	bool ready{ true };
+	for (std::size_t i{0}; i < n; i++)
+	{
+		single[i] = a.push(x[i]);
+		ready = ready and a.ready() == (i + 1 >= size);
+	}
+	std::mt19937 rng(7);
+	for (std::size_t i{0}; i < n; )
+	{
+		const std::size_t m{ std::min<std::size_t>(n - i, rng() % 40) };
+		b.push(fcpc::span<const T>(x.data() + i, m), fcpc::span<T>(block.data() + i, m));
+		i += m;
+	}
+	fcpc::StorageDifferentiation<T, Grid, fcpc::backward_difference, TOrder, DOrder>(fcpc::span<const T>(x), grid).data(fcpc::span<T>(stored));
+
+	bool nan{ true };
+	for (std::size_t i{0}; i + 1 < size; i++)
+		nan = nan and std::isnan(single[i]) and std::isnan(block[i]);
+	double err_stored{0}, err_block{0};
+	for (std::size_t i{size - 1}; i < n; i++)
+	{
+		err_stored = std::max(err_stored, static_cast<double>(std::abs(single[i] - stored[i])));
+		err_block = std::max(err_block, static_cast<double>(std::abs(single[i] - block[i])));
+	}
+	testing::check("streaming: " + name + ", NaN until ready", nan and ready);
+	testing::check("streaming: " + name + ", equal to stored samples", err_stored, tolerance);
+	testing::check("streaming: " + name + ", blocks equal to single pushes", err_block, tolerance);
+}
+
+int main(void)
+{
+	check_stream<double, 1, 1>("first derivative, first order", 1e-12);
+	check_stream<double, 1, 4>("first derivative, fourth order", 1e-12);
+	check_stream<double, 2, 2>("second derivative, second order", 1e-9);
+	check_stream<float, 1, 2>("float, first derivative", 1e-3);
+
+	// Forgetting the samples: NaN again, then the derivative of the new ones only
+	fcpc::StreamingDifferentiation<double, 1, 2> s(0.5);
+	for (const double v : { 10., -3., 7. })
+		s.push(v);
+	s.reset();
+	const double first{ s.push(1.) };
+	s.push(2.);
+	testing::check("streaming: reset", std::isnan(first) and not s.ready() and std::abs(s.push(3.) - 2.) < 1e-14 and s.ready());
+
+	testing::check_throws<std::invalid_argument>("streaming: zero spacing throws", []() { fcpc::StreamingDifferentiation<double>(0.); });
+	std::vector<double> in(4), out(3);
+	testing::check_throws<std::invalid_argument>("streaming: block sizes differing throw", [&]()
+	{
+		s.push(fcpc::span<const double>(in), fcpc::span<double>(out));
+	});
+
+	return testing::report();
+}
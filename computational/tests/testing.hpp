@@ -0,0 +1,77 @@
+/*
+ * testing.hpp -- Checks shared by the test programs of the computational library
+ *
+ * Every check prints its name, the error found and the tolerance it is compared with; a program
+ * exits with the number of checks that failed, after a SUCCESS or FAILURE line like the SIMD
+ * harness. The errors are absolute: the tests sample functions of unit magnitude.
+ */
+
+#ifndef FCPUT_COMPUTATIONAL_TESTS_TESTING
+#define FCPUT_COMPUTATIONAL_TESTS_TESTING
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace testing
+{
+	inline int& failures(void)
+	{
+		static int _failures{0};
+		return _failures;
+	}
+
+	/// @brief Check that `error` is within `tolerance` (a NaN error fails)
+	inline void check(const std::string& name, const double& error, const double& tolerance)
+	{
+		const bool _ok{ error <= tolerance };
+		if (not _ok) failures()++;
+		std::cout << std::left << std::setw(56) << name << std::right << std::scientific << std::setprecision(2)
+							<< std::setw(11) << error << " / " << std::setw(9) << tolerance << (_ok ? "  ok\n" : "  FAILED\n");
+	}
+
+	/// @brief Check that `condition` holds
+	inline void check(const std::string& name, const bool& condition)
+	{
+		if (not condition) failures()++;
+		std::cout << std::left << std::setw(80) << name << (condition ? "  ok\n" : "  FAILED\n");
+	}
+
+	/// @brief Check that `f()` throws an exception of type `E`
+	template <typename E, typename F>
+	void check_throws(const std::string& name, const F& f)
+	{
+		bool _thrown{false};
+		try { f(); }
+		catch (const E&) { _thrown = true; }
+		catch (...) {}
+		check(name, _thrown);
+	}
+
+	/// @brief Largest absolute difference between `values[i]` and `exact(i)`
+	template <typename V, typename F>
+	double max_error(const V& values, const F& exact)
+	{
+		double _err{0};
+		for (std::size_t i{0}; i < values.size(); i++)
+		{
+			const double _e{ std::abs(static_cast<double>(values[i]) - static_cast<double>(exact(i))) };
+			if (std::isnan(_e)) return _e;
+			_err = std::max(_err, _e);
+		}
+		return _err;
+	}
+
+	/// @brief Print the summary line and return the number of failed checks
+	inline int report(void)
+	{
+		std::cout << '\n' << (0 == failures() ? "SUCCESS" : "FAILURE") << ": " << failures() << " check(s) failed\n";
+		return failures();
+	}
+}	// namespace testing
+
+#endif	// FCPUT_COMPUTATIONAL_TESTS_TESTING
@@ -3,6 +3,8 @@
 
 #include "buffer.hpp"
 
+#include <vector>
+
 /* Element Buffer Object (EBO).
  *
  * OpenGL's buffer object used to store a number of vertex indices directly in the GPU's memory.
@@ -79,6 +81,14 @@ class EBO : public BufferObject
      */
     void setData(const size_t& size_of_data, const void* data, const GLenum& buffer_usage = GL_STATIC_DRAW);
 
+    /* Set EBO data from a vector of indices and optionally its usage.
+     */
+    template <typename T>
+    void setData(const std::vector<T>& data, const GLenum& buffer_usage = GL_STATIC_DRAW)
+    {
+      setData(data.size() * sizeof(T), data.data(), buffer_usage);
+    }
+
 };	// end of EBO class.
 
 #endif	// FCPUT_GRAPHICS_ELEMENT_BUFFER
@@ -28,9 +28,17 @@ enum TOPOLOGY
   TRIANGLE_STRIP_ADJACENCY
 };
 
+/*
+ * Mesh whose attributes are stored as 'T': 'GLfloat', 'GLdouble', or one of the 16-bit storage
+ * types 'half' and 'bfloat16' to halve the vertex data.
+ */
 template <typename T>
 class Mesh
 {
+  public:
+    // OpenGL type of the attribute components.
+    static constexpr GLenum attribute_type = gl_type_v<T>;
+
   private:
     std::vector<T> m_vertices;
     std::vector<T> m_normals;
@@ -3,6 +3,23 @@
 
 #include "buffer.hpp"
 
+#include "algo_ds/simd/half.hpp"
+
+#include <vector>
+
+/* OpenGL type of the vertex attribute components stored as 'T'.
+ *
+ * 'bfloat16' has no OpenGL counterpart: it is uploaded as GL_UNSIGNED_SHORT, to be read through
+ * glVertexAttribIPointer and decoded in the shader with 'uintBitsToFloat(v << 16)'.
+ */
+template <typename T> struct gl_type;
+template <> struct gl_type<GLfloat> { static constexpr GLenum value = GL_FLOAT; };
+template <> struct gl_type<GLdouble> { static constexpr GLenum value = GL_DOUBLE; };
+template <> struct gl_type<fcp::algods::simd::half> { static constexpr GLenum value = GL_HALF_FLOAT; };
+template <> struct gl_type<fcp::algods::simd::bfloat16> { static constexpr GLenum value = GL_UNSIGNED_SHORT; };
+
+template <typename T> constexpr GLenum gl_type_v = gl_type<T>::value;
+
 /* Vertex Array Object.
  *
  * OpenGL buffer object that stores all the required information (state) to supply vertex data. 
@@ -122,6 +139,27 @@ class VBO : public BufferObject
      */
     void setData(const size_t& size_of_data, const void* data, const GLenum& buffer_usage = GL_STATIC_DRAW);
 
+    /* Set VBO data from a vector of elements and optionally its usage.
+     */
+    template <typename T>
+    void setData(const std::vector<T>& data, const GLenum& buffer_usage = GL_STATIC_DRAW)
+    {
+      setData(data.size() * sizeof(T), data.data(), buffer_usage);
+    }
+
+    /* Set VBO data converting 'n' floats to the 16-bit storage type 'S' ('half' or 'bfloat16') first.
+     *
+     * Both the upload and the GPU memory are half the size of the float data; the attribute
+     * must then be formatted with 'gl_type_v<S>' as data type.
+     */
+    template <typename S>
+    void setDataAs(const float* data, const size_t& n, const GLenum& buffer_usage = GL_STATIC_DRAW)
+    {
+      std::vector<S> temp(n);
+      fcp::algods::simd::convert(data, temp.data(), n);
+      setData(temp, buffer_usage);
+    }
+
 		// Optional arguments for the vertex attribut format method. 
    	struct formatVertexAttribute_args{
 			GLenum data_type;